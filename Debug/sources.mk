@@ -28,6 +28,7 @@ SUBDIRS := \
 src \
 src/cs/nn \
 src/cs/math \
+src/cs/cpu \
 src/cs/gpu \
 src/cs/data \
 src/cs/core \
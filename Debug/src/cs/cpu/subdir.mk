@@ -0,0 +1,67 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/cs/cpu/broadcast.cpp \
+../src/cs/cpu/cpu.cpp \
+../src/cs/cpu/gemm.cpp \
+../src/cs/cpu/gemv.cpp \
+../src/cs/cpu/half.cpp \
+../src/cs/cpu/memory.cpp \
+../src/cs/cpu/pool.cpp \
+../src/cs/cpu/quant.cpp \
+../src/cs/cpu/reduce.cpp \
+../src/cs/cpu/sparse.cpp \
+../src/cs/cpu/threads.cpp \
+../src/cs/cpu/track.cpp \
+../src/cs/cpu/transpose.cpp \
+../src/cs/cpu/tune.cpp \
+../src/cs/cpu/vmath.cpp 
+
+OBJS += \
+./src/cs/cpu/broadcast.o \
+./src/cs/cpu/cpu.o \
+./src/cs/cpu/gemm.o \
+./src/cs/cpu/gemv.o \
+./src/cs/cpu/half.o \
+./src/cs/cpu/memory.o \
+./src/cs/cpu/pool.o \
+./src/cs/cpu/quant.o \
+./src/cs/cpu/reduce.o \
+./src/cs/cpu/sparse.o \
+./src/cs/cpu/threads.o \
+./src/cs/cpu/track.o \
+./src/cs/cpu/transpose.o \
+./src/cs/cpu/tune.o \
+./src/cs/cpu/vmath.o 
+
+CPP_DEPS += \
+./src/cs/cpu/broadcast.d \
+./src/cs/cpu/cpu.d \
+./src/cs/cpu/gemm.d \
+./src/cs/cpu/gemv.d \
+./src/cs/cpu/half.d \
+./src/cs/cpu/memory.d \
+./src/cs/cpu/pool.d \
+./src/cs/cpu/quant.d \
+./src/cs/cpu/reduce.d \
+./src/cs/cpu/sparse.d \
+./src/cs/cpu/threads.d \
+./src/cs/cpu/track.d \
+./src/cs/cpu/transpose.d \
+./src/cs/cpu/tune.d \
+./src/cs/cpu/vmath.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/cs/cpu/%.o: ../src/cs/cpu/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: NVCC Compiler'
+	/usr/local/cuda-7.5/bin/nvcc -I"/home/yaison/cuda-workspace/cs/include" -g -O0 -std=c++11 -gencode arch=compute_50,code=sm_50  -odir "src/cs/cpu" -M -o "$(@:%.o=%.d)" "$<"
+	/usr/local/cuda-7.5/bin/nvcc -I"/home/yaison/cuda-workspace/cs/include" -g -O0 -std=c++11 --compile  -x c++ -o  "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
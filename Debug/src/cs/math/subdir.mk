@@ -4,33 +4,42 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/cs/math/CpuHalfMatrix.cpp \
 ../src/cs/math/CpuMatrix.cpp \
+../src/cs/math/CpuSparseMatrix.cpp \
 ../src/cs/math/CpuVector.cpp \
 ../src/cs/math/GpuMatrix.cpp \
 ../src/cs/math/GpuVector.cpp \
 ../src/cs/math/Matrix.cpp \
 ../src/cs/math/RowView.cpp \
 ../src/cs/math/Vector.cpp \
+../src/cs/math/Workspace.cpp \
 ../src/cs/math/math.cpp 
 
 OBJS += \
+./src/cs/math/CpuHalfMatrix.o \
 ./src/cs/math/CpuMatrix.o \
+./src/cs/math/CpuSparseMatrix.o \
 ./src/cs/math/CpuVector.o \
 ./src/cs/math/GpuMatrix.o \
 ./src/cs/math/GpuVector.o \
 ./src/cs/math/Matrix.o \
 ./src/cs/math/RowView.o \
 ./src/cs/math/Vector.o \
+./src/cs/math/Workspace.o \
 ./src/cs/math/math.o 
 
 CPP_DEPS += \
+./src/cs/math/CpuHalfMatrix.d \
 ./src/cs/math/CpuMatrix.d \
+./src/cs/math/CpuSparseMatrix.d \
 ./src/cs/math/CpuVector.d \
 ./src/cs/math/GpuMatrix.d \
 ./src/cs/math/GpuVector.d \
 ./src/cs/math/Matrix.d \
 ./src/cs/math/RowView.d \
 ./src/cs/math/Vector.d \
+./src/cs/math/Workspace.d \
 ./src/cs/math/math.d 
 
 
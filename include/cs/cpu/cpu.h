@@ -0,0 +1,435 @@
+/*
+ * cpu.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_CPU_CPU_H_
+#define CS_CPU_CPU_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace cs {
+namespace cpu {
+
+//Number of threads used by the kernels (the caller included). Defaults to the
+//CS_THREADS environment variable or the number of hardware threads.
+void cpu_set_threads(size_t threads);
+size_t cpu_threads();
+
+//Alignment in bytes of the memory returned by cpu_malloc, a cache line.
+const size_t CPU_ALIGNMENT = 64;
+
+//Memory of the CPU matrices and vectors, same contract as gpu_malloc/gpu_free.
+//The memory starts at a CPU_ALIGNMENT boundary.
+float* cpu_malloc(size_t length, bool clear);
+void cpu_free(float* ptr);
+
+//The same for every element type of the matrices, length is in values of T.
+template<typename T>
+T* cpu_malloc(size_t length, bool clear);
+template<>
+float* cpu_malloc<float>(size_t length, bool clear);
+template<>
+double* cpu_malloc<double>(size_t length, bool clear);
+void cpu_free(double* ptr);
+
+//Smallest leading dimension >= n that keeps every row of floats at a CPU_ALIGNMENT boundary.
+size_t cpu_padded(size_t n);
+
+//Number of cpu_malloc calls since the program started.
+size_t cpu_allocations();
+
+//The allocator behind cpu_malloc and cpu_free. allocate returns bytes at a CPU_ALIGNMENT
+//boundary, or nullptr when there is no memory, and release gets them back with the same
+//bytes. ctx is passed to both.
+struct CpuAllocator {
+	void* (*allocate)(size_t bytes, void* ctx);
+	void (*release)(void* ptr, size_t bytes, void* ctx);
+	void* ctx;
+};
+
+//The default allocator: free lists of size classes (4 per power of two) kept by each thread,
+//so the temporaries of the operators reuse memory that is already mapped without taking a
+//lock. The buffers above CPU_POOL_MAX bytes go straight to the system. A buffer released by
+//another thread than the one that allocated it goes to the lists of the releasing thread.
+const size_t CPU_POOL_MAX = 32 << 20;
+CpuAllocator cpu_pool_allocator();
+
+//posix_memalign and free, nothing is kept.
+CpuAllocator cpu_system_allocator();
+
+//The allocator of the next cpu_malloc calls, the buffers of the previous one are still
+//released to it. It must be set while no other thread allocates, usually at the start.
+void cpu_set_allocator(CpuAllocator allocator);
+
+//Counters of the pool allocator over all the threads.
+struct CpuPoolStats {
+	//allocations from the free lists, from the system, and above CPU_POOL_MAX
+	size_t hits;
+	size_t misses;
+	size_t huge;
+	
+	//bytes in the free lists, and bytes given back to the system by the limit and the trims
+	size_t retained;
+	size_t trimmed;
+};
+
+CpuPoolStats cpu_pool_stats();
+
+//Most bytes that the free lists of a thread keep, a released buffer that does not fit goes
+//back to the system, and 0 keeps nothing. Defaults to the CS_POOL_LIMIT environment variable
+//(in MB) or 256 MB.
+void cpu_set_pool_limit(size_t bytes);
+size_t cpu_pool_limit();
+
+//Gives the free lists of the calling thread back to the system and returns their bytes. The
+//lists of a thread are also given back when it ends.
+size_t cpu_pool_trim();
+
+//Pages of the large buffers: the base pages, transparent huge pages (madvise) or huge pages
+//reserved in /proc/sys/vm/nr_hugepages, which fall back to transparent ones when there are none.
+enum CpuPages {
+	CPU_PAGES_SMALL, CPU_PAGES_TRANSPARENT, CPU_PAGES_HUGE
+};
+
+//NUMA node of the pages: the first thread that writes them, all the nodes in turn, or node.
+enum CpuPlacement {
+	CPU_PLACE_LOCAL, CPU_PLACE_INTERLEAVE, CPU_PLACE_NODE
+};
+
+//How the buffers of at least CPU_HUGE_PAGE bytes are mapped. A policy other than the default
+//{ CPU_PAGES_SMALL, CPU_PLACE_LOCAL, 0, false } maps each one on its own, outside of the
+//allocator. parallel_touch writes the pages on the threads of the kernels right away, in
+//cpu_threads() contiguous parts like the rows of the parallel kernels, instead of leaving
+//them to the first thread that fills the buffer (like Grid::toMatrix).
+struct CpuMemoryPolicy {
+	CpuPages pages;
+	CpuPlacement placement;
+	int node;
+	bool parallel_touch;
+};
+
+const size_t CPU_HUGE_PAGE = 2 << 20;
+
+//The policy of cpu_malloc, the default one until it is set.
+void cpu_set_memory_policy(CpuMemoryPolicy policy);
+CpuMemoryPolicy cpu_memory_policy();
+
+//cpu_malloc with a policy for this buffer only.
+template<typename T>
+T* cpu_malloc(size_t length, bool clear, const CpuMemoryPolicy& policy);
+template<>
+float* cpu_malloc<float>(size_t length, bool clear, const CpuMemoryPolicy& policy);
+template<>
+double* cpu_malloc<double>(size_t length, bool clear, const CpuMemoryPolicy& policy);
+
+//Number of NUMA nodes, 1 when the system does not have them.
+size_t cpu_numa_nodes();
+
+//The mapping that holds a buffer, read from /proc/self/smaps and /proc/self/numa_maps, to
+//check that a policy was applied.
+struct CpuMemoryInfo {
+	//like "default", "interleave:0-1", "bind:1" or "prefer:0"
+	char policy[64];
+	
+	//page size of the mapping, and its bytes in transparent huge pages
+	size_t page_bytes;
+	size_t huge_bytes;
+	
+	//bit k is set when node k holds pages of the mapping
+	uint64_t nodes;
+};
+
+//False when /proc can not be read or ptr is not mapped.
+bool cpu_memory_info(const void* ptr, CpuMemoryInfo& info);
+
+//What the memory of cpu_malloc holds, so the tracker can tell where it goes. The buffers
+//are temporaries unless a CpuMemoryScope of the thread says otherwise.
+enum CpuMemoryCategory {
+	CPU_MEMORY_TEMPORARIES, CPU_MEMORY_DATA, CPU_MEMORY_PARAMS, CPU_MEMORY_GRADS, CPU_MEMORY_ACTIVATIONS
+};
+
+const size_t CPU_MEMORY_CATEGORIES = 5;
+
+//The category of the cpu_malloc calls of the calling thread while it lives.
+class CpuMemoryScope {
+	
+private:
+	CpuMemoryCategory previous;
+
+public:
+	CpuMemoryScope(CpuMemoryCategory category);
+	CpuMemoryScope(const CpuMemoryScope&) = delete;
+	CpuMemoryScope& operator=(const CpuMemoryScope&) = delete;
+	~CpuMemoryScope();
+};
+
+//A cpu_malloc call of the calling thread while it lives throws, to assert that a step
+//(like the training of a batch that was seen before) does not allocate.
+class CpuNoAllocations {
+	
+public:
+	CpuNoAllocations();
+	CpuNoAllocations(const CpuNoAllocations&) = delete;
+	CpuNoAllocations& operator=(const CpuNoAllocations&) = delete;
+	~CpuNoAllocations();
+};
+
+//Bytes of a category: live now, the most that were live at once, and the allocations and
+//releases counted while tracking.
+struct CpuMemoryCounters {
+	size_t live;
+	size_t peak;
+	size_t allocations;
+	size_t releases;
+};
+
+struct CpuMemoryStats {
+	CpuMemoryCounters categories[CPU_MEMORY_CATEGORIES];
+	CpuMemoryCounters total;
+};
+
+//The tracker counts the buffers allocated while it is on, a buffer allocated before is not
+//counted when it is released. It is off unless the CS_MEMORY_TRACK environment variable is 1,
+//which also prints the counters at exit.
+void cpu_set_memory_tracking(bool enabled);
+bool cpu_memory_tracking();
+
+CpuMemoryStats cpu_memory_stats();
+
+//The peaks start again from the live bytes, like before each step of a training.
+void cpu_reset_memory_peaks();
+
+//Prints the counters, now or when the program ends.
+void cpu_print_memory();
+void cpu_print_memory_at_exit();
+
+//Counts memory that does not come from cpu_malloc, like the strings of a Grid. It returns the
+//bytes counted, 0 when the tracker is off, which are the ones to give to cpu_untrack_memory.
+size_t cpu_track_memory(CpuMemoryCategory category, size_t bytes);
+void cpu_untrack_memory(CpuMemoryCategory category, size_t bytes);
+
+//C = A x B, where A is (m x n), B is (n x p) and C is (m x p). C is overwritten.
+void cpu_dot(float* a, float* b, float* c, size_t m, size_t n, size_t p);
+
+//Same arguments as gpu_dot: A is (m x n) and B is (m x p), C = A^T x B is (n x p).
+void cpu_dot(float* a, bool transA, float* b, float* c, size_t m, size_t n, size_t p);
+
+//Same arguments as gpu_dot: A is (m x n) and B is (o x p) with p == n, C = A x B^T is (m x o).
+void cpu_dot(float* a, float* b, bool transB, float* c, size_t m, size_t n, size_t o, size_t p);
+
+//General form: C = op(A) x op(B) + beta * C, where op(A) is (m x n), op(B) is (n x p) and
+//op(X) is X or X^T. The lda, ldb and ldc are the leading dimensions (row strides) of the
+//stored matrices. When beta is 0 the previous content of C is never read.
+void cpu_gemm(float* a, size_t lda, bool transA, float* b, size_t ldb, bool transB, float* c, size_t ldc, size_t m,
+		size_t n, size_t p, float beta);
+
+//The kernels that take double have their own SIMD code, the matrices of doubles
+//(CpuDoubleMatrix) run on them.
+void cpu_gemm(double* a, size_t lda, bool transA, double* b, size_t ldb, bool transB, double* c, size_t ldc, size_t m,
+		size_t n, size_t p, double beta);
+
+//Element wise activations, of the fused products and of cpu_activation.
+enum CpuActivation {
+	CPU_IDENTITY, CPU_SIGMOID, CPU_RELU, CPU_TANH
+};
+
+//What the fused product does with C = op(A) x op(B): C = act(C + bias), where bias has
+//p values (one per column) or is nullptr. When pre is not nullptr, the (m x p) PRE with
+//leading dimension ldpre receives C + bias before the activation, for a backward that
+//needs it.
+struct CpuEpilogue {
+	float* bias;
+	CpuActivation act;
+	float* pre;
+	size_t ldpre;
+};
+
+//C = act(op(A) x op(B) + bias), same arguments as cpu_gemm with beta = 0. The epilogue is
+//applied to every tile of C right after its last panel of k is stored, while the tile is
+//still in L1, so C is written once instead of once per pass.
+void cpu_gemm_fused(float* a, size_t lda, bool transA, float* b, size_t ldb, bool transB, float* c, size_t ldc,
+		size_t m, size_t n, size_t p, const CpuEpilogue& epilogue);
+
+//Micro-kernels of the GEMM engine, CPU_GEMM_AUTO is the widest one the CPU has.
+enum CpuGemmKernel {
+	CPU_GEMM_AUTO, CPU_GEMM_GENERIC, CPU_GEMM_AVX2, CPU_GEMM_AVX512
+};
+
+//The cache blocking of the GEMM engine (see cpu_utils.h) and its micro-kernel. The sizes are
+//in floats, the products of doubles use half of kc so their panels have the same bytes.
+struct CpuGemmConfig {
+	size_t mc;
+	size_t kc;
+	size_t nc;
+	CpuGemmKernel kernel;
+};
+
+//The configuration used by the products. It must not be changed while a product runs, and a
+//kernel that the CPU does not have throws.
+CpuGemmConfig cpu_gemm_config();
+void cpu_set_gemm_config(CpuGemmConfig config);
+
+//Times the candidate blockings of every micro-kernel on (size x size) products of floats, one
+//dimension at a time, then keeps the fastest configuration and returns it. With size 512 it
+//takes about a second.
+CpuGemmConfig cpu_gemm_tune(size_t size);
+
+//The tuned configurations are kept in a text file, one line per CPU model, so a home shared by
+//several machines keeps the best one of each. The path can be nullptr, for the file named by the
+//CS_GEMM_CONFIG environment variable or else ~/.cs_gemm. cpu_gemm_save replaces the line of this
+//CPU with the current configuration. cpu_gemm_load applies the line of this CPU, and it returns
+//false when there is none.
+//
+//The first blocked product loads the default file. If that file has no line for this CPU and
+//CS_GEMM_TUNE is 1, the product first tunes and saves the result.
+void cpu_gemm_save(const char* path);
+bool cpu_gemm_load(const char* path);
+
+//Storage of the 16 bit matrices: bfloat16 (the upper half of a float, same range and
+//8 bits of mantissa) or IEEE half (11 bits of mantissa, up to 65504).
+enum CpuHalf {
+	CPU_BF16, CPU_FP16
+};
+
+//Like cpu_gemm, where A is stored in 16 bits. The blocks of A are converted to fp32 when
+//they are packed, so the products and the sums are in fp32.
+void cpu_gemm_half(CpuHalf type, uint16_t* a, size_t lda, bool transA, float* b, size_t ldb, bool transB, float* c,
+		size_t ldc, size_t m, size_t n, size_t p, float beta);
+
+//y = A x, where A is (m x n) with leading dimension lda.
+void cpu_gemv(float* a, size_t lda, float* x, float* y, size_t m, size_t n);
+
+//y = op(A) x, where A is (m x n): y = A x (x has n values and y has m) or, when transA
+//is set, y = A^T x (x has m values and y has n). y is overwritten.
+void cpu_gemv(float* a, size_t lda, bool transA, float* x, float* y, size_t m, size_t n);
+void cpu_gemv(double* a, size_t lda, bool transA, double* x, double* y, size_t m, size_t n);
+
+//y_k = op(A_k) x_k for k < batch, where A_k starts at a + k * strideA, x_k at x + k * strideX
+//and y_k at y + k * strideY. A stride of 0 shares the matrix (or x) between all the products.
+void cpu_gemv_batched(float* a, size_t lda, size_t strideA, bool transA, float* x, size_t strideX, float* y,
+		size_t strideY, size_t m, size_t n, size_t batch);
+void cpu_gemv_batched(double* a, size_t lda, size_t strideA, bool transA, double* x, size_t strideX, double* y,
+		size_t strideY, size_t m, size_t n, size_t batch);
+
+//a . b for l elements.
+float cpu_vdot(float* a, float* b, size_t l);
+double cpu_vdot(double* a, double* b, size_t l);
+
+//DEST = A^T, where A is (m x n) and DEST is (n x m). They must not overlap.
+void cpu_transpose(float* a, size_t lda, float* dest, size_t ldd, size_t m, size_t n);
+void cpu_transpose(double* a, size_t lda, double* dest, size_t ldd, size_t m, size_t n);
+
+//A = A^T in place, where A is (n x n).
+void cpu_transpose_square(float* a, size_t lda, size_t n);
+void cpu_transpose_square(double* a, size_t lda, size_t n);
+
+//C = S x B, where S is an (m x n) CSR matrix (vals and cols of its nonzeros, rows[i] the
+//first nonzero of row i, rows[m] the count), B is (n x p) and C is (m x p). C is overwritten.
+void cpu_spmm(float* vals, size_t* cols, size_t* rows, float* b, size_t ldb, float* c, size_t ldc, size_t m,
+		size_t p);
+
+//T = S^T in CSR, where S is (m x n): tvals and tcols have rows[m] values and trows n + 1.
+void cpu_csr_transpose(float* vals, size_t* cols, size_t* rows, size_t m, size_t n, float* tvals, size_t* tcols,
+		size_t* trows);
+
+//DEST = SRC rounded to the nearest 16 bit value (ties to even), both (m x n).
+void cpu_to_half(CpuHalf type, float* src, size_t lds, uint16_t* dest, size_t ldd, size_t m, size_t n);
+
+//DEST = SRC widened to fp32, which is exact.
+void cpu_from_half(CpuHalf type, uint16_t* src, size_t lds, float* dest, size_t ldd, size_t m, size_t n);
+
+//Single values, for the element access.
+uint16_t cpu_to_half(CpuHalf type, float val);
+float cpu_from_half(CpuHalf type, uint16_t val);
+
+//Sum of a 16 bit A (m x n), accumulated in fp32.
+float cpu_half_sum(CpuHalf type, uint16_t* a, size_t lda, size_t m, size_t n);
+
+//An 8 bit matrix of a float one: x ~ scale * (q - zero), with q in [0, 255].
+struct CpuQuant {
+	float scale;
+	int32_t zero;
+};
+
+//DEST = SRC quantized with one scale for all its values, the range of SRC (with 0 in it).
+CpuQuant cpu_quantize(float* src, size_t lds, uint8_t* dest, size_t ldd, size_t m, size_t n);
+
+//Bytes of the packed int8 weights of an (n x p) W.
+size_t cpu_qpack_size(size_t n, size_t p);
+
+//Quantizes W (n x p) to int8 with one scale per column (per output) into packed, the layout
+//of cpu_qaffine. scales and sums (the sums of the quantized columns) have p values.
+void cpu_qpack(float* w, size_t ldw, size_t n, size_t p, int8_t* packed, float* scales, int32_t* sums);
+
+//C = A x W + b, where A is (m x n) quantized with q, W was packed by cpu_qpack and C is (m x p).
+//The products are summed in int32 and C is dequantized from the sums. The rows of A are read
+//in groups of 4 values, up to 3 bytes past the end of a row (and of A) that are not used.
+void cpu_qaffine(uint8_t* a, size_t lda, CpuQuant q, int8_t* packed, float* scales, int32_t* sums, float* b,
+		float* c, size_t ldc, size_t m, size_t n, size_t p);
+
+//a = a + alpha * b
+void cpu_add_inplace(float* a, float* b, const float alpha, size_t l);
+
+//dest = exp(a) for l elements, vectorized (see vmath.cpp for the accuracy).
+void cpu_exp(float* a, float* dest, size_t l);
+
+//FX = 1 / (1 + exp(-X)), where X and FX are (m x n) with leading dimensions ldx and ldfx.
+void cpu_sigmoid_fx(float* x, size_t ldx, float* fx, size_t ldfx, size_t m, size_t n);
+
+//DX = FX * (1 - FX) * DG, the backward of the sigmoid from its output FX.
+void cpu_sigmoid_dx(float* fx, size_t ldfx, float* dg, size_t lddg, float* dx, size_t lddx, size_t m, size_t n);
+
+//FX = act(X), (m x n). FX can be X.
+void cpu_activation(CpuActivation act, float* x, size_t ldx, float* fx, size_t ldfx, size_t m, size_t n);
+
+//Element wise operations of the broadcasts.
+enum CpuOp {
+	CPU_ADD, CPU_SUB, CPU_MUL, CPU_DIV
+};
+
+//Broadcasts over the rows: dest[i, j] = a[i, j] op b[j], where A and DEST are (m x n)
+//and b has n values. With CPU_ADD it is gpu_broadcast_sum_rows. DEST can be A.
+void cpu_broadcast_rows(CpuOp op, float* a, size_t lda, float* b, float* dest, size_t ldd, size_t m, size_t n);
+void cpu_broadcast_rows(CpuOp op, double* a, size_t lda, double* b, double* dest, size_t ldd, size_t m, size_t n);
+
+//Broadcasts over the columns: dest[i, j] = a[i, j] op b[i], where b has m values.
+void cpu_broadcast_cols(CpuOp op, float* a, size_t lda, float* b, float* dest, size_t ldd, size_t m, size_t n);
+void cpu_broadcast_cols(CpuOp op, double* a, size_t lda, double* b, double* dest, size_t ldd, size_t m, size_t n);
+
+//Reductions of A, where A is (m x n) with leading dimension lda (a vector is a 1 x n matrix).
+//They are vectorized and the sums are blocked, see reduce.cpp.
+float cpu_sum(float* a, size_t lda, size_t m, size_t n);
+float cpu_max(float* a, size_t lda, size_t m, size_t n);
+float cpu_min(float* a, size_t lda, size_t m, size_t n);
+double cpu_sum(double* a, size_t lda, size_t m, size_t n);
+double cpu_max(double* a, size_t lda, size_t m, size_t n);
+double cpu_min(double* a, size_t lda, size_t m, size_t n);
+
+//Sum of (a - center)^2 over the elements of A, for the variance.
+float cpu_sum_sq_dev(float* a, size_t lda, size_t m, size_t n, float center);
+double cpu_sum_sq_dev(double* a, size_t lda, size_t m, size_t n, double center);
+
+//Reductions over the rows: dest[j] = op of column j, for j < n. Same as gpu_sum_rows.
+void cpu_sum_rows(float* a, size_t lda, float* dest, size_t m, size_t n);
+void cpu_max_rows(float* a, size_t lda, float* dest, size_t m, size_t n);
+void cpu_min_rows(float* a, size_t lda, float* dest, size_t m, size_t n);
+void cpu_sum_rows(double* a, size_t lda, double* dest, size_t m, size_t n);
+void cpu_max_rows(double* a, size_t lda, double* dest, size_t m, size_t n);
+void cpu_min_rows(double* a, size_t lda, double* dest, size_t m, size_t n);
+
+//Reductions over the columns: dest[i] = op of row i, for i < m.
+void cpu_sum_cols(float* a, size_t lda, float* dest, size_t m, size_t n);
+void cpu_max_cols(float* a, size_t lda, float* dest, size_t m, size_t n);
+void cpu_min_cols(float* a, size_t lda, float* dest, size_t m, size_t n);
+void cpu_sum_cols(double* a, size_t lda, double* dest, size_t m, size_t n);
+void cpu_max_cols(double* a, size_t lda, double* dest, size_t m, size_t n);
+void cpu_min_cols(double* a, size_t lda, double* dest, size_t m, size_t n);
+
+} // namespace cpu
+} // namespace cs
+
+#endif // CS_CPU_CPU_H_
@@ -0,0 +1,80 @@
+/*
+ * cpu_utils.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_CPU_CPU_UTILS_H_
+#define CS_CPU_CPU_UTILS_H_
+
+#include <cs/cpu/cpu.h>
+#include <stdlib.h>
+
+//The SIMD kernels are compiled with per function target attributes and selected at
+//runtime, so the library does not need to be built with -mavx2 or -mavx512f.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CS_CPU_X86 1
+#define CS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CS_TARGET(isa)
+#endif
+
+//The VNNI instructions need GCC 11 or Clang 12, older compilers only get the AVX2 int8 kernels.
+#if defined(CS_CPU_X86) && ((defined(__clang__) && __clang_major__ >= 12) || (!defined(__clang__) && __GNUC__ >= 11))
+#define CS_CPU_VNNI 1
+#endif
+
+namespace cs {
+namespace cpu {
+
+//Cache blocking of the GEMM engine (in elements).
+//MC x KC is the packed panel of A that should live in L2.
+//KC x NC is the packed panel of B that should live in L3.
+extern size_t GEMM_MC;
+extern size_t GEMM_KC;
+extern size_t GEMM_NC;
+
+//The micro-kernel, checked against the CPU when it is set.
+extern CpuGemmKernel GEMM_KERNEL;
+
+//Applies the saved configuration (see cpu_gemm_load) once, before the first blocked product.
+void gemm_configure();
+
+//Below this amount of multiply-adds (m * n * p) the packing does not pay off.
+extern size_t GEMM_SMALL;
+
+//Below this amount of multiply-adds (m * n * p) a product runs on the calling thread.
+extern size_t GEMM_PARALLEL;
+
+//C = act(C + bias) on the calling thread, where C is (m x n) and bias has n values, the
+//epilogue of a GEMM tile (see CpuEpilogue). PRE gets C + bias, bias and pre can be nullptr.
+void gemm_epilogue(CpuActivation act, float* c, size_t ldc, const float* bias, float* pre, size_t ldpre, size_t m,
+		size_t n);
+
+//A buffer of bytes mapped on its own with the pages and the placement of policy, at a
+//CPU_HUGE_PAGE boundary and zeroed (see memory.cpp). memory_unmap takes the same bytes.
+void* memory_map(size_t bytes, const CpuMemoryPolicy& policy);
+void memory_unmap(void* ptr, size_t bytes);
+
+//The category of the cpu_malloc calls of the calling thread, whether a CpuMemoryScope
+//set it, and a check that they are allowed (see CpuNoAllocations), in track.cpp.
+CpuMemoryCategory memory_category();
+bool memory_scoped();
+void memory_check(size_t bytes);
+
+bool cpu_has_avx2();
+bool cpu_has_avx512();
+
+//The int8 dot product instructions: AVX-VNNI, or AVX512-VNNI with the 256 bit forms.
+bool cpu_has_avx_vnni();
+bool cpu_has_avx512_vnni();
+
+//Runs fn(task, ctx) for task in [0, tasks) on the thread pool and returns when all
+//of them are done. Tasks must not throw. Nested calls run on the calling thread.
+void cpu_parallel(size_t tasks, void (*fn)(size_t task, void* ctx), void* ctx);
+
+} // namespace cpu
+} // namespace cs
+
+#endif // CS_CPU_CPU_UTILS_H_
@@ -12,7 +12,9 @@
 #include <string>
 
 #include <cs/data/GridInfo.h>
+#include <cs/math/CpuHalfMatrix.h>
 #include <cs/math/CpuMatrix.h>
+#include <cs/math/CpuSparseMatrix.h>
 
 using namespace std;
 
@@ -26,12 +28,19 @@ private:
 	const size_t _cols;
 	GridInfo _info;
 	vector<string> data;
+	//bytes counted as data by the memory tracker
+	size_t tracked = 0;
+	void track();
 	size_t calculateColumns(string& raw, char delimiter);
-	void toVector(float* vals, size_t row, size_t start, size_t end, bool stdScale) const;
+	void toVector(float* vals, size_t row, size_t start, size_t end) const;
+	size_t toWidth(size_t start, size_t end) const;
+	void toScales(size_t start, size_t end, CpuVector& mean, CpuVector& stdev) const;
 
 public:
 	Grid(string& raw);
 	Grid(string& raw, char delimiter);
+	//a copy counts its own bytes, the destructor of each one releases them
+	Grid(const Grid& other);
 	size_t cols() const;
 	size_t rows() const;
 	void shuffle();
@@ -40,10 +49,16 @@ public:
 	GridInfo info();
 	const string get(size_t row, size_t col) const;
 	void set(size_t row, size_t col, string& val);
-	const CpuMatrix toMatrix(size_t col) const;
-	const CpuMatrix toMatrix(size_t col, bool stdScale) const;
-	const CpuMatrix toMatrix(size_t start, size_t end) const;
-	const CpuMatrix toMatrix(size_t start, size_t end, bool stdScale) const;
+	CpuMatrix toMatrix(size_t col) const;
+	CpuMatrix toMatrix(size_t col, bool stdScale) const;
+	CpuMatrix toMatrix(size_t start, size_t end) const;
+	CpuMatrix toMatrix(size_t start, size_t end, bool stdScale) const;
+	//the matrix placed with policy, see cpu::CpuMemoryPolicy
+	CpuMatrix toMatrix(size_t start, size_t end, bool stdScale, const cpu::CpuMemoryPolicy& policy) const;
+	//same values as toMatrix without the zeros, a word column is a single 1
+	CpuSparseMatrix toSparseMatrix(size_t start, size_t end, bool stdScale) const;
+	//toMatrix rounded to 16 bits, without the fp32 matrix in between
+	CpuHalfMatrix toHalfMatrix(size_t start, size_t end, bool stdScale, cpu::CpuHalf type) const;
 	void addRow(vector<string> row);
 	void print() const;
 	virtual ~Grid();
@@ -22,6 +22,8 @@ void check_cuda(cudaError_t error);
 void check_cublas(cublasStatus_t status);
 const char* _cuda_get_error_enum(cublasStatus_t error);
 void copy_cpu_to_gpu(float* src, float* dest, size_t length);
+//copies a (m x n) host matrix with leading dimension lds to a contiguous device matrix
+void copy_cpu_to_gpu(float* src, size_t lds, float* dest, size_t m, size_t n);
 void copy_gpu_to_cpu(float* src, float* dst, size_t length);
 void copy_gpu_to_gpu(float* src, float* dst, size_t length);
 
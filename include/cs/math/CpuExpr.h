@@ -0,0 +1,892 @@
+/*
+ * CpuExpr.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_MATH_CPUEXPR_H_
+#define CS_MATH_CPUEXPR_H_
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <stddef.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+//Expression templates for the element wise arithmetic of CpuMatrix and CpuVector.
+//
+//The operators do not compute anything, they return a small tree that keeps the
+//pointers of the operands. The tree is evaluated in a single pass when it is
+//assigned to a CpuMatrix/CpuVector (construction or operator=) or reduced with
+//sum/max/min/avg, so (h - y) ^ 2 makes one pass and at most one allocation. A
+//reduction evaluates the elements in blocks of EXPR_BLOCK into a buffer on the stack
+//and gives each block to the kernels of cpu_sum/cpu_max/cpu_min, so sum((h - y) ^ 2)
+//is as accurate and as fast as cpu_sum of the materialized matrix.
+//
+//A named CpuMatrix/CpuVector (or a named expression) is kept by pointer, so it
+//must outlive the expression (auto e = a + b; is valid while a and b are alive). A temporary one, like the
+//result of a.dot(b), is moved into the expression, and when the expression is
+//evaluated into a new matrix the temporary gives its memory to the result, so
+//CpuMatrix c = a.dot(b) + x; allocates only once.
+//
+//An expression has the element type of its operands (value_type), float and double
+//operands can not be mixed and a scalar is converted to the type of the expression.
+
+namespace cs {
+namespace math {
+
+template<typename T>
+class BasicCpuMatrix;
+template<typename T>
+class BasicMatrixView;
+template<typename T>
+class BasicCpuVector;
+
+//Operations
+//=============================================================================
+struct ExprAdd {
+	template<class T>
+	static T apply(T a, T b) {
+		return a + b;
+	}
+};
+
+struct ExprSub {
+	template<class T>
+	static T apply(T a, T b) {
+		return a - b;
+	}
+};
+
+struct ExprMult {
+	template<class T>
+	static T apply(T a, T b) {
+		return a * b;
+	}
+};
+
+struct ExprDiv {
+	template<class T>
+	static T apply(T a, T b) {
+		return a / b;
+	}
+};
+
+struct ExprPow {
+	template<class T>
+	static T apply(T a, T b) {
+		//a * a is exactly what pow returns for b == 2, but it can be vectorized.
+		return b == 2 ? a * a : std::pow(a, b);
+	}
+};
+
+struct ExprNeg {
+	template<class T>
+	static T apply(T a, T b) {
+		return -a;
+	}
+};
+
+//s - a and s / a
+struct ExprRSub {
+	template<class T>
+	static T apply(T a, T b) {
+		return b - a;
+	}
+};
+
+struct ExprRDiv {
+	template<class T>
+	static T apply(T a, T b) {
+		return b / a;
+	}
+};
+
+//Elements of the blocks, 16 KB of floats that stay in L1, the block of the cpu_sum kernels.
+const size_t EXPR_BLOCK = 4096;
+
+//The reductions of the blocks, the sums are added in double like the blocks of cpu_sum.
+template<class T>
+struct ExprSum {
+	double ans = 0.0;
+	
+	void add(T* block, size_t l) {
+		ans += cpu::cpu_sum(block, l, 1, l);
+	}
+};
+
+template<class T>
+struct ExprMax {
+	T ans;
+	bool first = true;
+	
+	void add(T* block, size_t l) {
+		T v = cpu::cpu_max(block, l, 1, l);
+		ans = first ? v : std::max(ans, v);
+		first = false;
+	}
+};
+
+template<class T>
+struct ExprMin {
+	T ans;
+	bool first = true;
+	
+	void add(T* block, size_t l) {
+		T v = cpu::cpu_min(block, l, 1, l);
+		ans = first ? v : std::min(ans, v);
+		first = false;
+	}
+};
+
+//Matrix expressions, element (i, j) is eval(i, j)
+//=============================================================================
+
+//The base of every matrix expression, whatever its types.
+struct MatrixExprBase {
+};
+
+template<class E, class T>
+struct MatrixExpr: public MatrixExprBase {
+
+	const E& self() const {
+		return static_cast<const E&>(*this);
+	}
+
+	//Elements (i, j) to (i, j + l - 1) into block.
+	void eval_block(size_t i, size_t j, size_t l, T* block) const {
+		const E& e = self();
+		for (size_t k = 0; k < l; k++) {
+			block[k] = e.eval(i, j + k);
+		}
+	}
+
+	//Writes the expression into dest, a row major (m x n) array with leading dimension ld.
+	//Each element only reads the elements at the same position, so dest may also be an operand.
+	void eval_to(T* dest, size_t ld) const {
+		const E& e = self();
+		for (size_t i = 0; i < e.m; i++) {
+			eval_block(i, 0, e.n, dest + i * ld);
+		}
+	}
+
+	//Gives the elements to r in blocks of whole rows, or of parts of a row longer than EXPR_BLOCK.
+	template<class R>
+	void reduce(R& r) const {
+		const E& e = self();
+		alignas(64) T block[EXPR_BLOCK];
+
+		if (e.n > EXPR_BLOCK) {
+			for (size_t i = 0; i < e.m; i++) {
+				for (size_t j = 0; j < e.n; j += EXPR_BLOCK) {
+					size_t l = std::min(EXPR_BLOCK, e.n - j);
+					eval_block(i, j, l, block);
+					r.add(block, l);
+				}
+			}
+			return;
+		}
+
+		const size_t rows = EXPR_BLOCK / e.n;
+		for (size_t i = 0; i < e.m; i += rows) {
+			size_t end = std::min(e.m, i + rows);
+			size_t l = 0;
+			//a column, like the outputs of a network, without the loop of one element per row
+			if (e.n == 1) {
+				for (size_t k = i; k < end; k++) {
+					block[l++] = e.eval(k, 0);
+				}
+			} else {
+				for (size_t k = i; k < end; k++) {
+					for (size_t j = 0; j < e.n; j++) {
+						block[l++] = e.eval(k, j);
+					}
+				}
+			}
+			r.add(block, l);
+		}
+	}
+
+	T sum() const {
+		ExprSum<T> r;
+		reduce(r);
+		return (T) r.ans;
+	}
+
+	T max() const {
+		ExprMax<T> r;
+		reduce(r);
+		return r.ans;
+	}
+
+	T min() const {
+		ExprMin<T> r;
+		reduce(r);
+		return r.ans;
+	}
+
+	T avg() const {
+		const E& e = self();
+		return sum() / (e.m * e.n);
+	}
+};
+
+//A CpuMatrix inside an expression.
+template<class T>
+struct MatrixTerm: public MatrixExpr<MatrixTerm<T>, T> {
+	typedef T value_type;
+	
+	const T* arr;
+	const size_t ld;
+	const size_t m;
+	const size_t n;
+
+	template<class M>
+	explicit MatrixTerm(const M& a) :
+			arr(a.ptr()), ld(a.ld), m(a.m), n(a.n) {
+	}
+
+	T eval(size_t i, size_t j) const {
+		return arr[i * ld + j];
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return false;
+	}
+};
+
+//A temporary CpuMatrix inside an expression, owned by the expression.
+template<class M>
+struct MatrixTemp: public MatrixExpr<MatrixTemp<M>, typename M::value_type> {
+	typedef typename M::value_type value_type;
+	
+	M mat;
+	const value_type* arr;
+	const size_t ld;
+	const size_t m;
+	const size_t n;
+
+	explicit MatrixTemp(M&& a) :
+			mat(std::move(a)), arr(mat.ptr()), ld(mat.ld), m(mat.m), n(mat.n) {
+	}
+
+	explicit MatrixTemp(const M& a) :
+			mat(a), arr(mat.ptr()), ld(mat.ld), m(mat.m), n(mat.n) {
+	}
+
+	MatrixTemp(MatrixTemp&& other) :
+			mat(std::move(other.mat)), arr(other.arr), ld(other.ld), m(other.m), n(other.n) {
+	}
+
+	MatrixTemp(const MatrixTemp& other) :
+			mat(other.mat), arr(mat.ptr()), ld(mat.ld), m(other.m), n(other.n) {
+	}
+
+	value_type eval(size_t i, size_t j) const {
+		return arr[i * ld + j];
+	}
+
+	//Moves the matrix into dest (with its leading dimension), arr keeps pointing to the same memory.
+	bool take(M& dest) {
+		if (mat.ptr() == nullptr) {
+			return false;
+		}
+
+		dest = std::move(mat);
+		return true;
+	}
+};
+
+template<class Op, class L, class R>
+struct MatrixBinary: public MatrixExpr<MatrixBinary<Op, L, R>, typename L::value_type> {
+	typedef typename L::value_type value_type;
+	static_assert(is_same<value_type, typename R::value_type>::value,
+			"The operands of an expression must have the same element type.");
+	
+	L l;
+	R r;
+	const size_t m;
+	const size_t n;
+
+	MatrixBinary(L&& l, R&& r) :
+			l(std::move(l)), r(std::move(r)), m(this->l.m), n(this->l.n) {
+
+		if (l.m != r.m) {
+			throw core::Exception(
+					"The rows must be the same. Expected " + to_string(l.m) + ", but got: " + to_string(r.m)
+							+ " instead.");
+		}
+
+		if (l.n != r.n) {
+			throw core::Exception(
+					"The columns must be the same. Expected " + to_string(l.n) + ", but got: " + to_string(r.n)
+							+ " instead.");
+		}
+	}
+
+	value_type eval(size_t i, size_t j) const {
+		return Op::apply(l.eval(i, j), r.eval(i, j));
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return l.take(dest) || r.take(dest);
+	}
+};
+
+template<class Op, class L>
+struct MatrixScalar: public MatrixExpr<MatrixScalar<Op, L>, typename L::value_type> {
+	typedef typename L::value_type value_type;
+	
+	L l;
+	const value_type s;
+	const size_t m;
+	const size_t n;
+
+	MatrixScalar(L&& l, value_type s) :
+			l(std::move(l)), s(s), m(this->l.m), n(this->l.n) {
+	}
+
+	value_type eval(size_t i, size_t j) const {
+		return Op::apply(l.eval(i, j), s);
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return l.take(dest);
+	}
+};
+
+//A named expression inside another expression, kept by pointer like a named CpuMatrix.
+template<class E>
+struct MatrixRef: public MatrixExpr<MatrixRef<E>, typename E::value_type> {
+	typedef typename E::value_type value_type;
+	
+	const E* e;
+	const size_t m;
+	const size_t n;
+
+	explicit MatrixRef(const E& e) :
+			e(&e), m(e.m), n(e.n) {
+	}
+
+	value_type eval(size_t i, size_t j) const {
+		return e->eval(i, j);
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return false;
+	}
+};
+
+template<class T>
+struct is_matrix_expr: public is_base_of<MatrixExprBase, typename decay<T>::type> {
+};
+
+//The type that represents an operator argument of type T (as deduced for A&&)
+//inside an expression: a named CpuMatrix (or any MatrixView) becomes a MatrixTerm,
+//a temporary one a MatrixTemp, a named expression a MatrixRef, a temporary expression
+//is moved in as it is and anything else has no type.
+template<class T, class Enable = void>
+struct matrix_operand {
+};
+
+template<class T>
+struct matrix_operand<BasicCpuMatrix<T>&> {
+	typedef MatrixTerm<T> type;
+};
+
+template<class T>
+struct matrix_operand<const BasicCpuMatrix<T>&> {
+	typedef MatrixTerm<T> type;
+};
+
+template<class T>
+struct matrix_operand<BasicMatrixView<T>&> {
+	typedef MatrixTerm<T> type;
+};
+
+template<class T>
+struct matrix_operand<const BasicMatrixView<T>&> {
+	typedef MatrixTerm<T> type;
+};
+
+//a temporary view does not own memory, it is kept by pointer too
+template<class T>
+struct matrix_operand<BasicMatrixView<T> > {
+	typedef MatrixTerm<T> type;
+};
+
+template<class T>
+struct matrix_operand<const BasicMatrixView<T> > {
+	typedef MatrixTerm<T> type;
+};
+
+template<class T>
+struct matrix_operand<BasicCpuMatrix<T> > {
+	typedef MatrixTemp<BasicCpuMatrix<T> > type;
+};
+
+template<class T>
+struct matrix_operand<const BasicCpuMatrix<T> > {
+	typedef MatrixTemp<BasicCpuMatrix<T> > type;
+};
+
+template<class T>
+struct matrix_operand<T, typename enable_if<is_matrix_expr<T>::value && is_lvalue_reference<T>::value>::type> {
+	typedef MatrixRef<typename decay<T>::type> type;
+};
+
+template<class T>
+struct matrix_operand<T, typename enable_if<is_matrix_expr<T>::value && !is_lvalue_reference<T>::value>::type> {
+	typedef typename decay<T>::type type;
+};
+
+//Aliases, so a type that is not an operand removes the operator from overload resolution.
+template<class Op, class A, class B>
+using matrix_binary = MatrixBinary<Op, typename matrix_operand<A>::type, typename matrix_operand<B>::type>;
+
+template<class Op, class A>
+using matrix_scalar = MatrixScalar<Op, typename matrix_operand<A>::type>;
+
+//The element type of an operand, the type of the scalars applied to it.
+template<class A>
+using matrix_value = typename matrix_operand<A>::type::value_type;
+
+template<class A, class B>
+matrix_binary<ExprAdd, A, B> operator+(A&& a, B&& b) {
+	typedef matrix_binary<ExprAdd, A, B> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), typename matrix_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A, class B>
+matrix_binary<ExprSub, A, B> operator-(A&& a, B&& b) {
+	typedef matrix_binary<ExprSub, A, B> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), typename matrix_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A, class B>
+matrix_binary<ExprMult, A, B> operator*(A&& a, B&& b) {
+	typedef matrix_binary<ExprMult, A, B> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), typename matrix_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A, class B>
+matrix_binary<ExprDiv, A, B> operator/(A&& a, B&& b) {
+	typedef matrix_binary<ExprDiv, A, B> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), typename matrix_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A>
+matrix_scalar<ExprAdd, A> operator+(A&& a, matrix_value<A> s) {
+	typedef matrix_scalar<ExprAdd, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprAdd, A> operator+(matrix_value<A> s, A&& a) {
+	typedef matrix_scalar<ExprAdd, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprSub, A> operator-(A&& a, matrix_value<A> s) {
+	typedef matrix_scalar<ExprSub, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprRSub, A> operator-(matrix_value<A> s, A&& a) {
+	typedef matrix_scalar<ExprRSub, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprNeg, A> operator-(A&& a) {
+	typedef matrix_scalar<ExprNeg, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), 0);
+}
+
+template<class A>
+matrix_scalar<ExprMult, A> operator*(A&& a, matrix_value<A> s) {
+	typedef matrix_scalar<ExprMult, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprMult, A> operator*(matrix_value<A> s, A&& a) {
+	typedef matrix_scalar<ExprMult, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprDiv, A> operator/(A&& a, matrix_value<A> s) {
+	typedef matrix_scalar<ExprDiv, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprRDiv, A> operator/(matrix_value<A> s, A&& a) {
+	typedef matrix_scalar<ExprRDiv, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+matrix_scalar<ExprPow, A> operator^(A&& a, matrix_value<A> exp) {
+	typedef matrix_scalar<ExprPow, A> T;
+	return T(typename matrix_operand<A>::type(std::forward<A>(a)), exp);
+}
+
+template<class E, class T>
+T sum(const MatrixExpr<E, T>& e) {
+	return e.sum();
+}
+
+//Vector expressions, element i is eval(i)
+//=============================================================================
+//The base of every vector expression, whatever its types.
+struct VectorExprBase {
+};
+
+template<class E, class T>
+struct VectorExpr: public VectorExprBase {
+
+	const E& self() const {
+		return static_cast<const E&>(*this);
+	}
+
+	//Elements i to i + l - 1 into block.
+	void eval_block(size_t i, size_t l, T* block) const {
+		const E& e = self();
+		for (size_t k = 0; k < l; k++) {
+			block[k] = e.eval(i + k);
+		}
+	}
+
+	//Writes the expression into dest, an array of length elements. Each element only
+	//reads the elements at the same position, so dest may also be an operand.
+	void eval_to(T* dest) const {
+		eval_block(0, self().length, dest);
+	}
+
+	template<class R>
+	void reduce(R& r) const {
+		const E& e = self();
+		alignas(64) T block[EXPR_BLOCK];
+
+		for (size_t i = 0; i < e.length; i += EXPR_BLOCK) {
+			size_t l = std::min(EXPR_BLOCK, e.length - i);
+			eval_block(i, l, block);
+			r.add(block, l);
+		}
+	}
+
+	T sum() const {
+		ExprSum<T> r;
+		reduce(r);
+		return (T) r.ans;
+	}
+
+	T max() const {
+		ExprMax<T> r;
+		reduce(r);
+		return r.ans;
+	}
+
+	T min() const {
+		ExprMin<T> r;
+		reduce(r);
+		return r.ans;
+	}
+
+	T avg() const {
+		return sum() / self().length;
+	}
+};
+
+//A CpuVector inside an expression.
+template<class T>
+struct VectorTerm: public VectorExpr<VectorTerm<T>, T> {
+	typedef T value_type;
+	
+	const T* arr;
+	const size_t length;
+
+	template<class V>
+	explicit VectorTerm(const V& a) :
+			arr(a.ptr()), length(a.length) {
+	}
+
+	T eval(size_t i) const {
+		return arr[i];
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return false;
+	}
+};
+
+//A temporary CpuVector inside an expression, owned by the expression.
+template<class V>
+struct VectorTemp: public VectorExpr<VectorTemp<V>, typename V::value_type> {
+	typedef typename V::value_type value_type;
+	
+	V vec;
+	const value_type* arr;
+	const size_t length;
+
+	explicit VectorTemp(V&& a) :
+			vec(std::move(a)), arr(vec.ptr()), length(vec.length) {
+	}
+
+	explicit VectorTemp(const V& a) :
+			vec(a), arr(vec.ptr()), length(vec.length) {
+	}
+
+	VectorTemp(VectorTemp&& other) :
+			vec(std::move(other.vec)), arr(other.arr), length(other.length) {
+	}
+
+	VectorTemp(const VectorTemp& other) :
+			vec(other.vec), arr(vec.ptr()), length(other.length) {
+	}
+
+	value_type eval(size_t i) const {
+		return arr[i];
+	}
+
+	//Moves the vector into dest, arr keeps pointing to the same memory.
+	bool take(V& dest) {
+		if (vec.ptr() == nullptr) {
+			return false;
+		}
+
+		dest = std::move(vec);
+		return true;
+	}
+};
+
+template<class Op, class L, class R>
+struct VectorBinary: public VectorExpr<VectorBinary<Op, L, R>, typename L::value_type> {
+	typedef typename L::value_type value_type;
+	static_assert(is_same<value_type, typename R::value_type>::value,
+			"The operands of an expression must have the same element type.");
+	
+	L l;
+	R r;
+	const size_t length;
+
+	VectorBinary(L&& l, R&& r) :
+			l(std::move(l)), r(std::move(r)), length(this->l.length) {
+
+		if (l.length != r.length) {
+			throw core::Exception(
+					"The length must be the same. Expected " + to_string(l.length) + ", but got: "
+							+ to_string(r.length) + " instead.");
+		}
+	}
+
+	value_type eval(size_t i) const {
+		return Op::apply(l.eval(i), r.eval(i));
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return l.take(dest) || r.take(dest);
+	}
+};
+
+template<class Op, class L>
+struct VectorScalar: public VectorExpr<VectorScalar<Op, L>, typename L::value_type> {
+	typedef typename L::value_type value_type;
+	
+	L l;
+	const value_type s;
+	const size_t length;
+
+	VectorScalar(L&& l, value_type s) :
+			l(std::move(l)), s(s), length(this->l.length) {
+	}
+
+	value_type eval(size_t i) const {
+		return Op::apply(l.eval(i), s);
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return l.take(dest);
+	}
+};
+
+//A named expression inside another expression, kept by pointer like a named CpuVector.
+template<class E>
+struct VectorRef: public VectorExpr<VectorRef<E>, typename E::value_type> {
+	typedef typename E::value_type value_type;
+	
+	const E* e;
+	const size_t length;
+
+	explicit VectorRef(const E& e) :
+			e(&e), length(e.length) {
+	}
+
+	value_type eval(size_t i) const {
+		return e->eval(i);
+	}
+
+	template<class M>
+	bool take(M& dest) {
+		return false;
+	}
+};
+
+template<class T>
+struct is_vector_expr: public is_base_of<VectorExprBase, typename decay<T>::type> {
+};
+
+template<class T, class Enable = void>
+struct vector_operand {
+};
+
+template<class T>
+struct vector_operand<BasicCpuVector<T>&> {
+	typedef VectorTerm<T> type;
+};
+
+template<class T>
+struct vector_operand<const BasicCpuVector<T>&> {
+	typedef VectorTerm<T> type;
+};
+
+template<class T>
+struct vector_operand<BasicCpuVector<T> > {
+	typedef VectorTemp<BasicCpuVector<T> > type;
+};
+
+template<class T>
+struct vector_operand<const BasicCpuVector<T> > {
+	typedef VectorTemp<BasicCpuVector<T> > type;
+};
+
+template<class T>
+struct vector_operand<T, typename enable_if<is_vector_expr<T>::value && is_lvalue_reference<T>::value>::type> {
+	typedef VectorRef<typename decay<T>::type> type;
+};
+
+template<class T>
+struct vector_operand<T, typename enable_if<is_vector_expr<T>::value && !is_lvalue_reference<T>::value>::type> {
+	typedef typename decay<T>::type type;
+};
+
+//Aliases, so a type that is not an operand removes the operator from overload resolution.
+template<class Op, class A, class B>
+using vector_binary = VectorBinary<Op, typename vector_operand<A>::type, typename vector_operand<B>::type>;
+
+template<class Op, class A>
+using vector_scalar = VectorScalar<Op, typename vector_operand<A>::type>;
+
+template<class A>
+using vector_value = typename vector_operand<A>::type::value_type;
+
+template<class A, class B>
+vector_binary<ExprAdd, A, B> operator+(A&& a, B&& b) {
+	typedef vector_binary<ExprAdd, A, B> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), typename vector_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A, class B>
+vector_binary<ExprSub, A, B> operator-(A&& a, B&& b) {
+	typedef vector_binary<ExprSub, A, B> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), typename vector_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A, class B>
+vector_binary<ExprMult, A, B> operator*(A&& a, B&& b) {
+	typedef vector_binary<ExprMult, A, B> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), typename vector_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A, class B>
+vector_binary<ExprDiv, A, B> operator/(A&& a, B&& b) {
+	typedef vector_binary<ExprDiv, A, B> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), typename vector_operand<B>::type(std::forward<B>(b)));
+}
+
+template<class A>
+vector_scalar<ExprAdd, A> operator+(A&& a, vector_value<A> s) {
+	typedef vector_scalar<ExprAdd, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprAdd, A> operator+(vector_value<A> s, A&& a) {
+	typedef vector_scalar<ExprAdd, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprSub, A> operator-(A&& a, vector_value<A> s) {
+	typedef vector_scalar<ExprSub, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprRSub, A> operator-(vector_value<A> s, A&& a) {
+	typedef vector_scalar<ExprRSub, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprNeg, A> operator-(A&& a) {
+	typedef vector_scalar<ExprNeg, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), 0);
+}
+
+template<class A>
+vector_scalar<ExprMult, A> operator*(A&& a, vector_value<A> s) {
+	typedef vector_scalar<ExprMult, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprMult, A> operator*(vector_value<A> s, A&& a) {
+	typedef vector_scalar<ExprMult, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprDiv, A> operator/(A&& a, vector_value<A> s) {
+	typedef vector_scalar<ExprDiv, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprRDiv, A> operator/(vector_value<A> s, A&& a) {
+	typedef vector_scalar<ExprRDiv, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), s);
+}
+
+template<class A>
+vector_scalar<ExprPow, A> operator^(A&& a, vector_value<A> exp) {
+	typedef vector_scalar<ExprPow, A> T;
+	return T(typename vector_operand<A>::type(std::forward<A>(a)), exp);
+}
+
+template<class E, class T>
+T sum(const VectorExpr<E, T>& e) {
+	return e.sum();
+}
+
+} // namespace math
+} // namespace cs
+
+#endif // CS_MATH_CPUEXPR_H_
@@ -0,0 +1,76 @@
+/*
+ * CpuHalfMatrix.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_MATH_CPUHALFMATRIX_H_
+#define CS_MATH_CPUHALFMATRIX_H_
+
+#include <cs/cpu/cpu.h>
+#include <cs/math/CpuMatrix.h>
+#include <cs/math/CpuVector.h>
+#include <cs/math/Matrix.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace cs {
+namespace math {
+
+//A matrix stored in 16 bits, bfloat16 or IEEE half (see cpu::CpuHalf), for the large
+//inputs that are only read: half the memory and half the traffic of a CpuMatrix. The
+//kernels widen the values to fp32 when they load them, so x.affine(w, b, ans), the
+//backward of an Affine layer and sum() compute in fp32. The results are CpuMatrix.
+class CpuHalfMatrix: public Matrix {
+
+private:
+	uint16_t* arr = nullptr;
+
+public:
+
+	const cpu::CpuHalf type;
+	
+	//leading dimension, element (i, j) is ptr()[i * ld + j]
+	const size_t ld;
+	
+	CpuHalfMatrix(size_t m, size_t n, cpu::CpuHalf type, bool clear);
+	
+	//src rounded to the nearest 16 bit values
+	CpuHalfMatrix(const CpuMatrix& src, cpu::CpuHalf type);
+	CpuHalfMatrix(const CpuHalfMatrix& other);
+	CpuHalfMatrix(CpuHalfMatrix&& other);
+	
+	float get(size_t i, size_t j) const;
+	void set(size_t i, size_t j, float val);
+	
+	uint16_t* ptr() const;
+	
+	//bytes of the values
+	size_t bytes() const;
+	
+	void clear();
+	void randn();
+	float sum() const;
+	
+	//ans = this x w + b, w is (n x p) and ans is (m x p)
+	void affine(const Matrix& w, const Vector& b, Matrix& ans) const;
+	void affine(const CpuMatrix& w, const CpuVector& b, CpuMatrix& ans) const;
+	
+	//ans = this x b and ans = this^T x b when trans is set
+	void dot(const CpuMatrix& b, CpuMatrix& ans) const;
+	void dot(bool trans, const CpuMatrix& b, CpuMatrix& ans) const;
+	
+	//to a CpuMatrix (widened) or a CpuHalfMatrix (converted when the types differ)
+	void copy(Matrix& dest) const;
+	CpuMatrix to_float() const;
+	
+	void print() const;
+	
+	virtual ~CpuHalfMatrix();
+};
+
+} // namespace math
+} // namespace cs
+
+#endif // CS_MATH_CPUHALFMATRIX_H_
@@ -8,79 +8,305 @@
 #ifndef CS_MATH_CPUMATRIX_H_
 #define CS_MATH_CPUMATRIX_H_
 
+#include <cs/cpu/cpu.h>
+#include <cs/math/CpuExpr.h>
 #include <cs/math/CpuVector.h>
 #include <cs/math/Matrix.h>
+#include <cs/math/RowView.h>
 #include <stddef.h>
 
 
 namespace cs {
 namespace math {
 
-class CpuMatrix:public Matrix {
+template<typename T>
+class BasicMatrixView;
+
+class Workspace;
+
+//The base of a CPU matrix of T: the Matrix of the networks for float, only the dimensions
+//and their checks for the other element types.
+template<typename T>
+struct cpu_matrix_base {
+	typedef MatrixShape type;
+};
+
+template<>
+struct cpu_matrix_base<float> {
+	typedef Matrix type;
+};
+
+//A row major matrix of T in the CPU memory. CpuMatrix (float) is the one of the networks,
+//CpuDoubleMatrix has the same operations in double for the numerical work that needs it.
+template<typename T>
+class BasicCpuMatrix:public cpu_matrix_base<T>::type {
 	
 private:
-	float* arr;
+	typedef typename cpu_matrix_base<T>::type Base;
+	
+	T* arr = nullptr;
+	
+	//false for a view (see MatrixView), the memory belongs to another matrix
+	bool owner = true;
+	
+protected:
+	using Base::check_index;
+	using Base::assert_rows;
+	using Base::assert_cols;
+	
+	//a view over arr, it is not freed
+	BasicCpuMatrix(T* arr, size_t m, size_t n, size_t ld);
 	
 public:
+	typedef T value_type;
+	
+	using Base::m;
+	using Base::n;
+	using Base::length;
+	using Base::check_same_dimensions;
+
+	//Leading dimension, element (i, j) is ptr()[i * ld + j]. It is n unless the
+	//matrix is created with a larger one, like cpu::cpu_padded(n) to keep every
+	//row aligned. The padding is never read.
+	const size_t ld;
 
-	CpuMatrix(size_t m, size_t n);
-	CpuMatrix(size_t m, size_t n, bool clear);
-	CpuMatrix(size_t m, size_t n, float* src);
-	CpuMatrix(const CpuMatrix& other);
-	CpuMatrix(const initializer_list<const initializer_list<float>> &list);
+	BasicCpuMatrix(size_t m, size_t n);
+	BasicCpuMatrix(size_t m, size_t n, bool clear);
+	BasicCpuMatrix(size_t m, size_t n, size_t ld, bool clear);
+	BasicCpuMatrix(size_t m, size_t n, T* src);
+	
+	//placed with policy instead of cpu::cpu_memory_policy(), like large weights interleaved over the
+	//NUMA nodes on huge pages
+	BasicCpuMatrix(size_t m, size_t n, size_t ld, bool clear, const cpu::CpuMemoryPolicy& policy);
+	BasicCpuMatrix(const BasicCpuMatrix& other);
+	BasicCpuMatrix(BasicCpuMatrix&& other);
+	BasicCpuMatrix(const initializer_list<const initializer_list<T>> &list);
+	
+	//the elements of other converted to T, like CpuDoubleMatrix(a) for a CpuMatrix a
+	template<typename U>
+	explicit BasicCpuMatrix(const BasicCpuMatrix<U>& other);
+	
+	//evaluates an element wise expression (see CpuExpr.h) in a single pass
+	template<class E>
+	BasicCpuMatrix(const MatrixExpr<E, T>& e);
+	template<class E>
+	BasicCpuMatrix(MatrixExpr<E, T>&& e);
 
 	void randn();
 	void clear();
 	
-	CpuMatrix& operator=(const CpuMatrix& other);
-	float at(size_t idx)const;
-	float get(size_t i, size_t j)const;
-	void set(size_t i, size_t j, float val)const;
-	
-	void subi(const CpuMatrix& b);
-	
-	const CpuMatrix operator+(const CpuMatrix& b)const;
-	const CpuMatrix operator+(float val)const;
-	const CpuMatrix operator-(const CpuMatrix& b)const;
-	const CpuMatrix operator-(float val)const;
-	const CpuMatrix operator-()const;
-	const CpuMatrix operator*(const CpuMatrix& b)const;
-	const CpuMatrix operator*(float scalar)const;
-	const CpuMatrix operator/(const CpuMatrix& b)const;
-	const CpuMatrix operator/(float scalar)const;
-	const CpuMatrix operator^(float exp)const;
-
-	void dot(const CpuMatrix& b, CpuMatrix& ans)const;
-	const CpuMatrix dot(const CpuMatrix& b)const;
-	const CpuVector dot(const CpuVector& b) const;
-	const CpuMatrix affine(const CpuMatrix& x, const CpuVector& b)const;
+	BasicCpuMatrix& operator=(const BasicCpuMatrix& other);
+	BasicCpuMatrix& operator=(BasicCpuMatrix&& other);
+	
+	template<class E>
+	BasicCpuMatrix& operator=(const MatrixExpr<E, T>& e);
+	
+	T at(size_t idx)const;
+	T get(size_t i, size_t j)const;
+	void set(size_t i, size_t j, T val)const;
+	
+	void addi(const BasicCpuMatrix& b);
+	void subi(const BasicCpuMatrix& b);
+	void multi(const BasicCpuMatrix& b);
+	void multi(const T scalar);
+	void divi(const BasicCpuMatrix& b);
+	void divi(const T scalar);
+	void powi(const T exp);
+	
+	void dot(const BasicCpuMatrix& b, BasicCpuMatrix& ans)const;
+	BasicCpuMatrix dot(const BasicCpuMatrix& b)const;
+	
+	//this^T x b when trans is set, this x b otherwise
+	void dot(bool trans, const BasicCpuMatrix& b, BasicCpuMatrix& ans)const;
+	BasicCpuMatrix dot(bool trans, const BasicCpuMatrix& b)const;
 	
+	//this x b^T when trans is set, this x b otherwise
+	void dot(const BasicCpuMatrix& b, bool trans, BasicCpuMatrix& ans)const;
+	BasicCpuMatrix dot(const BasicCpuMatrix& b, bool trans)const;
+	
+	BasicCpuVector<T> dot(const BasicCpuVector<T>& b) const;
+	void dot(const BasicCpuVector<T>& b, BasicCpuVector<T>& ans)const;
+	
+	//this^T x b when trans is set, this x b otherwise
+	void dot(bool trans, const BasicCpuVector<T>& b, BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> dot(bool trans, const BasicCpuVector<T>& b)const;
+	
+	BasicCpuMatrix affine(const BasicCpuMatrix& x, const BasicCpuVector<T>& b)const;
+	
+	//only the float matrices are a Matrix, for the others it throws
 	void affine(const Matrix& x, const Vector& b, Matrix& ans)const;
-	void affine(const CpuMatrix& x, const CpuVector& b, CpuMatrix& ans)const;
+	void affine(const BasicCpuMatrix& x, const BasicCpuVector<T>& b, BasicCpuMatrix& ans)const;
+	
+	//ans = act(this x x + b) in a single pass over ans (see cpu_gemm_fused), and pre gets
+	//this x x + b when it is given. Only the float matrices have them, for the others it throws.
+	void affine(const BasicCpuMatrix& x, const BasicCpuVector<T>& b, cpu::CpuActivation act, BasicCpuMatrix& ans)const;
+	void affine(const BasicCpuMatrix& x, const BasicCpuVector<T>& b, cpu::CpuActivation act, BasicCpuMatrix& ans,
+			BasicCpuMatrix& pre)const;
+	
 	
 	
+	T sum()const;
+	T max()const;
+	T min()const;
+	T avg()const;
 	
-	float sum()const;
-	float max()const;
-	float min()const;
-	float avg()const;
+	//Reductions over the rows, one per column (n values), and over the
+	//columns, one per row (m values).
+	BasicCpuVector<T> sum_rows()const;
+	void sum_rows(BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> max_rows()const;
+	void max_rows(BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> min_rows()const;
+	void min_rows(BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> sum_cols()const;
+	void sum_cols(BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> max_cols()const;
+	void max_cols(BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> min_cols()const;
+	void min_cols(BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> avg_rows()const;
+	void avg_rows(BasicCpuVector<T>& ans)const;
+	BasicCpuVector<T> avg_cols()const;
+	void avg_cols(BasicCpuVector<T>& ans)const;
+	
+	//Broadcasts of a vector: the *_rows forms apply b (n values) to every row, like the
+	//bias of affine, and the *_cols forms apply b (m values) to every column.
+	void addi_rows(const BasicCpuVector<T>& b);
+	void subi_rows(const BasicCpuVector<T>& b);
+	void multi_rows(const BasicCpuVector<T>& b);
+	void divi_rows(const BasicCpuVector<T>& b);
+	void addi_cols(const BasicCpuVector<T>& b);
+	void subi_cols(const BasicCpuVector<T>& b);
+	void multi_cols(const BasicCpuVector<T>& b);
+	void divi_cols(const BasicCpuVector<T>& b);
 
+	//this^T (n x m), ans must not overlap this
+	BasicCpuMatrix transpose()const;
+	void transpose(BasicCpuMatrix& ans)const;
+	
+	//this = this^T, only for square matrices
+	void transposei();
+	
+	//only the float matrices are a Matrix, for the others it throws
 	void copy(Matrix& dest)const;
-	void copy(CpuMatrix& dest)const;
+	void copy(BasicCpuMatrix& dest)const;
+	
+	BasicCpuMatrix sltcols(size_t start, size_t end)const;
 	
-	const CpuMatrix sltcols(size_t start, size_t end)const;
+	//Views over this matrix memory, O(1) and nothing is copied: the rows [start, end),
+	//the columns [start, end), the (rows x cols) block at (i, j) and the row i.
+	BasicMatrixView<T> rows(size_t start, size_t end)const;
+	BasicMatrixView<T> cols(size_t start, size_t end)const;
+	BasicMatrixView<T> block(size_t i, size_t j, size_t rows, size_t cols)const;
+	RowView<T> row(size_t i)const;
 	
 	
-	float* ptr()const;
+	T* ptr()const;
+	
+	//true when the rows are not padded (ld == n)
+	bool contiguous()const;
 
 	void print()const;
 	
 	
 	
 	
-	virtual ~CpuMatrix();
+	virtual ~BasicCpuMatrix();
 };
 
+//A CpuMatrix over the memory of another one, like a.rows(0, 128) or a.cols(1, 15). It
+//can be used anywhere a CpuMatrix is (dot, affine, expressions, reductions) and writing
+//to it writes to the matrix, which must outlive the view. Copying a view to a CpuMatrix
+//copies the elements, copying it to a MatrixView copies the view.
+template<typename T>
+class BasicMatrixView: public BasicCpuMatrix<T> {
+	
+	friend class BasicCpuMatrix<T>;
+	friend class Workspace;
+	
+private:
+	BasicMatrixView(T* arr, size_t m, size_t n, size_t ld);
+	
+public:
+	BasicMatrixView(const BasicMatrixView& other);
+	BasicMatrixView(BasicMatrixView&& other);
+	
+	using BasicCpuMatrix<T>::operator=;
+	BasicMatrixView& operator=(const BasicMatrixView& other);
+	
+	virtual ~BasicMatrixView();
+};
+
+typedef BasicCpuMatrix<float> CpuMatrix;
+typedef BasicMatrixView<float> MatrixView;
+typedef BasicCpuMatrix<double> CpuDoubleMatrix;
+typedef BasicMatrixView<double> DoubleMatrixView;
+
+template<>
+void BasicCpuMatrix<float>::affine(const Matrix& x, const Vector& b, Matrix& ans) const;
+template<>
+void BasicCpuMatrix<float>::affine(const CpuMatrix& x, const CpuVector& b, cpu::CpuActivation act,
+		CpuMatrix& ans) const;
+template<>
+void BasicCpuMatrix<float>::affine(const CpuMatrix& x, const CpuVector& b, cpu::CpuActivation act, CpuMatrix& ans,
+		CpuMatrix& pre) const;
+template<>
+void BasicCpuMatrix<float>::copy(Matrix& dest) const;
+
+template<typename T>
+template<typename U>
+BasicCpuMatrix<T>::BasicCpuMatrix(const BasicCpuMatrix<U>& other) :
+		BasicCpuMatrix(other.m, other.n, false) {
+	const U* src = other.ptr();
+	
+	for (size_t i = 0; i < m; i++) {
+		for (size_t j = 0; j < n; j++) {
+			arr[i * ld + j] = (T) src[i * other.ld + j];
+		}
+	}
+}
+
+template<typename T>
+template<class E>
+BasicCpuMatrix<T>::BasicCpuMatrix(const MatrixExpr<E, T>& e) :
+		BasicCpuMatrix(e.self().m, e.self().n, false) {
+	e.eval_to(arr, ld);
+}
+
+//A temporary of the expression, if any, gives its memory to the result.
+template<typename T>
+template<class E>
+BasicCpuMatrix<T>::BasicCpuMatrix(MatrixExpr<E, T>&& e) :
+		Base(e.self().m, e.self().n), ld(n) {
+	E& expr = static_cast<E&>(e);
+	
+	if (expr.take(*this) == false) {
+		arr = cpu::cpu_malloc<T>(length, false);
+	}
+	
+	expr.eval_to(arr, ld);
+}
+
+template<typename T>
+template<class E>
+BasicCpuMatrix<T>& BasicCpuMatrix<T>::operator=(const MatrixExpr<E, T>& e) {
+	const E& expr = e.self();
+	
+	if (arr == nullptr) {
+		const_cast<size_t&>(m) = expr.m;
+		const_cast<size_t&>(n) = expr.n;
+		const_cast<size_t&>(length) = m * n;
+		const_cast<size_t&>(ld) = n;
+		arr = cpu::cpu_malloc<T>(length, false);
+	} else {
+		assert_rows(expr.m, m);
+		assert_cols(expr.n, n);
+	}
+	
+	e.eval_to(arr, ld);
+	return *this;
+}
+
 } // namespace math
 } // namespace cs
 
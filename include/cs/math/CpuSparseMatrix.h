@@ -0,0 +1,94 @@
+/*
+ * CpuSparseMatrix.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_MATH_CPUSPARSEMATRIX_H_
+#define CS_MATH_CPUSPARSEMATRIX_H_
+
+#include <cs/math/CpuMatrix.h>
+#include <cs/math/CpuVector.h>
+#include <cs/math/Matrix.h>
+#include <stddef.h>
+#include <vector>
+
+namespace cs {
+namespace math {
+
+//A matrix in CSR format: the nonzeros of row i are values[k] at column cols[k], for
+//rows[i] <= k < rows[i + 1]. It is meant for inputs with many one hot columns, like
+//Grid::toSparseMatrix, where x.affine(w, b, ans) and the backward of an Affine layer only
+//read the rows of w of the active features.
+class CpuSparseMatrix: public Matrix {
+
+private:
+	//m + 1 offsets into cols and values
+	std::vector<size_t> rows;
+	std::vector<size_t> cols;
+	std::vector<float> values;
+	
+	//this^T in CSR for this^T x b, built on first use (the inputs of a network are
+	//multiplied every step) and dropped when the values change
+	mutable std::vector<size_t> tRows;
+	mutable std::vector<size_t> tCols;
+	mutable std::vector<float> tValues;
+	
+	//bytes of the vectors counted as data by the memory tracker, recounted when they change
+	mutable size_t tracked = 0;
+	void track() const;
+	
+	void check_format() const;
+	void build_transpose() const;
+	void drop_transpose();
+
+public:
+
+	CpuSparseMatrix(size_t m, size_t n, std::vector<size_t>&& rows, std::vector<size_t>&& cols,
+			std::vector<float>&& values);
+	
+	//the nonzeros of dense
+	CpuSparseMatrix(const CpuMatrix& dense);
+	
+	//a copy counts its own bytes, the destructor of each one releases them
+	CpuSparseMatrix(const CpuSparseMatrix& other);
+	
+	//number of stored values
+	size_t nnz() const;
+	
+	//bytes of the values and the indices
+	size_t bytes() const;
+	
+	size_t* row_ptr() const;
+	size_t* col_ptr() const;
+	float* val_ptr() const;
+	
+	//removes every stored value
+	void clear();
+	
+	//ans = this x w + b, w is (n x p) and ans is (m x p)
+	void affine(const Matrix& w, const Vector& b, Matrix& ans) const;
+	void affine(const CpuMatrix& w, const CpuVector& b, CpuMatrix& ans) const;
+	
+	//ans = this x b and ans = this^T x b when trans is set
+	void dot(const CpuMatrix& b, CpuMatrix& ans) const;
+	void dot(bool trans, const CpuMatrix& b, CpuMatrix& ans) const;
+	
+	//random values for the stored entries, the zeros stay zeros
+	void randn();
+	float sum() const;
+	
+	//to a CpuMatrix (densified) or another CpuSparseMatrix
+	void copy(Matrix& dest) const;
+	CpuMatrix to_dense() const;
+	
+	void print() const;
+	
+	virtual ~CpuSparseMatrix();
+};
+
+} // namespace math
+} // namespace cs
+
+#endif // CS_MATH_CPUSPARSEMATRIX_H_
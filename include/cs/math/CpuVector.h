@@ -10,6 +10,8 @@
 
 #include <stdlib.h>
 #include <initializer_list>
+#include <cs/cpu/cpu.h>
+#include <cs/math/CpuExpr.h>
 #include <cs/math/Vector.h>
 
 using namespace std;
@@ -18,55 +20,146 @@ namespace cs{
 namespace math{
 
 
-class CpuVector:public Vector {
+//The base of a CPU vector of T: the Vector of the networks for float, only the length
+//and its checks for the other element types.
+template<typename T>
+struct cpu_vector_base {
+	typedef VectorShape type;
+};
+
+template<>
+struct cpu_vector_base<float> {
+	typedef Vector type;
+};
+
+template<typename T>
+class BasicCpuVector:public cpu_vector_base<T>::type {
 
 private:
-	float* arr;
+	typedef typename cpu_vector_base<T>::type Base;
 	
+	T* arr = nullptr;
 	
+protected:
+	using Base::check_index;
+	using Base::check_same_length;
 
 public:
+	typedef T value_type;
 
-	CpuVector(size_t length);
-	CpuVector(size_t length, bool clear);
-	CpuVector(const CpuVector& other);
-	CpuVector(const initializer_list<float> &list);
+	using Base::length;
+	
+	BasicCpuVector(size_t length);
+	BasicCpuVector(size_t length, bool clear);
+	BasicCpuVector(const BasicCpuVector& other);
+	BasicCpuVector(BasicCpuVector&& other);
+	BasicCpuVector(const initializer_list<T> &list);
+	
+	//the values of other converted to T, like CpuDoubleVector(v) for a CpuVector v
+	template<typename U>
+	explicit BasicCpuVector(const BasicCpuVector<U>& other);
+	
+	//evaluates an element wise expression (see CpuExpr.h) in a single pass
+	template<class E>
+	BasicCpuVector(const VectorExpr<E, T>& e);
+	template<class E>
+	BasicCpuVector(VectorExpr<E, T>&& e);
 
 	void randn();
 	void clear();
 	
-	CpuVector& operator=(const CpuVector& other);
-	float operator[](size_t idx)const;
-	float& operator[](size_t idx);
-	
-	const CpuVector operator+(const CpuVector& b)const;
-	const CpuVector operator+(float val)const;
-	const CpuVector operator-(const CpuVector& b)const;
-	const CpuVector operator-(float val)const;
-	const CpuVector operator-()const;
-	const CpuVector operator*(const CpuVector& b)const;
-	const CpuVector operator*(float scalar)const;
-	const CpuVector operator/(const CpuVector& b)const;
-	const CpuVector operator/(float scalar)const;
-	const CpuVector operator^(float exp)const;
+	BasicCpuVector& operator=(const BasicCpuVector& other);
+	BasicCpuVector& operator=(BasicCpuVector&& other);
+	T operator[](size_t idx)const;
+	T& operator[](size_t idx);
+	
+	template<class E>
+	BasicCpuVector& operator=(const VectorExpr<E, T>& e);
+	
+	void addi(const BasicCpuVector& b);
+	void subi(const BasicCpuVector& b);
+	void multi(const BasicCpuVector& b);
+	void multi(const T scalar);
+	void divi(const BasicCpuVector& b);
+	void divi(const T scalar);
+	void powi(const T exp);
+	
 		
-	float sum()const;
-	float max()const;
-	float min()const;
-	float avg()const;
-	float var()const;
-	float stdev()const;
-	
-	float dot(const CpuVector b)const;
+	T sum()const;
+	T max()const;
+	T min()const;
+	T avg()const;
+	T var()const;
+	T stdev()const;
+	
+	T dot(const BasicCpuVector& b)const;
+	
+	//only the float vectors are a Vector, for the others it throws
 	void copy(Vector& dest)const;
-	void copy(CpuVector& dest)const;
+	void copy(BasicCpuVector& dest)const;
 	
 	
-	float* ptr()const;
+	T* ptr()const;
 
 	void print()const;
-	virtual ~CpuVector();
+	virtual ~BasicCpuVector();
 };
+
+typedef BasicCpuVector<float> CpuVector;
+typedef BasicCpuVector<double> CpuDoubleVector;
+
+template<>
+void BasicCpuVector<float>::copy(Vector& dest) const;
+
+template<typename T>
+template<typename U>
+BasicCpuVector<T>::BasicCpuVector(const BasicCpuVector<U>& other) :
+		BasicCpuVector(other.length, false) {
+	const U* src = other.ptr();
+	
+	for (size_t i = 0; i < length; i++) {
+		arr[i] = (T) src[i];
+	}
+}
+
+template<typename T>
+template<class E>
+BasicCpuVector<T>::BasicCpuVector(const VectorExpr<E, T>& e) :
+		BasicCpuVector(e.self().length, false) {
+	e.eval_to(arr);
+}
+
+//A temporary of the expression, if any, gives its memory to the result.
+template<typename T>
+template<class E>
+BasicCpuVector<T>::BasicCpuVector(VectorExpr<E, T>&& e) :
+		Base(e.self().length) {
+	E& expr = static_cast<E&>(e);
+	
+	if (expr.take(*this) == false) {
+		arr = cpu::cpu_malloc<T>(length, false);
+	}
+	
+	expr.eval_to(arr);
+}
+
+template<typename T>
+template<class E>
+BasicCpuVector<T>& BasicCpuVector<T>::operator=(const VectorExpr<E, T>& e) {
+	const E& expr = e.self();
+	
+	if (arr == nullptr) {
+		const_cast<size_t&>(length) = expr.length;
+		arr = cpu::cpu_malloc<T>(length, false);
+	} else if (expr.length != length) {
+		throw core::Exception(
+				"The length must be the same. Expected " + to_string(length) + ", but got: " + to_string(expr.length)
+						+ " instead.");
+	}
+	
+	e.eval_to(arr);
+	return *this;
+}
 } // namespace math
 } // namespace cs
 #endif // CS_MATH_CPUVECTOR_H_
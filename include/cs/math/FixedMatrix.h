@@ -0,0 +1,232 @@
+/*
+ * FixedMatrix.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_MATH_FIXEDMATRIX_H_
+#define CS_MATH_FIXEDMATRIX_H_
+
+#include <cs/core/Exception.h>
+#include <cs/math/CpuMatrix.h>
+#include <cs/math/FixedVector.h>
+#include <stddef.h>
+#include <initializer_list>
+#include <string>
+
+namespace cs {
+namespace math {
+
+//Largest number of columns of the products that is unrolled, above it the loops
+//are left to the compiler.
+const size_t FIXED_UNROLL_MAX = 16;
+
+//c[j] += s * b[j] for j < P, the update of a row of a product. It is written out one
+//column at a time up to FIXED_UNROLL_MAX columns.
+template<typename T, size_t P, bool unroll = (P <= FIXED_UNROLL_MAX)>
+struct FixedRowKernel {
+	
+	struct Column {
+		T* c;
+		T s;
+		const T* b;
+		
+		inline void operator()(size_t j) {
+			c[j] += s * b[j];
+		}
+	};
+	
+	static inline void run(T* c, T s, const T* b) {
+		Column f = { c, s, b };
+		FixedUnroll<0, P>::run(f);
+	}
+};
+
+template<typename T, size_t P>
+struct FixedRowKernel<T, P, false> {
+	
+	static inline void run(T* c, T s, const T* b) {
+		for (size_t j = 0; j < P; j++) {
+			c[j] += s * b[j];
+		}
+	}
+};
+
+//A row major (M x N) matrix of T with the dimensions known at compile time, for the
+//layers of a few units (like 4x8 or 8x3), where the allocation, the virtual calls and
+//the runtime bounds of a CpuMatrix cost more than the products. Same storage rules as
+//FixedVector, and the dimensions of every operation are checked by the compiler.
+template<typename T, size_t M, size_t N>
+class FixedMatrix {
+	
+	static_assert(M > 0 && N > 0, "A FixedMatrix must have at least one row and one column.");
+	
+	template<typename U, size_t A, size_t B>
+	friend class FixedMatrix;
+	
+private:
+	T arr[M * N];
+	
+public:
+	typedef T value_type;
+	
+	static const size_t m = M;
+	static const size_t n = N;
+	static const size_t length = M * N;
+	
+	//all the elements are 0
+	FixedMatrix() :
+			arr() {
+	}
+	
+	FixedMatrix(const initializer_list<const initializer_list<T>> &list) :
+			arr() {
+		if (list.size() != M) {
+			throw core::Exception("The list has " + to_string(list.size()) + " rows, expected " + to_string(M) + ".");
+		}
+		
+		const initializer_list<T>* rows = list.begin();
+		for (size_t i = 0; i < M; i++) {
+			if (rows[i].size() != N) {
+				throw core::Exception(
+						"The row " + to_string(i) + " of the list has " + to_string(rows[i].size())
+								+ " columns, expected " + to_string(N) + ".");
+			}
+			
+			const T* row = rows[i].begin();
+			for (size_t j = 0; j < N; j++) {
+				arr[i * N + j] = row[j];
+			}
+		}
+	}
+	
+	explicit FixedMatrix(const BasicCpuMatrix<T>& a) {
+		if (a.m != M || a.n != N) {
+			throw core::Exception(
+					"The matrix is " + to_string(a.m) + "x" + to_string(a.n) + ", expected " + to_string(M) + "x"
+							+ to_string(N) + ".");
+		}
+		
+		const T* src = a.ptr();
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < N; j++) {
+				arr[i * N + j] = src[i * a.ld + j];
+			}
+		}
+	}
+	
+	//not checked, like the element access of FixedVector
+	T get(size_t i, size_t j) const {
+		return arr[i * N + j];
+	}
+	
+	void set(size_t i, size_t j, T val) {
+		arr[i * N + j] = val;
+	}
+	
+	//ans = this x b, where b is (N x P). Each row is summed in a local array, which can
+	//not alias b, so it stays in registers.
+	template<size_t P>
+	void dot(const FixedMatrix<T, N, P>& b, FixedMatrix<T, M, P>& ans) const {
+		for (size_t i = 0; i < M; i++) {
+			T c[P] = { };
+			
+			const T* a = arr + i * N;
+			for (size_t k = 0; k < N; k++) {
+				FixedRowKernel<T, P>::run(c, a[k], b.arr + k * P);
+			}
+			
+			for (size_t j = 0; j < P; j++) {
+				ans.arr[i * P + j] = c[j];
+			}
+		}
+	}
+	
+	template<size_t P>
+	FixedMatrix<T, M, P> dot(const FixedMatrix<T, N, P>& b) const {
+		FixedMatrix<T, M, P> ans;
+		dot(b, ans);
+		return ans;
+	}
+	
+	//ans = this x b
+	void dot(const FixedVector<T, N>& b, FixedVector<T, M>& ans) const {
+		for (size_t i = 0; i < M; i++) {
+			const T* a = arr + i * N;
+			T s = 0;
+			for (size_t k = 0; k < N; k++) {
+				s += a[k] * b[k];
+			}
+			ans[i] = s;
+		}
+	}
+	
+	//ans = this x w + b, where every row of this is an input of the layer, like CpuMatrix::affine
+	template<size_t P>
+	void affine(const FixedMatrix<T, N, P>& w, const FixedVector<T, P>& b, FixedMatrix<T, M, P>& ans) const {
+		for (size_t i = 0; i < M; i++) {
+			T c[P];
+			for (size_t j = 0; j < P; j++) {
+				c[j] = b[j];
+			}
+			
+			const T* a = arr + i * N;
+			for (size_t k = 0; k < N; k++) {
+				FixedRowKernel<T, P>::run(c, a[k], w.arr + k * P);
+			}
+			
+			for (size_t j = 0; j < P; j++) {
+				ans.arr[i * P + j] = c[j];
+			}
+		}
+	}
+	
+	template<size_t P>
+	FixedMatrix<T, M, P> affine(const FixedMatrix<T, N, P>& w, const FixedVector<T, P>& b) const {
+		FixedMatrix<T, M, P> ans;
+		affine(w, b, ans);
+		return ans;
+	}
+	
+	FixedMatrix<T, N, M> transpose() const {
+		FixedMatrix<T, N, M> ans;
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < N; j++) {
+				ans.arr[j * M + i] = arr[i * N + j];
+			}
+		}
+		return ans;
+	}
+	
+	BasicCpuMatrix<T> to_cpu() const {
+		BasicCpuMatrix<T> ans = BasicCpuMatrix<T>(M, N, false);
+		T* dest = ans.ptr();
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < N; j++) {
+				dest[i * ans.ld + j] = arr[i * N + j];
+			}
+		}
+		return ans;
+	}
+	
+	const T* ptr() const {
+		return arr;
+	}
+	
+	T* ptr() {
+		return arr;
+	}
+};
+
+template<typename T, size_t M, size_t N>
+const size_t FixedMatrix<T, M, N>::m;
+template<typename T, size_t M, size_t N>
+const size_t FixedMatrix<T, M, N>::n;
+template<typename T, size_t M, size_t N>
+const size_t FixedMatrix<T, M, N>::length;
+
+} // namespace math
+} // namespace cs
+
+#endif // CS_MATH_FIXEDMATRIX_H_
@@ -0,0 +1,125 @@
+/*
+ * FixedVector.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_MATH_FIXEDVECTOR_H_
+#define CS_MATH_FIXEDVECTOR_H_
+
+#include <cs/core/Exception.h>
+#include <cs/math/CpuVector.h>
+#include <stddef.h>
+#include <initializer_list>
+#include <string>
+
+namespace cs {
+namespace math {
+
+//Calls f(I), f(I + 1), ..., f(N - 1), unrolled at compile time. The fixed size
+//kernels use it for the dimensions that are small enough to be written out.
+template<size_t I, size_t N>
+struct FixedUnroll {
+	template<class F>
+	static inline void run(F& f) {
+		f(I);
+		FixedUnroll<I + 1, N>::run(f);
+	}
+};
+
+template<size_t N>
+struct FixedUnroll<N, N> {
+	template<class F>
+	static inline void run(F& f) {
+	}
+};
+
+//A vector of N values of T whose length is known at compile time, for the tiny
+//layers of the networks. The values are stored inside the object (on the stack for
+//a local one), so it is never allocated and its loops have constant bounds.
+template<typename T, size_t N>
+class FixedVector {
+	
+	static_assert(N > 0, "A FixedVector must have at least one value.");
+	
+private:
+	T arr[N];
+	
+public:
+	typedef T value_type;
+	
+	static const size_t length = N;
+	
+	//all the values are 0
+	FixedVector() :
+			arr() {
+	}
+	
+	FixedVector(const initializer_list<T> &list) :
+			arr() {
+		if (list.size() != N) {
+			throw core::Exception(
+					"The list has " + to_string(list.size()) + " values, expected " + to_string(N) + ".");
+		}
+		
+		const T* start = list.begin();
+		for (size_t i = 0; i < N; i++) {
+			arr[i] = start[i];
+		}
+	}
+	
+	explicit FixedVector(const BasicCpuVector<T>& v) {
+		if (v.length != N) {
+			throw core::Exception(
+					"The vector has " + to_string(v.length) + " values, expected " + to_string(N) + ".");
+		}
+		
+		const T* src = v.ptr();
+		for (size_t i = 0; i < N; i++) {
+			arr[i] = src[i];
+		}
+	}
+	
+	//not checked, the sizes are checked once when the values come from a CpuVector
+	T operator[](size_t idx) const {
+		return arr[idx];
+	}
+	
+	T& operator[](size_t idx) {
+		return arr[idx];
+	}
+	
+	T dot(const FixedVector& b) const {
+		T ans = 0;
+		for (size_t i = 0; i < N; i++) {
+			ans += arr[i] * b.arr[i];
+		}
+		return ans;
+	}
+	
+	BasicCpuVector<T> to_cpu() const {
+		BasicCpuVector<T> ans = BasicCpuVector<T>(N, false);
+		T* dest = ans.ptr();
+		for (size_t i = 0; i < N; i++) {
+			dest[i] = arr[i];
+		}
+		return ans;
+	}
+	
+	const T* ptr() const {
+		return arr;
+	}
+	
+	T* ptr() {
+		return arr;
+	}
+};
+
+template<typename T, size_t N>
+const size_t FixedVector<T, N>::length;
+
+} // namespace math
+} // namespace cs
+
+#endif // CS_MATH_FIXEDVECTOR_H_
@@ -17,28 +17,30 @@ namespace math {
 
 class GpuMatrix: public Matrix {
 private:
-	float* devPtr;
+	float* devPtr = nullptr;
 
 public:
 	GpuMatrix(size_t m, size_t n);
 	GpuMatrix(size_t m, size_t n, bool clear);
 	GpuMatrix(const CpuMatrix& other);
 	GpuMatrix(const GpuMatrix& other);
+	GpuMatrix(GpuMatrix&& other);
 	GpuMatrix(const initializer_list<const initializer_list<float>> &list);
 
 	GpuMatrix& operator=(const GpuMatrix& other);
+	GpuMatrix& operator=(GpuMatrix&& other);
 
 	void clear();
 	void randn();
 	
-	const GpuMatrix operator+(const GpuMatrix& b) const;
-	const GpuMatrix operator-(const GpuMatrix& b) const;
-	const GpuMatrix operator-() const;
-	const GpuMatrix operator*(const GpuMatrix& b) const;
-	const GpuMatrix operator*(const float scalar) const;
-	const GpuMatrix operator/(const GpuMatrix& b) const;
-	const GpuMatrix operator/(const float scalar) const;
-	const GpuMatrix operator^(const float exp) const;
+	GpuMatrix operator+(const GpuMatrix& b) const;
+	GpuMatrix operator-(const GpuMatrix& b) const;
+	GpuMatrix operator-() const;
+	GpuMatrix operator*(const GpuMatrix& b) const;
+	GpuMatrix operator*(const float scalar) const;
+	GpuMatrix operator/(const GpuMatrix& b) const;
+	GpuMatrix operator/(const float scalar) const;
+	GpuMatrix operator^(const float exp) const;
 
 	void addi(const GpuMatrix& b);
 	void subi(const GpuMatrix& b);
@@ -48,11 +50,11 @@ public:
 	void divi(const float scalar);
 	void powi(const float exp);
 
-	const GpuMatrix dot(const GpuMatrix& b) const;
+	GpuMatrix dot(const GpuMatrix& b) const;
 	void dot(const GpuMatrix& b, GpuMatrix& ans)const;
 	
-	const GpuVector dot(const GpuVector& b) const;
-	const GpuMatrix affine(const GpuMatrix& x, const GpuVector& b)const;
+	GpuVector dot(const GpuVector& b) const;
+	GpuMatrix affine(const GpuMatrix& x, const GpuVector& b)const;
 	
 	void affine(const Matrix& x, const Vector& b, Matrix& ans)const;
 	void affine(const GpuMatrix& x, const GpuVector& b, GpuMatrix& ans) const;
@@ -63,7 +65,7 @@ public:
 
 	bool equals(const GpuMatrix& other, float e);
 	void copy(Matrix& dest)const;
-	const CpuMatrix cpu() const;
+	CpuMatrix cpu() const;
 	float* ptr() const;
 	virtual void print() const;
 
@@ -19,7 +19,7 @@ namespace math {
 class GpuVector:public Vector {
 	
 private:
-	float* devPtr;
+	float* devPtr = nullptr;
 	void check_same_length(const GpuVector& b)const;
 
 public:
@@ -28,23 +28,25 @@ public:
 	GpuVector(size_t length, bool clear);
 	GpuVector(const CpuVector& other);
 	GpuVector(const GpuVector& other);
+	GpuVector(GpuVector&& other);
 	GpuVector(const initializer_list<float> &list);
 
 	void randn();
 	void clear();
 	
 	GpuVector& operator=(const GpuVector& other);
+	GpuVector& operator=(GpuVector&& other);
 
-	const GpuVector operator+(const GpuVector& b) const;
-	const GpuVector operator+(const float val) const;
-	const GpuVector operator-(const GpuVector& b) const;
-	const GpuVector operator-(const float val) const;
-	const GpuVector operator-() const;
-	const GpuVector operator*(const GpuVector& b) const;
-	const GpuVector operator*(const float scalar) const;
-	const GpuVector operator/(const GpuVector& b) const;
-	const GpuVector operator/(const float scalar) const;
-	const GpuVector operator^(const float exp) const;
+	GpuVector operator+(const GpuVector& b) const;
+	GpuVector operator+(const float val) const;
+	GpuVector operator-(const GpuVector& b) const;
+	GpuVector operator-(const float val) const;
+	GpuVector operator-() const;
+	GpuVector operator*(const GpuVector& b) const;
+	GpuVector operator*(const float scalar) const;
+	GpuVector operator/(const GpuVector& b) const;
+	GpuVector operator/(const float scalar) const;
+	GpuVector operator^(const float exp) const;
 
 	void addi(const GpuVector& b);
 	void subi(const GpuVector& b);
@@ -59,7 +61,7 @@ public:
 	void copy(Vector& dest)const;
 	void copy(GpuVector& dest)const;
 	
-	const CpuVector cpu() const;
+	CpuVector cpu() const;
 	
 	float* ptr() const;
 	void print() const;
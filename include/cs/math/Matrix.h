@@ -14,7 +14,8 @@
 namespace cs {
 namespace math {
 
-class Matrix {
+//The dimensions of a matrix and their checks, shared by the matrices of every element type.
+class MatrixShape {
 	
 protected:
 	void check_dimensions() const;
@@ -29,9 +30,16 @@ public:
 	const size_t n;
 	const size_t length;
 	
-	Matrix(size_t m, size_t n);
+	MatrixShape(size_t m, size_t n);
+	
+	void check_same_dimensions(const MatrixShape& other) const;
+};
+
+//The float matrices of the networks, on the CPU or on the GPU.
+class Matrix: public MatrixShape {
 	
-	void check_same_dimensions(const Matrix& other) const;
+public:
+	Matrix(size_t m, size_t n);
 	
 	virtual void clear()=0;
 	virtual void affine(const Matrix& x, const Vector& b, Matrix& ans)const=0;
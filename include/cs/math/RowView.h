@@ -14,12 +14,23 @@
 namespace cs {
 namespace math {
 
+//A row of a matrix over the matrix memory, nothing is copied. The matrix must
+//outlive the view.
 template<typename T>
 class RowView {
+	
+private:
+	T* arr;
+	
 public:
-	RowView();
+	const size_t length;
+	
+	RowView(T* arr, size_t length);
 	
 	const T& operator[](size_t idx)const;
+	T& operator[](size_t idx);
+	
+	T* ptr()const;
 	
 	virtual ~RowView();
 };
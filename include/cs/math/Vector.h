@@ -13,15 +13,23 @@
 namespace cs {
 namespace math {
 
-class Vector {
+//The length of a vector and its checks, shared by the vectors of every element type.
+class VectorShape {
 protected:
 	
 	void check_index(size_t idx) const;
-	void check_same_length(const Vector& other) const;
+	void check_same_length(const VectorShape& other) const;
 
 public:
 	
 	const size_t length;
+	
+	VectorShape(size_t length);
+};
+
+//The float vectors of the networks, on the CPU or on the GPU.
+class Vector: public VectorShape {
+public:
 
 	Vector(size_t length);
 
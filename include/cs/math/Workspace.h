@@ -0,0 +1,72 @@
+/*
+ * Workspace.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_MATH_WORKSPACE_H_
+#define CS_MATH_WORKSPACE_H_
+
+#include <cs/math/CpuMatrix.h>
+#include <stddef.h>
+#include <vector>
+
+namespace cs {
+namespace math {
+
+//A bump allocator for the matrices of one step (a forward and a backward): take() hands out
+//CPU_ALIGNMENT aligned memory in O(1) and reset() gives all of it back in O(1). The memory
+//comes from cpu_malloc in blocks, a step that needs more than the current block adds another
+//one, and the next reset() replaces them with a single block of their total size. After the
+//first steps (the warm up) a step does not allocate anymore.
+//
+//The memory taken before a reset must not be used after it. It is not thread safe, the owner
+//of the step takes and resets.
+class Workspace {
+	
+private:
+	struct Block {
+		float* arr;
+		size_t capacity;
+	};
+	
+	//the last one is the current block, used floats of it are taken
+	std::vector<Block> blocks;
+	size_t used = 0;
+	
+	//floats taken since the last reset (with the alignment), and the most of any step
+	size_t taken = 0;
+	size_t peak = 0;
+	
+	void add_block(size_t capacity);
+	
+public:
+	Workspace();
+	
+	//starts with a block of capacity floats
+	Workspace(size_t capacity);
+	
+	Workspace(const Workspace& other) = delete;
+	Workspace& operator=(const Workspace& other) = delete;
+	
+	//length floats at a CPU_ALIGNMENT boundary, not cleared
+	float* take(size_t length);
+	
+	//A compact (m x n) matrix over the workspace memory, the view itself is also stored in it.
+	//It can be the destination of the expressions and of the destination passing operations.
+	MatrixView& matrix(size_t m, size_t n);
+	
+	void reset();
+	
+	//floats of the blocks, and the most floats taken between two resets
+	size_t capacity() const;
+	size_t high_water() const;
+	
+	virtual ~Workspace();
+};
+
+} // namespace math
+} // namespace cs
+
+#endif // CS_MATH_WORKSPACE_H_
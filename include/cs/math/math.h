@@ -47,18 +47,110 @@ const GpuMatrix& gpu_cast(const Matrix* m);
 const GpuVector& gpu_cast(const Vector& m);
 const GpuVector& gpu_cast(const Vector* m);
 
-const CpuMatrix randn(size_t m, size_t n);
-const CpuVector randn(size_t length);
+CpuMatrix randn(size_t m, size_t n);
+CpuVector randn(size_t length);
 void randn(float* arr, size_t length);
+void randn(double* arr, size_t length);
 double grandn(double mu, double sigma);
 
 float sum(const Matrix& m);
 
-const CpuVector operator*(float scalar, const CpuVector& a);
-const CpuMatrix operator*(float scalar, const CpuMatrix& a);
-
-const GpuVector operator*(float scalar, const GpuVector& a);
-const GpuMatrix operator*(float scalar, const GpuMatrix& a);
+//Destination passing arithmetic: the result is written into ans, which must
+//have the right dimensions, so nothing is allocated. ans may be one of the operands.
+//divide and power are not div and pow, which would hide ::div and std::pow in cs::math.
+//The scalar is the element type of the matrix, it is not deduced, so add(a, 1, ans) is valid.
+template<typename T>
+void add(const BasicCpuMatrix<T>& a, const BasicCpuMatrix<T>& b, BasicCpuMatrix<T>& ans) {
+	ans = a + b;
+}
+
+template<typename T>
+void add(const BasicCpuMatrix<T>& a, typename BasicCpuMatrix<T>::value_type val, BasicCpuMatrix<T>& ans) {
+	ans = a + val;
+}
+
+template<typename T>
+void sub(const BasicCpuMatrix<T>& a, const BasicCpuMatrix<T>& b, BasicCpuMatrix<T>& ans) {
+	ans = a - b;
+}
+
+template<typename T>
+void sub(const BasicCpuMatrix<T>& a, typename BasicCpuMatrix<T>::value_type val, BasicCpuMatrix<T>& ans) {
+	ans = a - val;
+}
+
+template<typename T>
+void mult(const BasicCpuMatrix<T>& a, const BasicCpuMatrix<T>& b, BasicCpuMatrix<T>& ans) {
+	ans = a * b;
+}
+
+template<typename T>
+void mult(const BasicCpuMatrix<T>& a, typename BasicCpuMatrix<T>::value_type scalar, BasicCpuMatrix<T>& ans) {
+	ans = a * scalar;
+}
+
+template<typename T>
+void divide(const BasicCpuMatrix<T>& a, const BasicCpuMatrix<T>& b, BasicCpuMatrix<T>& ans) {
+	ans = a / b;
+}
+
+template<typename T>
+void divide(const BasicCpuMatrix<T>& a, typename BasicCpuMatrix<T>::value_type scalar, BasicCpuMatrix<T>& ans) {
+	ans = a / scalar;
+}
+
+template<typename T>
+void power(const BasicCpuMatrix<T>& a, typename BasicCpuMatrix<T>::value_type exp, BasicCpuMatrix<T>& ans) {
+	ans = a ^ exp;
+}
+
+template<typename T>
+void add(const BasicCpuVector<T>& a, const BasicCpuVector<T>& b, BasicCpuVector<T>& ans) {
+	ans = a + b;
+}
+
+template<typename T>
+void add(const BasicCpuVector<T>& a, typename BasicCpuVector<T>::value_type val, BasicCpuVector<T>& ans) {
+	ans = a + val;
+}
+
+template<typename T>
+void sub(const BasicCpuVector<T>& a, const BasicCpuVector<T>& b, BasicCpuVector<T>& ans) {
+	ans = a - b;
+}
+
+template<typename T>
+void sub(const BasicCpuVector<T>& a, typename BasicCpuVector<T>::value_type val, BasicCpuVector<T>& ans) {
+	ans = a - val;
+}
+
+template<typename T>
+void mult(const BasicCpuVector<T>& a, const BasicCpuVector<T>& b, BasicCpuVector<T>& ans) {
+	ans = a * b;
+}
+
+template<typename T>
+void mult(const BasicCpuVector<T>& a, typename BasicCpuVector<T>::value_type scalar, BasicCpuVector<T>& ans) {
+	ans = a * scalar;
+}
+
+template<typename T>
+void divide(const BasicCpuVector<T>& a, const BasicCpuVector<T>& b, BasicCpuVector<T>& ans) {
+	ans = a / b;
+}
+
+template<typename T>
+void divide(const BasicCpuVector<T>& a, typename BasicCpuVector<T>::value_type scalar, BasicCpuVector<T>& ans) {
+	ans = a / scalar;
+}
+
+template<typename T>
+void power(const BasicCpuVector<T>& a, typename BasicCpuVector<T>::value_type exp, BasicCpuVector<T>& ans) {
+	ans = a ^ exp;
+}
+
+GpuVector operator*(float scalar, const GpuVector& a);
+GpuMatrix operator*(float scalar, const GpuMatrix& a);
 
 
 } // namespace math
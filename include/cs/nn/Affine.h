@@ -12,6 +12,7 @@
 #include <cs/math/GpuMatrix.h>
 #include <cs/math/Vector.h>
 #include <cs/nn/Layer.h>
+#include <cs/nn/Sigmoid.h>
 
 namespace cs {
 using namespace math;
@@ -46,11 +47,20 @@ public:
 	void set_weights(const Matrix& weights);
 	void set_bias(const Vector& bias);
 	
+	const Matrix& get_weights() const;
+	const Vector& get_bias() const;
+	
 	
 	
 	Matrix& foward(const Matrix& x);
 	Matrix& backward(const Matrix& dg);
 
+	//The foward of this layer and of the sigmoid after it, which returns the fx of the sigmoid.
+	//On the CPU the sigmoid is applied to the tiles of the product, so its fx is written once
+	//and the fx of this layer is not computed (the sigmoid backward only needs its own fx).
+	//On the GPU, and for sparse or 16 bit inputs, they run one after the other.
+	Matrix& foward(const Matrix& x, Sigmoid& activation);
+
 	void update(float alpha);
 
 	void print()const;
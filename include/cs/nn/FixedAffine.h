@@ -0,0 +1,67 @@
+/*
+ * FixedAffine.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_NN_FIXEDAFFINE_H_
+#define CS_NN_FIXEDAFFINE_H_
+
+#include <cs/math/FixedMatrix.h>
+#include <cs/math/FixedVector.h>
+#include <cs/math/math.h>
+#include <cs/nn/Affine.h>
+#include <stddef.h>
+
+namespace cs {
+using namespace math;
+namespace nn {
+
+//An Affine layer of In inputs and Out outputs fixed at compile time, for the inference of
+//the tiny networks one sample (or a few) at a time: fx = x W + b with the weights inside the
+//object and no allocation or virtual call. It is built from a trained Affine layer.
+template<typename T, size_t In, size_t Out>
+class FixedAffine {
+	
+private:
+	FixedMatrix<T, In, Out> w;
+	FixedVector<T, Out> b;
+	
+public:
+	FixedAffine() {
+	}
+	
+	FixedAffine(const FixedMatrix<T, In, Out>& w, const FixedVector<T, Out>& b) :
+			w(w), b(b) {
+	}
+	
+	//the weights of a CPU Affine layer, the dimensions must be In x Out
+	explicit FixedAffine(const Affine& layer) :
+			w(BasicCpuMatrix<T>(cpu_cast(layer.get_weights()))), b(BasicCpuVector<T>(cpu_cast(layer.get_bias()))) {
+	}
+	
+	//every row of x is a sample
+	template<size_t M>
+	void foward(const FixedMatrix<T, M, In>& x, FixedMatrix<T, M, Out>& fx) const {
+		x.affine(w, b, fx);
+	}
+	
+	template<size_t M>
+	FixedMatrix<T, M, Out> foward(const FixedMatrix<T, M, In>& x) const {
+		return x.affine(w, b);
+	}
+	
+	const FixedMatrix<T, In, Out>& get_weights() const {
+		return w;
+	}
+	
+	const FixedVector<T, Out>& get_bias() const {
+		return b;
+	}
+};
+
+} // namespace nn
+} // namespace cs
+
+#endif // CS_NN_FIXEDAFFINE_H_
@@ -0,0 +1,95 @@
+/*
+ * FixedSigmoid.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_NN_FIXEDSIGMOID_H_
+#define CS_NN_FIXEDSIGMOID_H_
+
+#include <cs/math/FixedMatrix.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+
+namespace cs {
+using namespace math;
+namespace nn {
+
+//exp(x) with the Cephes expf algorithm of cpu_exp (see vmath.cpp), inline and without
+//branches so the loops of the fixed layers are vectorized instead of calling expf.
+inline float fixed_exp(float x) {
+	//|x| <= 87.33, clamped on the bits (the order of the magnitudes is the order of
+	//their bits) because an integer min has no branch. k stays in [-126, 126], so 2^k is
+	//a normal float: exp saturates at 8.5e37 above 87.33 and at 1.2e-38 below -87.33,
+	//never inf or 0, the sigmoid is within 1.2e-38 of 1 or 0 there
+	const int32_t maxBits = 0x42AEA8F6;
+	int32_t bits;
+	memcpy(&bits, &x, sizeof(float));
+	int32_t mag = bits & 0x7FFFFFFF;
+	
+	//all ones for NaN, the clamp would turn it into 87.33
+	const int32_t nan = -(int32_t) (mag > 0x7F800000);
+	const int32_t nanBits = bits;
+	bits = (bits & ~0x7FFFFFFF) | (mag < maxBits ? mag : maxBits);
+	memcpy(&x, &bits, sizeof(float));
+	
+	//x = k ln2 + r, k = round(x / ln2) by truncation of a positive value
+	int32_t k = (int32_t) (x * 1.44269504088896341f + 128.5f) - 128;
+	float fk = (float) k;
+	float r = x - fk * 0.693359375f + fk * 2.12194440e-4f;
+	
+	float p = 1.9875691500E-4f;
+	p = p * r + 1.3981999507E-3f;
+	p = p * r + 8.3334519073E-3f;
+	p = p * r + 4.1665795894E-2f;
+	p = p * r + 1.6666665459E-1f;
+	p = p * r + 5.0000001201E-1f;
+	p = p * r * r + r + 1.0f;
+	
+	//2^k in the exponent bits
+	bits = (k + 127) << 23;
+	float scale;
+	memcpy(&scale, &bits, sizeof(float));
+	
+	//NaN stays NaN like cpu_exp, selected on the bits so the loops are still vectorized
+	float ans = p * scale;
+	memcpy(&bits, &ans, sizeof(float));
+	bits = (bits & ~nan) | (nanBits & nan);
+	memcpy(&ans, &bits, sizeof(float));
+	return ans;
+}
+
+inline double fixed_exp(double x) {
+	return std::exp(x);
+}
+
+//The Sigmoid of N units for the fixed size layers (see FixedAffine), fx = 1 / (1 + exp(-x)).
+//It has no state, x and fx can be the same matrix.
+template<typename T, size_t N>
+class FixedSigmoid {
+	
+public:
+	template<size_t M>
+	void foward(const FixedMatrix<T, M, N>& x, FixedMatrix<T, M, N>& fx) const {
+		const T* src = x.ptr();
+		T* dest = fx.ptr();
+		for (size_t i = 0; i < M * N; i++) {
+			dest[i] = 1 / (1 + fixed_exp(-src[i]));
+		}
+	}
+	
+	template<size_t M>
+	FixedMatrix<T, M, N> foward(const FixedMatrix<T, M, N>& x) const {
+		FixedMatrix<T, M, N> fx;
+		foward(x, fx);
+		return fx;
+	}
+};
+
+} // namespace nn
+} // namespace cs
+
+#endif // CS_NN_FIXEDSIGMOID_H_
@@ -12,6 +12,9 @@
 
 
 namespace cs {
+namespace math {
+class Workspace;
+}
 using namespace math;
 namespace nn {
 
@@ -24,6 +27,9 @@ protected:
 	Matrix* fx = nullptr;
 	Matrix* dx = nullptr;
 
+	//not owned, fx and dx are taken from it when it is set
+	Workspace* workspace = nullptr;
+
 	void init_fx(size_t m);
 	void init_dx(size_t m, size_t n);
 
@@ -31,6 +37,10 @@ public:
 	Layer();
 
 	void use_gpu(bool val);
+	
+	//Takes fx and dx from ws on every foward and backward instead of keeping its own, the
+	//owner of ws resets it between steps. nullptr goes back to owned matrices. CPU only.
+	void use_workspace(Workspace* ws);
 
 	void set_dim(size_t input, size_t output);
 	virtual void init()=0;
@@ -9,6 +9,7 @@
 #define CS_NN_NETWORK_H_
 
 
+#include <cs/math/Workspace.h>
 #include <cs/nn/Affine.h>
 #include <cs/nn/Sigmoid.h>
 #include <vector>
@@ -24,12 +25,22 @@ private:
 	
 	float alpha = 0.1;
 	bool gpu = false;
+	bool fused = true;
 	Matrix* x = nullptr;
 	Matrix* y = nullptr;
+	Matrix* dg = nullptr; //gradient of the last layer on the GPU, reused by every backward
 	vector<Layer*> layers;
 	
-	const CpuMatrix cpu_last_grad()const;
-	const GpuMatrix gpu_last_grad()const;
+	//the fx of the layers do not come from the current batch, like after set_batch
+	bool stale = true;
+	
+	//On the CPU the fx and dx of the layers and the gradient of the last one are taken from
+	//it, and forward() resets it: a step of a warm network does not allocate, whatever the
+	//size of its batch.
+	Workspace* workspace = nullptr;
+	
+	CpuMatrix& cpu_last_grad();
+	GpuMatrix& gpu_last_grad();
 	
 public:
 	Network();
@@ -40,8 +51,19 @@ public:
 	
 	void set_alpha(float alpha);
 	float get_alpha()const;
+	
+	//When set (the default) an Affine followed by a Sigmoid runs as a single fused product,
+	//see Affine::foward(x, activation). The activations can differ from the unfused ones in
+	//the last bit, the tails of the rows of a tile take the scalar exp.
+	void set_fused(bool fused);
 	void init(Matrix& x, Matrix& y, bool gpu);
 	
+	//Trains on another batch with the same columns, like the next minibatch, the layers keep
+	//their weights. x and y must outlive the steps on them.
+	void set_batch(Matrix& x, Matrix& y);
+	
+	const Workspace& get_workspace() const;
+	
 	Matrix& forward();
 	void backward();
 	void update();
@@ -49,6 +71,10 @@ public:
 	void train(size_t iter);
 	float min_square_error();
 	
+	//Replaces every Affine layer by its int8 QAffine (CPU only). forward() and
+	//min_square_error() keep working, train() can not be used anymore.
+	void quantize();
+	
 };
 
 } // namespace nn
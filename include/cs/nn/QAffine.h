@@ -0,0 +1,59 @@
+/*
+ * QAffine.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_NN_QAFFINE_H_
+#define CS_NN_QAFFINE_H_
+
+#include <cs/cpu/cpu.h>
+#include <cs/math/CpuMatrix.h>
+#include <cs/math/CpuVector.h>
+#include <cs/nn/Affine.h>
+#include <cs/nn/Layer.h>
+#include <stdint.h>
+#include <vector>
+
+namespace cs {
+using namespace math;
+namespace nn {
+
+//The int8 version of a trained Affine layer, for inference on the CPU: the weights are
+//quantized once with one scale per output, the inputs on every foward with one scale for
+//the batch, and fx = x W + b comes from the int32 sums (see quant.cpp). It can not be
+//trained, backward and update throw.
+class QAffine: public Layer {
+
+private:
+	//packed by cpu_qpack
+	std::vector<int8_t> w;
+	std::vector<float> scales;
+	std::vector<int32_t> sums;
+	std::vector<float> b;
+	
+	//the quantized x of the last foward
+	std::vector<uint8_t> qx;
+
+public:
+
+	QAffine(const CpuMatrix& weights, const CpuVector& bias);
+	QAffine(const Affine& layer);
+	
+	void init();
+	
+	Matrix& foward(const Matrix& x);
+	Matrix& backward(const Matrix& dg);
+	
+	void update(float alpha);
+	
+	void print() const;
+	
+	virtual ~QAffine();
+};
+
+} // namespace nn
+} // namespace cs
+
+#endif // CS_NN_QAFFINE_H_
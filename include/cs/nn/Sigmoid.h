@@ -28,10 +28,6 @@ private:
 	void cpu_foward(const CpuMatrix& x, const CpuMatrix& fx);
 	void cpu_backward(const CpuMatrix& dg);
 	
-	float cpu_sigmoid_fx(float z);
-	float cpu_sigmoid_dx(float z);
-	
-	
 public:
 	Sigmoid();
 	Sigmoid(size_t dim);
@@ -40,6 +36,10 @@ public:
 	void set_dim(size_t inout);
 
 	Matrix& foward(const Matrix& x);
+	
+	//Returns the fx of m rows without computing it: the Affine before it writes the activations
+	//in the pass of its product (see Affine::foward(x, activation)).
+	Matrix& fused_foward(size_t m);
 	Matrix& backward(const Matrix& dg);
 
 	void update(float alpha);
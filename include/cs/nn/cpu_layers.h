@@ -0,0 +1,38 @@
+/*
+ * cpu_layers.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#ifndef CS_NN_CPU_LAYERS_H_
+#define CS_NN_CPU_LAYERS_H_
+
+#include <cs/math/CpuHalfMatrix.h>
+#include <cs/math/CpuMatrix.h>
+#include <cs/math/CpuSparseMatrix.h>
+
+namespace cs {
+using namespace math;
+namespace nn {
+
+//CPU counterparts of gpu_layers.cuh
+
+void affine_dx(const CpuMatrix& x, const CpuMatrix& w, const CpuMatrix& dg, CpuMatrix& dx, CpuMatrix& dw, CpuVector& db);
+//dw = x^T dg reads only the rows of dg of the nonzeros of each column of x
+void affine_dx(const CpuSparseMatrix& x, const CpuMatrix& w, const CpuMatrix& dg, CpuMatrix& dx, CpuMatrix& dw,
+		CpuVector& db);
+//dw = x^T dg widens x to fp32 while it is packed
+void affine_dx(const CpuHalfMatrix& x, const CpuMatrix& w, const CpuMatrix& dg, CpuMatrix& dx, CpuMatrix& dw,
+		CpuVector& db);
+void update_params(const CpuMatrix& w, const CpuMatrix& dw, float scalar);
+void update_params(const CpuVector& b, const CpuVector& db, float scalar);
+
+void sigmoid_fx(const CpuMatrix& x, const CpuMatrix& fx);
+//dx = fx * (1 - fx) * dg, from the output of sigmoid_fx
+void sigmoid_dx(const CpuMatrix& fx, const CpuMatrix& dg, const CpuMatrix& dx);
+
+} // namespace nn
+} // namespace cs
+
+#endif // CS_NN_CPU_LAYERS_H_
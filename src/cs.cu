@@ -13,21 +13,32 @@
 #include <cs/core/utils.h>
 #include <cs/data/Grid.h>
 #include <cs/data/GridInfo.h>
+#include <cs/cpu/cpu.h>
 #include <cs/gpu/gpu.h>
+#include <cs/math/CpuHalfMatrix.h>
 #include <cs/math/CpuMatrix.h>
+#include <cs/math/CpuSparseMatrix.h>
 #include <cs/math/CpuVector.h>
+#include <cs/math/FixedMatrix.h>
 #include <cs/math/GpuMatrix.h>
 #include <cs/math/GpuVector.h>
 #include <cs/math/math.h>
 #include <cs/nn/Affine.h>
+#include <cs/nn/cpu_layers.h>
 #include <cs/nn/errors.h>
+#include <cs/nn/FixedAffine.h>
+#include <cs/nn/FixedSigmoid.h>
 #include <cs/nn/Network.h>
+#include <cs/nn/QAffine.h>
 #include <cs/nn/Sigmoid.h>
+#include <math.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 #include <time.h>
+#include <algorithm>
 #include <string>
 
 using namespace std;
@@ -35,6 +46,7 @@ using namespace cs::core;
 using namespace cs::math;
 using namespace cs::nn;
 using namespace cs::gpu;
+using namespace cs::cpu;
 using namespace cs::data;
 
 void memtest() {
@@ -102,6 +114,1852 @@ void performance() {
 	}
 }
 
+double wall_millis() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+//The original CpuMatrix::dot loop (from gsl_blas_sgemm), kept as the reference.
+void naive_dot(const CpuMatrix& a, const CpuMatrix& b, CpuMatrix& c) {
+	
+	size_t m = a.m;
+	size_t n = a.n;
+	size_t p = b.n;
+	
+	float* A = a.ptr();
+	float* B = b.ptr();
+	float* C = c.ptr();
+	
+	c.clear();
+	for (size_t i = 0; i < m; i++) {
+		for (size_t j = 0; j < n; j++) {
+			const float pivot = A[i * n + j];
+			for (size_t k = 0; k < p; k++) {
+				C[i * p + k] += pivot * B[j * p + k];
+			}
+		}
+	}
+}
+
+void gemm_performance() {
+	
+	size_t sizes[] = { 64, 256, 512, 1000 };
+	
+	println("GEMM GFLOP/s: naive loop vs CpuMatrix::dot");
+	println("======================================================");
+	for (size_t d : sizes) {
+		CpuMatrix a = randn(d, d);
+		CpuMatrix b = randn(d, d);
+		CpuMatrix c1 = CpuMatrix(d, d, false);
+		CpuMatrix c2 = CpuMatrix(d, d, false);
+		
+		double flops = 2.0 * d * d * d;
+		int reps = d >= 512 ? 3 : 10;
+		
+		double naive = 1e30;
+		double blocked = 1e30;
+		for (int r = 0; r < reps; r++) {
+			double start = wall_millis();
+			naive_dot(a, b, c1);
+			naive = std::min(naive, wall_millis() - start);
+			
+			start = wall_millis();
+			a.dot(b, c2);
+			blocked = std::min(blocked, wall_millis() - start);
+		}
+		
+		float err = ((c1 - c2) ^ 2).max();
+		printf("%5d  naive: %8.2f GFLOP/s   blocked: %8.2f GFLOP/s   speedup: %6.1fx   max sq err: %g\n", (int) d,
+				flops / naive / 1e6, flops / blocked / 1e6, naive / blocked, err);
+	}
+	println("======================================================");
+}
+
+void thread_scaling() {
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix w = randn(x.n, x.n);
+	CpuVector b = randn(x.n);
+	CpuVector v = randn(x.n);
+	
+	CpuMatrix ans = CpuMatrix(x.m, x.n, false);
+	CpuMatrix serial = CpuMatrix(x.m, x.n, false);
+	
+	size_t hw = cpu_threads();
+	
+	printf("Thread scaling on the adult data: x is %dx%d\n", (int) x.m, (int) x.n);
+	println("======================================================");
+	
+	cpu_set_threads(1);
+	x.affine(w, b, serial);
+	CpuVector serialV = x.dot(v);
+	
+	vector<size_t> counts;
+	for (size_t t = 1; t < hw; t *= 2) {
+		counts.push_back(t);
+	}
+	counts.push_back(hw);
+	
+	double base = 0;
+	for (size_t t : counts) {
+		cpu_set_threads(t);
+		
+		double best = 1e30;
+		for (int r = 0; r < 10; r++) {
+			double start = wall_millis();
+			x.affine(w, b, ans);
+			best = std::min(best, wall_millis() - start);
+		}
+		
+		if (t == 1) {
+			base = best;
+		}
+		
+		CpuVector ansV = x.dot(v);
+		bool same = memcmp(ans.ptr(), serial.ptr(), sizeof(float) * ans.length) == 0
+				&& memcmp(ansV.ptr(), serialV.ptr(), sizeof(float) * ansV.length) == 0;
+		
+		printf("threads: %3d   affine: %8.3f ms   speedup: %5.2fx   bit-identical: %s\n", (int) t, best, base / best,
+				same ? "yes" : "NO");
+	}
+	println("======================================================");
+	
+	cpu_set_threads(hw);
+}
+
+//Counts the cpu_malloc calls of an expression against the expected number.
+void check_allocations(const char* expr, size_t before, size_t expected) {
+	size_t count = cpu_allocations() - before;
+	printf("%-48s allocations: %d   expected: %d   %s\n", expr, (int) count, (int) expected,
+			count == expected ? "ok" : "FAIL");
+}
+
+void allocation_test() {
+	
+	CpuMatrix a = randn(200, 300);
+	CpuMatrix b = randn(300, 100);
+	CpuMatrix x = randn(200, 100);
+	CpuMatrix y = randn(200, 100);
+	
+	println("Allocations of temporaries (move semantics)");
+	println("======================================================");
+	
+	size_t before = cpu_allocations();
+	CpuMatrix c1 = a.dot(b);
+	check_allocations("CpuMatrix c = a.dot(b)", before, 1);
+	
+	before = cpu_allocations();
+	CpuMatrix c2 = a.dot(b) + x;
+	check_allocations("CpuMatrix c = a.dot(b) + x", before, 1);
+	
+	before = cpu_allocations();
+	auto e = a.dot(b) + x;
+	CpuMatrix c3 = e * 2 - y;
+	check_allocations("auto e = a.dot(b) + x; CpuMatrix c = e * 2 - y", before, 2);
+	
+	before = cpu_allocations();
+	CpuMatrix c4 = (a.dot(b) - y) ^ 2;
+	check_allocations("CpuMatrix c = (a.dot(b) - y) ^ 2", before, 1);
+	
+	before = cpu_allocations();
+	c4 = a.dot(b) * x;
+	check_allocations("c = a.dot(b) * x", before, 1);
+	
+	before = cpu_allocations();
+	CpuMatrix c5 = std::move(c1);
+	CpuMatrix c6 = x.sltcols(0, 50);
+	check_allocations("std::move(c) and x.sltcols(0, 50)", before, 1);
+	
+	float err = ((c2 - c5 - x) ^ 2).max() + ((c3 - (c2 * 2 - y)) ^ 2).max();
+	printf("max sq err: %g\n", err);
+	println("======================================================");
+}
+
+void expression_performance() {
+	
+	size_t m = 32768;
+	size_t n = 128;
+	
+	CpuMatrix h = randn(m, n);
+	CpuMatrix y = randn(m, n);
+	CpuMatrix ans = CpuMatrix(m, n, false);
+	
+	printf("Element wise expressions on %dx%d: one temporary per operator vs fused\n", (int) m, (int) n);
+	println("======================================================");
+	
+	double eager = 1e30;
+	double fused = 1e30;
+	float j1 = 0;
+	float j2 = 0;
+	for (int r = 0; r < 5; r++) {
+		//what sum((h - y) ^ 2) used to cost: two temporaries and three passes
+		double start = wall_millis();
+		CpuMatrix diff = h - y;
+		CpuMatrix sq = diff ^ 2;
+		j1 = sq.sum();
+		eager = std::min(eager, wall_millis() - start);
+		
+		start = wall_millis();
+		j2 = sum((h - y) ^ 2);
+		fused = std::min(fused, wall_millis() - start);
+	}
+	printf("sum((h - y) ^ 2)   eager: %8.2f ms   fused: %8.2f ms   speedup: %5.1fx   %g vs %g\n", eager, fused,
+			eager / fused, j1, j2);
+	
+	eager = 1e30;
+	fused = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		CpuMatrix t1 = 2 * h;
+		CpuMatrix t2 = t1 + y;
+		ans = t2 - 1.0f;
+		eager = std::min(eager, wall_millis() - start);
+		
+		start = wall_millis();
+		ans = 2 * h + y - 1.0f;
+		fused = std::min(fused, wall_millis() - start);
+	}
+	printf("ans = 2 * h + y - 1   eager: %8.2f ms   fused: %8.2f ms   speedup: %5.1fx\n", eager, fused,
+			eager / fused);
+	println("======================================================");
+}
+
+//Same operations on compact and padded (aligned rows) matrices, the results must match.
+void padding_test() {
+	
+	size_t m = 1001;
+	size_t n = 333;
+	size_t p = 517;
+	
+	CpuMatrix a = randn(m, n);
+	CpuMatrix b = randn(n, p);
+	CpuMatrix x = randn(m, p);
+	
+	CpuMatrix pa = CpuMatrix(m, n, cpu_padded(n), false);
+	CpuMatrix pb = CpuMatrix(n, p, cpu_padded(p), false);
+	CpuMatrix px = CpuMatrix(m, p, cpu_padded(p), false);
+	a.copy(pa);
+	b.copy(pb);
+	x.copy(px);
+	
+	printf("Compact vs padded (ld %d, %d)\n", (int) pa.ld, (int) pb.ld);
+	println("======================================================");
+	
+	double compact = 1e30;
+	double padded = 1e30;
+	CpuMatrix c = CpuMatrix(m, p, false);
+	CpuMatrix pc = CpuMatrix(m, p, cpu_padded(p), false);
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		a.dot(b, c);
+		compact = std::min(compact, wall_millis() - start);
+	
+		start = wall_millis();
+		pa.dot(pb, pc);
+		padded = std::min(padded, wall_millis() - start);
+	}
+	printf("dot   compact: %8.2f ms   padded: %8.2f ms\n", compact, padded);
+	
+	float err = ((c - pc) ^ 2).max();
+	err += ((a.dot(true, x) - pa.dot(true, px)) ^ 2).max();
+	err += ((c + x * 2 - (pc + px * 2)) ^ 2).max();
+	err += std::fabs(c.sum() - pc.sum());
+	printf("max sq err: %g\n", err);
+	println("======================================================");
+}
+
+//Slicing a dataset sized matrix: a copy with sltcols vs a view with cols/rows.
+void view_performance() {
+	
+	size_t m = 32768;
+	size_t n = 100;
+	size_t batch = 256;
+	
+	CpuMatrix x = randn(m, n);
+	CpuMatrix w = randn(n - 1, 10);
+	CpuMatrix ans = CpuMatrix(batch, 10, false);
+	
+	printf("Slices of a %dx%d matrix: copy vs view\n", (int) m, (int) n);
+	println("======================================================");
+	
+	double copy = 1e30;
+	double view = 1e30;
+	float s1 = 0;
+	float s2 = 0;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		CpuMatrix features = x.sltcols(1, n);
+		s1 = features.sum();
+		copy = std::min(copy, wall_millis() - start);
+	
+		start = wall_millis();
+		MatrixView cols = x.cols(1, n);
+		s2 = cols.sum();
+		view = std::min(view, wall_millis() - start);
+	}
+	printf("columns [1, %d)   copy: %8.3f ms   view: %8.3f ms   %g vs %g\n", (int) n, copy, view, s1, s2);
+	
+	//every minibatch multiplied straight from the dataset memory
+	size_t before = cpu_allocations();
+	double start = wall_millis();
+	for (size_t i = 0; i + batch <= m; i += batch) {
+		MatrixView xb = x.block(i, 1, batch, n - 1);
+		xb.dot(w, ans);
+	}
+	printf("%d minibatches of %d rows: %8.3f ms   allocations: %d\n", (int) (m / batch), (int) batch,
+			wall_millis() - start, (int) (cpu_allocations() - before));
+	println("======================================================");
+}
+
+//The original CpuVector::sum and CpuVector::var loops, kept as the reference.
+float naive_sum(const CpuVector& v) {
+	
+	float* A = v.ptr();
+	float ans = A[0];
+	for (size_t i = 1; i < v.length; i++) {
+		ans += A[i];
+	}
+	return ans;
+}
+
+float naive_var(const CpuVector& v) {
+	
+	size_t n = 0;
+	float _mean = 0.0;
+	float m2 = 0.0;
+	
+	float* A = v.ptr();
+	for (size_t i = 0; i < v.length; i++) {
+		n++;
+		float x = A[i];
+		float delta = x - _mean;
+		_mean += delta / n;
+		m2 += delta * (x - _mean);
+	}
+	return m2 / (n - 1);
+}
+
+void reduction_performance() {
+	
+	size_t l = 10 * 1000 * 1000;
+	
+	//not centered at 0, so a single float accumulator loses digits
+	CpuVector v = randn(l) + 1.0f;
+	float* A = v.ptr();
+	
+	double exactSum = 0.0;
+	for (size_t i = 0; i < l; i++) {
+		exactSum += A[i];
+	}
+	double mean = exactSum / l;
+	double exactVar = 0.0;
+	for (size_t i = 0; i < l; i++) {
+		exactVar += (A[i] - mean) * (A[i] - mean);
+	}
+	exactVar /= l - 1;
+	
+	printf("Reductions of %d floats: scalar loop vs vectorized\n", (int) l);
+	println("======================================================");
+	
+	double naive = 1e30;
+	double fast = 1e30;
+	float s1 = 0;
+	float s2 = 0;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		s1 = naive_sum(v);
+		naive = std::min(naive, wall_millis() - start);
+	
+		start = wall_millis();
+		s2 = v.sum();
+		fast = std::min(fast, wall_millis() - start);
+	}
+	printf("sum   naive: %8.2f ms  rel err %.2e   vectorized: %8.2f ms  rel err %.2e   %5.2f GB/s\n", naive,
+			std::fabs(s1 - exactSum) / std::fabs(exactSum), fast, std::fabs(s2 - exactSum) / std::fabs(exactSum),
+			sizeof(float) * l / fast / 1e6);
+	
+	naive = 1e30;
+	fast = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		s1 = naive_var(v);
+		naive = std::min(naive, wall_millis() - start);
+	
+		start = wall_millis();
+		s2 = v.var();
+		fast = std::min(fast, wall_millis() - start);
+	}
+	printf("var   naive: %8.2f ms  rel err %.2e   vectorized: %8.2f ms  rel err %.2e\n", naive,
+			std::fabs(s1 - exactVar) / exactVar, fast, std::fabs(s2 - exactVar) / exactVar);
+	
+	naive = 1e30;
+	fast = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		s1 = A[0];
+		for (size_t i = 1; i < l; i++) {
+			s1 = std::max(s1, A[i]);
+		}
+		naive = std::min(naive, wall_millis() - start);
+	
+		start = wall_millis();
+		s2 = v.max();
+		fast = std::min(fast, wall_millis() - start);
+	}
+	printf("max   naive: %8.2f ms   vectorized: %8.2f ms   %s\n", naive, fast, s1 == s2 ? "same" : "DIFFERENT");
+	
+	//axis wise, on a matrix of the same size
+	CpuMatrix x = randn(l / 100, 100);
+	CpuVector rows = CpuVector(x.n, false);
+	CpuVector cols = CpuVector(x.m, false);
+	
+	double sumRows = 1e30;
+	double sumCols = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		x.sum_rows(rows);
+		sumRows = std::min(sumRows, wall_millis() - start);
+	
+		start = wall_millis();
+		x.sum_cols(cols);
+		sumCols = std::min(sumCols, wall_millis() - start);
+	}
+	printf("%dx%d   sum_rows: %8.2f ms   sum_cols: %8.2f ms   err: %g\n", (int) x.m, (int) x.n, sumRows, sumCols,
+			std::fabs(rows.sum() - cols.sum()));
+	println("======================================================");
+}
+
+//The original Sigmoid::cpu_foward and Sigmoid::cpu_backward loops, kept as the reference.
+void naive_sigmoid_fx(const CpuMatrix& x, const CpuMatrix& fx) {
+	
+	float* X = x.ptr();
+	float* FX = fx.ptr();
+	for (size_t i = 0; i < x.length; i++) {
+		FX[i] = 1.0f / (1.0f + expf(-X[i]));
+	}
+}
+
+void naive_sigmoid_dx(const CpuMatrix& x, const CpuMatrix& dg, const CpuMatrix& dx) {
+	
+	float* X = x.ptr();
+	float* DG = dg.ptr();
+	float* DX = dx.ptr();
+	for (size_t i = 0; i < x.length; i++) {
+		float z = X[i];
+		DX[i] = (1.0f / (1.0f + expf(-z))) * (1 - 1.0f / (1.0f + expf(-z))) * DG[i];
+	}
+}
+
+void sigmoid_performance() {
+	
+	size_t m = 32768;
+	size_t n = 256;
+	
+	CpuMatrix x = randn(m, n) * 4.0f;
+	CpuMatrix dg = randn(m, n);
+	CpuMatrix fx1 = CpuMatrix(m, n, false);
+	CpuMatrix fx2 = CpuMatrix(m, n, false);
+	CpuMatrix dx1 = CpuMatrix(m, n, false);
+	CpuMatrix dx2 = CpuMatrix(m, n, false);
+	
+	printf("Sigmoid of %dx%d: scalar expf vs vectorized\n", (int) m, (int) n);
+	println("======================================================");
+	
+	double naive = 1e30;
+	double fast = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		naive_sigmoid_fx(x, fx1);
+		naive = std::min(naive, wall_millis() - start);
+	
+		start = wall_millis();
+		sigmoid_fx(x, fx2);
+		fast = std::min(fast, wall_millis() - start);
+	}
+	
+	float* X = x.ptr();
+	float* DG = dg.ptr();
+	double err1 = 0;
+	double err2 = 0;
+	for (size_t i = 0; i < x.length; i++) {
+		double f = 1.0 / (1.0 + exp(-(double) X[i]));
+		err1 = std::max(err1, std::fabs(fx1.ptr()[i] - f) / f);
+		err2 = std::max(err2, std::fabs(fx2.ptr()[i] - f) / f);
+	}
+	printf("foward    scalar: %8.2f ms  rel err %.2e   vectorized: %8.2f ms  rel err %.2e   %5.1fx\n", naive, err1,
+			fast, err2, naive / fast);
+	
+	naive = 1e30;
+	fast = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		naive_sigmoid_dx(x, dg, dx1);
+		naive = std::min(naive, wall_millis() - start);
+	
+		start = wall_millis();
+		sigmoid_dx(fx2, dg, dx2);
+		fast = std::min(fast, wall_millis() - start);
+	}
+	
+	err1 = 0;
+	err2 = 0;
+	for (size_t i = 0; i < x.length; i++) {
+		double f = 1.0 / (1.0 + exp(-(double) X[i]));
+		double d = f * (1 - f) * DG[i];
+		err1 = std::max(err1, std::fabs(dx1.ptr()[i] - d));
+		err2 = std::max(err2, std::fabs(dx2.ptr()[i] - d));
+	}
+	printf("backward  scalar: %8.2f ms  abs err %.2e   vectorized: %8.2f ms  abs err %.2e   %5.1fx\n", naive, err1,
+			fast, err2, naive / fast);
+	println("======================================================");
+}
+
+void broadcast_performance() {
+	
+	size_t m = 32768;
+	size_t n = 256;
+	
+	CpuMatrix x = randn(m, n);
+	CpuMatrix y = CpuMatrix(m, n, false);
+	CpuVector b = randn(n);
+	CpuVector mean = x.avg_rows();
+	CpuVector stdev = randn(n) * 0.1f + 1.0f;
+	
+	printf("Broadcasts on %dx%d: scalar loop vs vectorized\n", (int) m, (int) n);
+	println("======================================================");
+	
+	float* X = x.ptr();
+	float* Y = y.ptr();
+	float* B = b.ptr();
+	
+	//the bias of CpuMatrix::affine
+	double naive = 1e30;
+	double fast = 1e30;
+	for (int r = 0; r < 5; r++) {
+		x.copy(y);
+		double start = wall_millis();
+		for (size_t i = 0; i < m; i++) {
+			for (size_t k = 0; k < n; k++) {
+				Y[i * n + k] += B[k];
+			}
+		}
+		naive = std::min(naive, wall_millis() - start);
+	
+		x.copy(y);
+		start = wall_millis();
+		y.addi_rows(b);
+		fast = std::min(fast, wall_millis() - start);
+	}
+	printf("bias add      scalar: %8.2f ms   addi_rows: %8.2f ms   %5.1fx\n", naive, fast, naive / fast);
+	
+	//the standardization of Grid::toMatrix
+	naive = 1e30;
+	fast = 1e30;
+	for (int r = 0; r < 5; r++) {
+		x.copy(y);
+		double start = wall_millis();
+		for (size_t i = 0; i < m; i++) {
+			for (size_t j = 0; j < n; j++) {
+				Y[i * n + j] = (float) ((Y[i * n + j] - (double) mean[j]) / stdev[j]);
+			}
+		}
+		naive = std::min(naive, wall_millis() - start);
+	
+		x.copy(y);
+		start = wall_millis();
+		y.subi_rows(mean);
+		y.divi_rows(stdev);
+		fast = std::min(fast, wall_millis() - start);
+	}
+	printf("standardize   scalar: %8.2f ms   broadcast: %8.2f ms   %5.1fx\n", naive, fast, naive / fast);
+	
+	//the mean of every feature, then of every sample
+	double avgRows = 1e30;
+	double avgCols = 1e30;
+	CpuVector rows = CpuVector(n, false);
+	CpuVector cols = CpuVector(m, false);
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		x.avg_rows(rows);
+		avgRows = std::min(avgRows, wall_millis() - start);
+	
+		start = wall_millis();
+		x.avg_cols(cols);
+		avgCols = std::min(avgCols, wall_millis() - start);
+	}
+	printf("avg_rows: %8.2f ms   avg_cols: %8.2f ms   %g vs %g\n", avgRows, avgCols, rows.avg(), cols.avg());
+	println("======================================================");
+}
+
+//Transposes x with the naive loop, with CpuMatrix::transpose and copies it with memcpy,
+//checks the result and reports the bandwidth (a read and a write of every element).
+void transpose_shape(const CpuMatrix& x) {
+	
+	size_t m = x.m;
+	size_t n = x.n;
+	
+	CpuMatrix t1 = CpuMatrix(n, m, false);
+	CpuMatrix t2 = CpuMatrix(n, m, false);
+	CpuMatrix c = CpuMatrix(m, n, false);
+	
+	float* X = x.ptr();
+	float* T1 = t1.ptr();
+	
+	double naive = 1e30;
+	double fast = 1e30;
+	double copy = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		for (size_t i = 0; i < m; i++) {
+			for (size_t j = 0; j < n; j++) {
+				T1[j * m + i] = X[i * x.ld + j];
+			}
+		}
+		naive = std::min(naive, wall_millis() - start);
+	
+		start = wall_millis();
+		x.transpose(t2);
+		fast = std::min(fast, wall_millis() - start);
+	
+		start = wall_millis();
+		memcpy(c.ptr(), X, sizeof(float) * m * n);
+		copy = std::min(copy, wall_millis() - start);
+	}
+	
+	size_t wrong = 0;
+	for (size_t i = 0; i < t1.length; i++) {
+		wrong += t1.ptr()[i] != t2.ptr()[i];
+	}
+	
+	double bytes = 2.0 * sizeof(float) * m * n;
+	printf("%6dx%-6d naive: %8.2f ms   blocked: %8.2f ms %6.2f GB/s   memcpy: %8.2f ms %6.2f GB/s   wrong: %d\n",
+			(int) m, (int) n, naive, fast, bytes / fast / 1e6, copy, bytes / copy / 1e6, (int) wrong);
+}
+
+void transpose_performance() {
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	
+	printf("Transposes: naive loop vs blocked vs memcpy\n");
+	println("======================================================");
+	
+	//the tall and skinny matrices of the dataset, and their transposes
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix y = g.toMatrix(14, 15, false);
+	transpose_shape(x);
+	transpose_shape(y);
+	transpose_shape(x.transpose());
+	transpose_shape(randn(4096, 4096));
+	transpose_shape(randn(4096, 4096).cols(0, 4000));
+	
+	CpuMatrix a = randn(4096, 4096);
+	CpuMatrix b = a.transpose();
+	double start = wall_millis();
+	a.transposei();
+	double inplace = wall_millis() - start;
+	
+	size_t wrong = 0;
+	for (size_t i = 0; i < a.length; i++) {
+		wrong += a.ptr()[i] != b.ptr()[i];
+	}
+	printf("  4096x4096 in place: %8.2f ms %6.2f GB/s   wrong: %d\n", inplace, 2.0 * sizeof(float) * a.length / inplace / 1e6,
+			(int) wrong);
+	println("======================================================");
+}
+
+//The original CpuMatrix::dot(CpuVector) and CpuVector::dot loops, kept as the reference.
+void naive_gemv(const CpuMatrix& a, const CpuVector& x, CpuVector& y) {
+	
+	float* A = a.ptr();
+	float* X = x.ptr();
+	float* Y = y.ptr();
+	for (size_t i = 0; i < a.m; i++) {
+		float val = 0.0f;
+		for (size_t j = 0; j < a.n; j++) {
+			val += A[i * a.ld + j] * X[j];
+		}
+		Y[i] = val;
+	}
+}
+
+float naive_vdot(const CpuVector a, const CpuVector b) {
+	
+	float* A = a.ptr();
+	float* B = b.ptr();
+	float ans = 0.0f;
+	for (size_t i = 0; i < a.length; i++) {
+		ans += A[i] * B[i];
+	}
+	return ans;
+}
+
+//Microseconds of a call, the best of 5 runs of reps calls.
+template<class F>
+double latency_micros(size_t reps, F f) {
+	
+	double best = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		for (size_t k = 0; k < reps; k++) {
+			f();
+		}
+		best = std::min(best, (wall_millis() - start) * 1000.0 / reps);
+	}
+	return best;
+}
+
+void gemv_performance() {
+	
+	printf("GEMV latency in microseconds: scalar loop vs vectorized\n");
+	println("======================================================");
+	
+	size_t sizes[] = { 4, 16, 64, 256 };
+	for (size_t m : sizes) {
+		for (size_t n : sizes) {
+			CpuMatrix a = randn(m, n);
+			CpuVector x = randn(n);
+			CpuVector xt = randn(m);
+			CpuVector y = CpuVector(m, false);
+			CpuVector yt = CpuVector(n, false);
+	
+			//a single sample through a layer, (1 x m) x (m x n)
+			CpuMatrix s = randn(1, m);
+			CpuMatrix f = CpuMatrix(1, n, false);
+	
+			size_t reps = std::max((size_t) 1000, 10 * 1000 * 1000 / (m * n));
+			double naive = latency_micros(reps, [&]() {naive_gemv(a, x, y);});
+			double fast = latency_micros(reps, [&]() {a.dot(x, y);});
+			double trans = latency_micros(reps, [&]() {a.dot(true, xt, yt);});
+			double sample = latency_micros(reps, [&]() {s.dot(a, f);});
+	
+			printf("%3dx%-3d  A x naive: %7.3f  simd: %7.3f   A^T x: %7.3f   sample x A: %7.3f\n", (int) m, (int) n,
+					naive, fast, trans, sample);
+		}
+	}
+	
+	//10000 samples scored by the same (64 x 16) matrix
+	size_t batch = 10000;
+	size_t m = 64;
+	size_t n = 16;
+	CpuMatrix w = randn(m, n);
+	CpuMatrix xs = randn(batch, n);
+	CpuMatrix ys = CpuMatrix(batch, m, false);
+	CpuVector x = CpuVector(n, false);
+	CpuVector y = CpuVector(m, false);
+	
+	double loop = latency_micros(10, [&]() {
+		for (size_t k = 0; k < batch; k++) {
+			cpu_gemv(w.ptr(), w.ld, xs.ptr() + k * n, ys.ptr() + k * m, m, n);
+		}
+	});
+	double batched = latency_micros(10, [&]() {
+		cpu_gemv_batched(w.ptr(), w.ld, 0, false, xs.ptr(), n, ys.ptr(), m, m, n, batch);
+	});
+	double gemm = latency_micros(10, [&]() {xs.dot(w, true, ys);});
+	printf("%d vectors x (%dx%d)   gemv loop: %8.1f   batched: %8.1f   gemm: %8.1f\n", (int) batch, (int) m,
+			(int) n, loop, batched, gemm);
+	
+	CpuVector u = randn(256);
+	CpuVector v = randn(256);
+	double byValue = latency_micros(100000, [&]() {naive_vdot(u, v);});
+	double byRef = latency_micros(100000, [&]() {u.dot(v);});
+	printf("dot of 256   by value: %7.3f   by reference: %7.3f   %g vs %g\n", byValue, byRef, naive_vdot(u, v), u.dot(v));
+	println("======================================================");
+}
+
+//The original Affine::cpu_backward loop, kept as the reference.
+void naive_affine_backward(const CpuMatrix& x, const CpuMatrix& w, const CpuMatrix& dg, CpuMatrix& dx, CpuMatrix& dw,
+		CpuVector& db) {
+	
+	dx.clear();
+	dw.clear();
+	db.clear();
+	
+	size_t m = x.m;
+	size_t n = x.n;
+	size_t p = w.n;
+	
+	float* X = x.ptr();
+	float* W = w.ptr();
+	
+	float* DG = dg.ptr();
+	float* DX = dx.ptr();
+	float* DW = dw.ptr();
+	float* DB = db.ptr();
+	
+	for (size_t i = 0; i < m; i++) {
+		for (size_t k = 0; k < p; k++) {
+			
+			float fdg = DG[i * p + k];
+			for (size_t j = 0; j < n; j++) {
+				DX[i * n + j] += fdg * W[j * p + k];
+				DW[j * p + k] += fdg * X[i * n + j];
+			}
+			
+			DB[k] += fdg;
+		}
+	}
+}
+
+void train_performance() {
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix yy = g.toMatrix(14, 15, false);
+	CpuMatrix y = yy.sltcols(0, 1);
+	
+	size_t hidden = 128;
+	size_t dims[] = { x.n, hidden, hidden, y.n };
+	
+	Network net = Network();
+	net << Affine(dims[0], dims[1]);
+	net << Sigmoid(dims[1]);
+	net << Affine(dims[1], dims[2]);
+	net << Sigmoid(dims[2]);
+	net << Affine(dims[2], dims[3]);
+	net << Sigmoid(dims[3]);
+	net.init(x, y, false);
+	
+	printf("Network::train step on the adult data: %d rows, layers %d-%d-%d-%d\n", (int) x.m, (int) dims[0],
+			(int) dims[1], (int) dims[2], (int) dims[3]);
+	println("======================================================");
+	
+	double step = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		net.train(1);
+		step = std::min(step, wall_millis() - start);
+	}
+	
+	//the backward of every affine layer, naive loop vs two GEMMs and a column sum
+	double naiveTotal = 0;
+	double gemmTotal = 0;
+	for (size_t l = 0; l < 3; l++) {
+		size_t n = dims[l];
+		size_t p = dims[l + 1];
+		
+		CpuMatrix in = randn(x.m, n);
+		CpuMatrix w = randn(n, p);
+		CpuMatrix dg = randn(x.m, p);
+		
+		CpuMatrix dx1 = CpuMatrix(x.m, n, false);
+		CpuMatrix dw1 = CpuMatrix(n, p, false);
+		CpuVector db1 = CpuVector(p, false);
+		CpuMatrix dx2 = CpuMatrix(x.m, n, false);
+		CpuMatrix dw2 = CpuMatrix(n, p, false);
+		CpuVector db2 = CpuVector(p, false);
+		
+		double naive = 1e30;
+		double gemm = 1e30;
+		for (int r = 0; r < 3; r++) {
+			double start = wall_millis();
+			naive_affine_backward(in, w, dg, dx1, dw1, db1);
+			naive = std::min(naive, wall_millis() - start);
+			
+			start = wall_millis();
+			affine_dx(in, w, dg, dx2, dw2, db2);
+			gemm = std::min(gemm, wall_millis() - start);
+		}
+		
+		float errX = ((dx1 - dx2) ^ 2).max();
+		float errW = ((dw1 - dw2) ^ 2).max();
+		printf("affine %4dx%-4d  backward naive: %9.2f ms   gemm: %8.2f ms   speedup: %6.1fx   max sq err dx: %g dw: %g\n",
+				(int) n, (int) p, naive, gemm, naive / gemm, errX, errW);
+		
+		naiveTotal += naive;
+		gemmTotal += gemm;
+	}
+	
+	double before = step - gemmTotal + naiveTotal;
+	printf("train step: %8.2f ms   with the naive backward: %8.2f ms   speedup: %5.1fx\n", step, before,
+			before / step);
+	println("======================================================");
+}
+
+//Step time of a network over the dense and the CSR inputs of the adult data.
+double sparse_step(Matrix& x, Matrix& y, size_t hidden) {
+	
+	Network net = Network();
+	net << Affine(x.n, hidden);
+	net << Sigmoid(hidden);
+	net << Affine(hidden, y.n);
+	net << Sigmoid(y.n);
+	net.init(x, y, false);
+	
+	double step = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		net.train(1);
+		step = std::min(step, wall_millis() - start);
+	}
+	return step;
+}
+
+void sparse_performance() {
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuSparseMatrix sx = g.toSparseMatrix(0, 14, true);
+	CpuMatrix yy = g.toMatrix(14, 15, false);
+	CpuMatrix y = yy.sltcols(0, 1);
+	
+	printf("CSR input of the adult data: %dx%d, %d nonzeros (%.1f%%)\n", (int) x.m, (int) x.n, (int) sx.nnz(),
+			100.0 * sx.nnz() / x.length);
+	println("======================================================");
+	
+	float errX = ((x - sx.to_dense()) ^ 2).max();
+	printf("toSparseMatrix vs toMatrix   max sq err: %g\n", errX);
+	printf("memory   dense: %8.2f MB   csr: %8.2f MB   %5.1fx smaller\n", x.length * sizeof(float) / 1e6,
+			sx.bytes() / 1e6, (double) x.length * sizeof(float) / sx.bytes());
+	
+	//the first affine layer over both inputs
+	size_t hidden = 128;
+	CpuMatrix w = randn(x.n, hidden);
+	CpuVector b = randn(hidden);
+	CpuMatrix dg = randn(x.m, hidden);
+	
+	CpuMatrix fx1 = CpuMatrix(x.m, hidden, false);
+	CpuMatrix fx2 = CpuMatrix(x.m, hidden, false);
+	CpuMatrix dx1 = CpuMatrix(x.m, x.n, false);
+	CpuMatrix dx2 = CpuMatrix(x.m, x.n, false);
+	CpuMatrix dw1 = CpuMatrix(x.n, hidden, false);
+	CpuMatrix dw2 = CpuMatrix(x.n, hidden, false);
+	CpuVector db1 = CpuVector(hidden, false);
+	CpuVector db2 = CpuVector(hidden, false);
+	
+	double denseFx = 1e30;
+	double sparseFx = 1e30;
+	double denseDx = 1e30;
+	double sparseDx = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		x.affine(w, b, fx1);
+		denseFx = std::min(denseFx, wall_millis() - start);
+		
+		start = wall_millis();
+		sx.affine(w, b, fx2);
+		sparseFx = std::min(sparseFx, wall_millis() - start);
+		
+		start = wall_millis();
+		affine_dx(x, w, dg, dx1, dw1, db1);
+		denseDx = std::min(denseDx, wall_millis() - start);
+		
+		start = wall_millis();
+		affine_dx(sx, w, dg, dx2, dw2, db2);
+		sparseDx = std::min(sparseDx, wall_millis() - start);
+	}
+	
+	float errFx = ((fx1 - fx2) ^ 2).max();
+	float errW = ((dw1 - dw2) ^ 2).max() / (dw1 ^ 2).max();
+	printf("affine %dx%d  foward   dense: %8.2f ms   csr: %8.2f ms   max sq err: %g\n", (int) x.n, (int) hidden,
+			denseFx, sparseFx, errFx);
+	printf("affine %dx%d  backward dense: %8.2f ms   csr: %8.2f ms   max relative sq err dw: %g\n", (int) x.n,
+			(int) hidden, denseDx, sparseDx, errW);
+	
+	double denseStep = sparse_step(x, y, hidden);
+	double sparseStep = sparse_step(sx, y, hidden);
+	printf("train step   dense: %8.2f ms   csr: %8.2f ms   speedup: %5.1fx\n", denseStep, sparseStep,
+			denseStep / sparseStep);
+	println("======================================================");
+}
+
+//Trains a 2 layer network from the given weights like Network::train, returns the milliseconds
+//of a step, the square error and the accuracy on the training set.
+double half_train(const Matrix& x, const CpuMatrix& y, const CpuMatrix& w1, const CpuVector& b1, const CpuMatrix& w2,
+		const CpuVector& b2, int iter, float alpha, float& error, float& accuracy) {
+	
+	Affine f1 = Affine(w1.m, w1.n);
+	Sigmoid s1 = Sigmoid(w1.n);
+	Affine f2 = Affine(w2.m, w2.n);
+	Sigmoid s2 = Sigmoid(w2.n);
+	f1.init();
+	s1.init();
+	f2.init();
+	s2.init();
+	f1.set_weights(w1);
+	f1.set_bias(b1);
+	f2.set_weights(w2);
+	f2.set_bias(b2);
+	
+	double start = wall_millis();
+	for (int i = 0; i < iter; i++) {
+		Matrix& h = s2.foward(f2.foward(s1.foward(f1.foward(x))));
+		
+		CpuMatrix dg = cpu_cast(h) - y;
+		f1.backward(s1.backward(f2.backward(s2.backward(dg))));
+		
+		f2.update(alpha);
+		f1.update(alpha);
+	}
+	double step = (wall_millis() - start) / iter;
+	
+	CpuMatrix& h = cpu_cast(s2.foward(f2.foward(s1.foward(f1.foward(x)))));
+	error = min_square_error(h, y);
+	
+	size_t good = 0;
+	for (size_t i = 0; i < y.m; i++) {
+		if ((h.get(i, 0) >= 0.5f) == (y.get(i, 0) == 1.0f)) {
+			good++;
+		}
+	}
+	accuracy = 100.0f * good / y.m;
+	
+	return step;
+}
+
+void half_performance() {
+	
+	const CpuHalf types[] = { CPU_BF16, CPU_FP16 };
+	const char* names[] = { "bf16", "fp16" };
+	
+	println("16 bit storage, fp32 compute");
+	println("======================================================");
+	
+	//rounding of the standardized inputs of the bundled data
+	const char* files[] = { "files/iris.data", "files/adult.data" };
+	size_t features[] = { 4, 14 };
+	for (int f = 0; f < 2; f++) {
+		string data = ffull(files[f]);
+		Grid g = Grid(data);
+		CpuMatrix x = g.toMatrix(0, features[f], true);
+		
+		for (int t = 0; t < 2; t++) {
+			CpuHalfMatrix hx = g.toHalfMatrix(0, features[f], true, types[t]);
+			CpuMatrix back = hx.to_float();
+			
+			float errAbs = 0.0f;
+			float errRel = 0.0f;
+			for (size_t i = 0; i < x.m; i++) {
+				for (size_t j = 0; j < x.n; j++) {
+					float d = fabs(back.get(i, j) - x.get(i, j));
+					errAbs = std::max(errAbs, d);
+					//the values near 0 are subnormal in fp16, with fewer bits
+					if (fabs(x.get(i, j)) >= 1e-3f) {
+						errRel = std::max(errRel, d / fabs(x.get(i, j)));
+					}
+				}
+			}
+			printf("%-18s %dx%-4d %s  %7.2f MB vs %7.2f MB   max abs err: %.2e   max rel err (|x| >= 1e-3): %.2e\n",
+					files[f],
+					(int) x.m, (int) x.n, names[t], hx.bytes() / 1e6, x.length * sizeof(float) / 1e6, errAbs, errRel);
+		}
+	}
+	println("======================================================");
+	
+	//conversion throughput
+	CpuMatrix big = randn(4096, 1024);
+	CpuMatrix wide = CpuMatrix(4096, 1024, false);
+	double gb = big.length * (sizeof(float) + sizeof(uint16_t)) / 1e9;
+	for (int t = 0; t < 2; t++) {
+		CpuHalfMatrix hb = CpuHalfMatrix(big.m, big.n, types[t], false);
+		double toHalf = 1e30;
+		double fromHalf = 1e30;
+		for (int r = 0; r < 5; r++) {
+			double start = wall_millis();
+			cpu_to_half(types[t], big.ptr(), big.ld, hb.ptr(), hb.ld, big.m, big.n);
+			toHalf = std::min(toHalf, wall_millis() - start);
+			
+			start = wall_millis();
+			cpu_from_half(types[t], hb.ptr(), hb.ld, wide.ptr(), wide.ld, big.m, big.n);
+			fromHalf = std::min(fromHalf, wall_millis() - start);
+		}
+		printf("%s 4096x1024   to: %6.2f ms (%5.1f GB/s)   from: %6.2f ms (%5.1f GB/s)\n", names[t], toHalf,
+				gb / toHalf * 1e3, fromHalf, gb / fromHalf * 1e3);
+	}
+	println("======================================================");
+	
+	//the first layer on the adult data: x W and x^T dg, fp32 vs 16 bit x
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix yy = g.toMatrix(14, 15, false);
+	CpuMatrix y = yy.sltcols(0, 1);
+	
+	size_t hidden = 128;
+	CpuMatrix w = randn(x.n, hidden);
+	CpuMatrix dg = randn(x.m, hidden);
+	CpuMatrix fx = CpuMatrix(x.m, hidden, false);
+	CpuMatrix dw = CpuMatrix(x.n, hidden, false);
+	
+	double fxTime = 1e30;
+	double dwTime = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		x.dot(w, fx);
+		fxTime = std::min(fxTime, wall_millis() - start);
+		
+		start = wall_millis();
+		x.dot(true, dg, dw);
+		dwTime = std::min(dwTime, wall_millis() - start);
+	}
+	printf("fp32 x W: %7.2f ms   x^T dg: %7.2f ms\n", fxTime, dwTime);
+	
+	for (int t = 0; t < 2; t++) {
+		CpuHalfMatrix hx = g.toHalfMatrix(0, 14, true, types[t]);
+		CpuMatrix hfx = CpuMatrix(x.m, hidden, false);
+		CpuMatrix hdw = CpuMatrix(x.n, hidden, false);
+		
+		double hfxTime = 1e30;
+		double hdwTime = 1e30;
+		for (int r = 0; r < 5; r++) {
+			double start = wall_millis();
+			hx.dot(w, hfx);
+			hfxTime = std::min(hfxTime, wall_millis() - start);
+			
+			start = wall_millis();
+			hx.dot(true, dg, hdw);
+			hdwTime = std::min(hdwTime, wall_millis() - start);
+		}
+		
+		float errFx = sqrt(((fx - hfx) ^ 2).max() / (fx ^ 2).max());
+		float errDw = sqrt(((dw - hdw) ^ 2).max() / (dw ^ 2).max());
+		printf("%s x W: %7.2f ms   x^T dg: %7.2f ms   max err relative to the largest value: %.2e  %.2e\n",
+				names[t], hfxTime, hdwTime, errFx, errDw);
+	}
+	println("======================================================");
+	
+	//training from the same weights, small enough to keep the sigmoids out of saturation, with
+	//the iterations and the alpha of the adult data in quantized_performance
+	CpuMatrix w1 = randn(x.n, x.n) * 0.1f;
+	CpuVector b1 = CpuVector(x.n, true);
+	CpuMatrix w2 = randn(x.n, 1) * 0.1f;
+	CpuVector b2 = CpuVector(1, true);
+	int iter = 500;
+	float alpha = 0.01f;
+	
+	//the accuracy of a network that learned nothing
+	float positives = y.sum() / y.m;
+	printf("majority class: %5.2f%%\n", 100.0f * std::max(positives, 1.0f - positives));
+	
+	float error;
+	float accuracy;
+	double step = half_train(x, y, w1, b1, w2, b2, iter, alpha, error, accuracy);
+	printf("fp32 input   %d steps   %7.2f ms/step   J: %.6f   accuracy: %5.2f%%\n", iter, step, error, accuracy);
+	for (int t = 0; t < 2; t++) {
+		CpuHalfMatrix hx = g.toHalfMatrix(0, 14, true, types[t]);
+		float herror;
+		float haccuracy;
+		step = half_train(hx, y, w1, b1, w2, b2, iter, alpha, herror, haccuracy);
+		printf("%s input   %d steps   %7.2f ms/step   J: %.6f (%+.2e)   accuracy: %5.2f%% (%+.2f)\n", names[t], iter,
+				step, herror, herror - error, haccuracy, haccuracy - accuracy);
+	}
+	println("======================================================");
+}
+
+//Percentage of the rows classified right: the output above 0.5 for a single class, the
+//largest output for several.
+float class_accuracy(const CpuMatrix& h, const CpuMatrix& y) {
+	
+	size_t good = 0;
+	for (size_t i = 0; i < y.m; i++) {
+		if (y.n == 1) {
+			if ((h.get(i, 0) >= 0.5f) == (y.get(i, 0) == 1.0f)) {
+				good++;
+			}
+			continue;
+		}
+		
+		size_t best = 0;
+		for (size_t j = 1; j < y.n; j++) {
+			if (h.get(i, j) > h.get(i, best)) {
+				best = j;
+			}
+		}
+		if (y.get(i, best) == 1.0f) {
+			good++;
+		}
+	}
+	return 100.0f * good / y.m;
+}
+
+//Best of 10 forwards of the network, in milliseconds.
+double forward_millis(Network& n) {
+	double best = 1e30;
+	for (int r = 0; r < 10; r++) {
+		double start = wall_millis();
+		n.forward();
+		best = std::min(best, wall_millis() - start);
+	}
+	return best;
+}
+
+//Trains a network with a hidden layer on x, then compares its outputs and speed before
+//and after Network::quantize().
+void quantized_report(const char* name, CpuMatrix& x, CpuMatrix& y, int iter, float alpha) {
+	
+	size_t hidden = 32;
+	
+	Network n = Network();
+	n << Affine(x.n, hidden);
+	n << Sigmoid(hidden);
+	n << Affine(hidden, y.n);
+	n << Sigmoid(y.n);
+	n.set_alpha(alpha);
+	n.init(x, y, false);
+	n.train(iter);
+	
+	CpuMatrix h = cpu_cast(n.forward());
+	float error = n.min_square_error();
+	float accuracy = class_accuracy(h, y);
+	double millis = forward_millis(n);
+	
+	n.quantize();
+	
+	//right after quantize the error must already come from the int8 layers
+	float qerror = n.min_square_error();
+	CpuMatrix qh = cpu_cast(n.forward());
+	if (n.min_square_error() != qerror) {
+		throw Exception(
+				"The error after quantize is " + to_string(qerror) + ", after a forward pass "
+						+ to_string(n.min_square_error()) + ".");
+	}
+	float qaccuracy = class_accuracy(qh, y);
+	double qmillis = forward_millis(n);
+	
+	float diff = sqrt(((h - qh) ^ 2).max());
+	printf("%-6s %5dx%-3d fp32  J: %.6f  accuracy: %6.2f%%  forward: %7.3f ms\n", name, (int) x.m, (int) x.n, error,
+			accuracy, millis);
+	printf("%-6s %9s int8  J: %.6f  accuracy: %6.2f%%  forward: %7.3f ms  speedup: %4.2fx  max |h - qh|: %.4f\n", name,
+			"", qerror, qaccuracy, qmillis, millis / qmillis, diff);
+}
+
+void quantized_performance() {
+	
+	srand(7);
+	
+	println("int8 inference of the Affine layers");
+	println("======================================================");
+	
+	{
+		string data = ffull("files/iris.data");
+		Grid g = Grid(data);
+		CpuMatrix x = g.toMatrix(0, 4, true);
+		CpuMatrix y = g.toMatrix(4, 5, false);
+		quantized_report("iris", x, y, 5000, 0.1f);
+	}
+	
+	{
+		//the first column is the id, the class is 2 (benign) or 4 (malignant)
+		string data = ffull("files/cancer.data");
+		Grid g = Grid(data);
+		g.replace(10, "2", "0");
+		g.replace(10, "4", "1");
+		CpuMatrix x = g.toMatrix(1, 10, true);
+		CpuMatrix y = g.toMatrix(10, 11, false);
+		quantized_report("cancer", x, y, 2000, 0.1f);
+	}
+	
+	{
+		//a good wine has a quality of 7 or more
+		string data = ffull("files/winequality-white.data");
+		Grid g = Grid(data, ';');
+		const char* quality[] = { "3", "4", "5", "6", "7", "8", "9" };
+		for (int k = 0; k < 7; k++) {
+			g.replace(11, quality[k], k < 4 ? "0" : "1");
+		}
+		CpuMatrix x = g.toMatrix(0, 11, true);
+		CpuMatrix y = g.toMatrix(11, 12, false);
+		quantized_report("wine", x, y, 1000, 0.1f);
+	}
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix yy = g.toMatrix(14, 15, false);
+	CpuMatrix y = yy.sltcols(0, 1);
+	quantized_report("adult", x, y, 500, 0.01f);
+	println("======================================================");
+	
+	//a single wide layer, where the product dominates
+	size_t widths[] = { 32, 256 };
+	for (int k = 0; k < 2; k++) {
+		Affine f = Affine(x.n, widths[k]);
+		f.init();
+		QAffine q = QAffine(f);
+		
+		double fTime = 1e30;
+		double qTime = 1e30;
+		for (int r = 0; r < 10; r++) {
+			double start = wall_millis();
+			f.foward(x);
+			fTime = std::min(fTime, wall_millis() - start);
+			
+			start = wall_millis();
+			q.foward(x);
+			qTime = std::min(qTime, wall_millis() - start);
+		}
+		
+		CpuMatrix& fx = cpu_cast(f.get_fx());
+		CpuMatrix& qx = cpu_cast(q.get_fx());
+		float err = sqrt(((fx - qx) ^ 2).max() / (fx ^ 2).max());
+		printf("affine %dx%dx%d  fp32: %7.2f ms   int8: %7.2f ms   speedup: %4.2fx   max err relative to the largest value: %.2e\n",
+				(int) x.m, (int) x.n, (int) widths[k], fTime, qTime, fTime / qTime, err);
+	}
+	println("======================================================");
+}
+
+//Solves A w = c by Cholesky, where A is (n x n) symmetric positive definite and c is (n x 1).
+//It returns false when a pivot is not positive, when the rounding made A indefinite.
+template<class M>
+bool cholesky_solve(const M& a, const M& c, M& w) {
+	typedef typename M::value_type T;
+	
+	size_t n = a.m;
+	M l = M(n, n, true);
+	for (size_t j = 0; j < n; j++) {
+		T d = a.get(j, j);
+		for (size_t k = 0; k < j; k++) {
+			d -= l.get(j, k) * l.get(j, k);
+		}
+		if (d <= 0) {
+			return false;
+		}
+		
+		T ljj = sqrt(d);
+		l.set(j, j, ljj);
+		for (size_t i = j + 1; i < n; i++) {
+			T s = a.get(i, j);
+			for (size_t k = 0; k < j; k++) {
+				s -= l.get(i, k) * l.get(j, k);
+			}
+			l.set(i, j, s / ljj);
+		}
+	}
+	
+	//L z = c and then L^T w = z
+	for (size_t i = 0; i < n; i++) {
+		T s = c.get(i, 0);
+		for (size_t k = 0; k < i; k++) {
+			s -= l.get(i, k) * w.get(k, 0);
+		}
+		w.set(i, 0, s / l.get(i, i));
+	}
+	for (size_t i = n; i-- > 0;) {
+		T s = w.get(i, 0);
+		for (size_t k = i + 1; k < n; k++) {
+			s -= l.get(k, i) * w.get(k, 0);
+		}
+		w.set(i, 0, s / l.get(i, i));
+	}
+	
+	return true;
+}
+
+//Linear regression of y on x (and an intercept) from the normal equations x^T x w = x^T y,
+//computed in the element type of M. Returns the weights, the time in ms of the products and
+//the solve and the mean squared residual.
+template<class M>
+CpuDoubleMatrix least_squares(const CpuMatrix& x, const CpuMatrix& y, double& time, double& mse, bool& solved) {
+	
+	M x1 = M(x.m, x.n + 1, false);
+	for (size_t i = 0; i < x.m; i++) {
+		for (size_t j = 0; j < x.n; j++) {
+			x1.set(i, j, x.get(i, j));
+		}
+		x1.set(i, x.n, 1);
+	}
+	M y1 = M(y);
+	
+	time = 1e30;
+	M w = M(x1.n, 1, false);
+	for (int r = 0; r < 10; r++) {
+		double start = wall_millis();
+		M a = x1.dot(true, x1);
+		M c = x1.dot(true, y1);
+		solved = cholesky_solve(a, c, w);
+		time = std::min(time, wall_millis() - start);
+	}
+	
+	M h = x1.dot(w);
+	mse = ((h - y1) ^ 2).avg();
+	return CpuDoubleMatrix(w);
+}
+
+void double_performance() {
+	
+	println("double vs float, least squares on the wine quality");
+	println("======================================================");
+	
+	string data = ffull("files/winequality-white.data");
+	Grid g = Grid(data, ';');
+	CpuMatrix y = g.toMatrix(11, 12, false);
+	
+	//the raw inputs go from ~1 (density) to ~100 (sulfur dioxide), the normal equations
+	//square their condition number
+	const char* names[] = { "standardized", "raw" };
+	for (int k = 0; k < 2; k++) {
+		CpuMatrix x = g.toMatrix(0, 11, k == 0);
+		
+		double dTime, dMse, fTime, fMse;
+		bool dSolved, fSolved;
+		CpuDoubleMatrix dw = least_squares<CpuDoubleMatrix>(x, y, dTime, dMse, dSolved);
+		CpuDoubleMatrix fw = least_squares<CpuMatrix>(x, y, fTime, fMse, fSolved);
+		
+		double err = sqrt(((fw - dw) ^ 2).sum() / (dw ^ 2).sum());
+		printf("%-12s %dx%d  double: %6.3f ms  mse: %.6f%s   float: %6.3f ms  mse: %.6f%s   |wf - wd| / |wd|: %.2e\n",
+				names[k], (int) x.m, (int) x.n, dTime, dMse, dSolved ? "" : " (not solved)", fTime, fMse,
+				fSolved ? "" : " (not solved)", err);
+	}
+	println("======================================================");
+	
+	//throughput of the products, a double has twice the bytes and half the lanes
+	size_t sizes[] = { 256, 1024 };
+	for (int k = 0; k < 2; k++) {
+		size_t n = sizes[k];
+		CpuMatrix a = randn(n, n);
+		CpuMatrix b = randn(n, n);
+		CpuDoubleMatrix da = CpuDoubleMatrix(a);
+		CpuDoubleMatrix db = CpuDoubleMatrix(b);
+		CpuMatrix c = CpuMatrix(n, n, false);
+		CpuDoubleMatrix dc = CpuDoubleMatrix(n, n, false);
+		
+		double fTime = 1e30;
+		double dTime = 1e30;
+		for (int r = 0; r < 5; r++) {
+			double start = wall_millis();
+			a.dot(b, c);
+			fTime = std::min(fTime, wall_millis() - start);
+			
+			start = wall_millis();
+			da.dot(db, dc);
+			dTime = std::min(dTime, wall_millis() - start);
+		}
+		
+		double flops = 2.0 * n * n * n;
+		double err = sqrt(((CpuDoubleMatrix(c) - dc) ^ 2).max() / (dc ^ 2).max());
+		printf("gemm %dx%d  float: %7.2f ms (%6.1f GFLOP/s)   double: %7.2f ms (%6.1f GFLOP/s)   float err relative to the largest value: %.2e\n",
+				(int) n, (int) n, fTime, flops / fTime / 1e6, dTime, flops / dTime / 1e6, err);
+	}
+	println("======================================================");
+}
+
+//Trains In-Hidden-Out sigmoid layers on x, then compares the latency of a single sample
+//through the layers and through their FixedAffine/FixedSigmoid copies.
+template<size_t In, size_t Hidden, size_t Out>
+void fixed_report(const char* name, const CpuMatrix& x, const CpuMatrix& y, int iter, float alpha) {
+	
+	Affine f1 = Affine(In, Hidden);
+	Sigmoid s1 = Sigmoid(Hidden);
+	Affine f2 = Affine(Hidden, Out);
+	Sigmoid s2 = Sigmoid(Out);
+	f1.init();
+	s1.init();
+	f2.init();
+	s2.init();
+	
+	for (int i = 0; i < iter; i++) {
+		Matrix& h = s2.foward(f2.foward(s1.foward(f1.foward(x))));
+		
+		CpuMatrix dg = cpu_cast(h) - y;
+		f1.backward(s1.backward(f2.backward(s2.backward(dg))));
+		
+		f2.update(alpha / x.m);
+		f1.update(alpha / x.m);
+	}
+	CpuMatrix h = cpu_cast(s2.foward(f2.foward(s1.foward(f1.foward(x)))));
+	
+	FixedAffine<float, In, Hidden> a1 = FixedAffine<float, In, Hidden>(f1);
+	FixedSigmoid<float, Hidden> g1;
+	FixedAffine<float, Hidden, Out> a2 = FixedAffine<float, Hidden, Out>(f2);
+	FixedSigmoid<float, Out> g2;
+	
+	vector<FixedMatrix<float, 1, In> > samples(x.m);
+	for (size_t i = 0; i < x.m; i++) {
+		samples[i] = FixedMatrix<float, 1, In>(CpuMatrix(x.rows(i, i + 1)));
+	}
+	
+	float diff = 0.0f;
+	for (size_t i = 0; i < x.m; i++) {
+		FixedMatrix<float, 1, Out> fh = g2.foward(a2.foward(g1.foward(a1.foward(samples[i]))));
+		for (size_t j = 0; j < Out; j++) {
+			diff = std::max(diff, (float) fabs(fh.get(0, j) - h.get(i, j)));
+		}
+	}
+	
+	//the layers with a batch of one row
+	int reps = 20;
+	CpuMatrix xi = CpuMatrix(1, In, false);
+	double layerTime = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		for (int k = 0; k < reps; k++) {
+			for (size_t i = 0; i < x.m; i++) {
+				std::copy(samples[i].ptr(), samples[i].ptr() + In, xi.ptr());
+				s2.foward(f2.foward(s1.foward(f1.foward(xi))));
+			}
+		}
+		layerTime = std::min(layerTime, wall_millis() - start);
+	}
+	
+	reps = 2000;
+	volatile float sink = 0.0f;
+	double fixedTime = 1e30;
+	for (int r = 0; r < 5; r++) {
+		double start = wall_millis();
+		for (int k = 0; k < reps; k++) {
+			float acc = 0.0f;
+			for (size_t i = 0; i < x.m; i++) {
+				FixedMatrix<float, 1, Out> fh = g2.foward(a2.foward(g1.foward(a1.foward(samples[i]))));
+				acc += fh.get(0, 0);
+			}
+			sink = sink + acc;
+		}
+		fixedTime = std::min(fixedTime, wall_millis() - start);
+	}
+	
+	double layerNanos = layerTime * 1e6 / (20 * x.m);
+	double fixedNanos = fixedTime * 1e6 / (reps * x.m);
+	printf("%-6s %dx%dx%d  layers: %9.1f ns/sample   fixed: %7.1f ns/sample   speedup: %6.1fx   max |h - fh|: %.2e\n",
+			name, (int) In, (int) Hidden, (int) Out, layerNanos, fixedNanos, layerNanos / fixedNanos, diff);
+}
+
+void fixed_performance() {
+	
+	srand(7);
+	
+	println("single sample inference of the fixed size layers");
+	println("======================================================");
+	
+	{
+		string data = ffull("files/iris.data");
+		Grid g = Grid(data);
+		CpuMatrix x = g.toMatrix(0, 4, true);
+		CpuMatrix y = g.toMatrix(4, 5, false);
+		fixed_report<4, 8, 3>("iris", x, y, 2000, 1.0f);
+	}
+	
+	{
+		//the first column is the id, the class is 2 (benign) or 4 (malignant)
+		string data = ffull("files/cancer.data");
+		Grid g = Grid(data);
+		g.replace(10, "2", "0");
+		g.replace(10, "4", "1");
+		CpuMatrix x = g.toMatrix(1, 10, true);
+		CpuMatrix y = g.toMatrix(10, 11, false);
+		fixed_report<9, 8, 1>("cancer", x, y, 2000, 1.0f);
+	}
+	println("======================================================");
+}
+
+//GFLOP/s of the float products with the current blocking, best of 3.
+void gemm_gflops(const char* label) {
+	
+	CpuGemmConfig config = cpu_gemm_config();
+	const char* kernels[] = { "auto", "generic", "avx2", "avx512" };
+	printf("%-8s mc: %4d  kc: %4d  nc: %5d  kernel: %-7s", label, (int) config.mc, (int) config.kc, (int) config.nc,
+			kernels[config.kernel]);
+	
+	size_t sizes[] = { 256, 512, 1024 };
+	for (int k = 0; k < 3; k++) {
+		size_t n = sizes[k];
+		CpuMatrix a = randn(n, n);
+		CpuMatrix b = randn(n, n);
+		CpuMatrix c = CpuMatrix(n, n, false);
+		
+		double time = 1e30;
+		for (int r = 0; r < 3; r++) {
+			double start = wall_millis();
+			a.dot(b, c);
+			time = std::min(time, wall_millis() - start);
+		}
+		printf("   %d: %6.1f GFLOP/s", (int) n, 2.0 * n * n * n / time / 1e6);
+	}
+	println();
+}
+
+void gemm_tuning() {
+	
+	println("GEMM blocking tuned for this CPU");
+	println("======================================================");
+	
+	gemm_gflops("default");
+	
+	double start = wall_millis();
+	cpu_gemm_tune(512);
+	double time = wall_millis() - start;
+	gemm_gflops("tuned");
+	printf("tuning: %.1f s\n", time / 1000);
+	
+	//the file keeps one line per CPU
+	const char* path = "gemm_tuning.txt";
+	CpuGemmConfig tuned = cpu_gemm_config();
+	cpu_gemm_save(path);
+	
+	CpuGemmConfig other = { 48, 128, 1024, CPU_GEMM_GENERIC };
+	cpu_set_gemm_config(other);
+	bool loaded = cpu_gemm_load(path);
+	CpuGemmConfig back = cpu_gemm_config();
+	printf("saved and loaded: %s\n",
+			loaded && back.mc == tuned.mc && back.kc == tuned.kc && back.nc == tuned.nc && back.kernel == tuned.kernel ?
+					"ok" : "different");
+	remove(path);
+	println("======================================================");
+}
+
+//The hidden layer act(x W + b), as three passes (product, bias, activation) and as the
+//fused product, then the adult network forward with and without the fusion.
+void fused_performance() {
+	
+	println("Fused GEMM epilogues, act(x W + b)");
+	println("======================================================");
+	
+	const char* names[] = { "identity", "sigmoid", "relu", "tanh" };
+	size_t shapes[][3] = { { 256, 784, 256 }, { 1024, 784, 256 }, { 4096, 128, 128 }, { 4096, 1024, 1024 } };
+	
+	for (int s = 0; s < 4; s++) {
+		size_t m = shapes[s][0];
+		size_t n = shapes[s][1];
+		size_t p = shapes[s][2];
+		
+		CpuMatrix x = randn(m, n);
+		CpuMatrix w = randn(n, p);
+		CpuVector b = randn(p);
+		CpuMatrix fx = CpuMatrix(m, p, false);
+		CpuMatrix fused = CpuMatrix(m, p, false);
+		
+		for (int a = 1; a < 4; a++) {
+			CpuActivation act = (CpuActivation) a;
+			
+			double separate = 1e30;
+			double single = 1e30;
+			for (int r = 0; r < 5; r++) {
+				double start = wall_millis();
+				x.affine(w, b, fx);
+				cpu_activation(act, fx.ptr(), fx.ld, fx.ptr(), fx.ld, m, p);
+				separate = std::min(separate, wall_millis() - start);
+				
+				start = wall_millis();
+				x.affine(w, b, act, fused);
+				single = std::min(single, wall_millis() - start);
+			}
+			
+			float err = ((fused - fx) ^ 2).max();
+			printf("%4dx%4dx%4d  %-8s  3 passes: %8.3f ms   fused: %8.3f ms   speedup: %.2fx   max diff^2: %.1e\n",
+					(int) m, (int) n, (int) p, names[a], separate, single, separate / single, err);
+		}
+	}
+	println("======================================================");
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix yy = g.toMatrix(14, 15, false);
+	CpuMatrix y = yy.sltcols(0, 1);
+	
+	Network net = Network();
+	net << Affine(x.n, 128);
+	net << Sigmoid(128);
+	net << Affine(128, 128);
+	net << Sigmoid(128);
+	net << Affine(128, y.n);
+	net << Sigmoid(y.n);
+	net.init(x, y, false);
+	
+	double times[2];
+	float errors[2];
+	for (int f = 0; f < 2; f++) {
+		net.set_fused(f == 1);
+		
+		times[f] = 1e30;
+		for (int r = 0; r < 5; r++) {
+			double start = wall_millis();
+			net.forward();
+			times[f] = std::min(times[f], wall_millis() - start);
+		}
+		errors[f] = net.min_square_error();
+	}
+	printf("adult forward %d rows  separate: %.3f ms   fused: %.3f ms   speedup: %.2fx   mse %.6f / %.6f\n",
+			(int) x.m, times[0], times[1], times[0] / times[1], errors[0], errors[1]);
+	println("======================================================");
+}
+
+//Minibatches of changing sizes on the adult data, the fx and dx of the layers come from the
+//workspace of the network: after the first epoch a step does not allocate.
+void workspace_test() {
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix yy = g.toMatrix(14, 15, false);
+	CpuMatrix y = yy.sltcols(0, 1);
+	
+	Network net = Network();
+	net << Affine(x.n, 128);
+	net << Sigmoid(128);
+	net << Affine(128, 128);
+	net << Sigmoid(128);
+	net << Affine(128, y.n);
+	net << Sigmoid(y.n);
+	net.init(x, y, false);
+	
+	println("Workspace of the network, minibatches of 256, 1000 and 64 rows on the adult data");
+	println("======================================================");
+	
+	size_t sizes[] = { 256, 1000, 64 };
+	for (int epoch = 0; epoch < 3; epoch++) {
+		size_t before = cpu_allocations();
+		size_t steps = 0;
+		double start = wall_millis();
+		
+		for (size_t i = 0; i < x.m; steps++) {
+			size_t rows = std::min(sizes[steps % 3], x.m - i);
+			MatrixView bx = x.rows(i, i + rows);
+			MatrixView by = y.rows(i, i + rows);
+			
+			net.set_batch(bx, by);
+			net.train(1);
+			i += rows;
+		}
+		
+		double time = wall_millis() - start;
+		const Workspace& ws = net.get_workspace();
+		printf("epoch %d  %d steps  %7.2f ms  cpu_malloc calls: %d   workspace: %.2f MB, high water %.2f MB\n", epoch,
+				(int) steps, time, (int) (cpu_allocations() - before), ws.capacity() * 4.0 / (1 << 20),
+				ws.high_water() * 4.0 / (1 << 20));
+	}
+	
+	net.set_batch(x, y);
+	printf("mse: %.6f\n", net.min_square_error());
+	println("======================================================");
+}
+
+void pool_performance() {
+	
+	println("Temporaries of the operators with the system and the pool allocator");
+	println("======================================================");
+	
+	const char* names[] = { "system", "pool" };
+	CpuAllocator allocators[] = { cpu_system_allocator(), cpu_pool_allocator() };
+	size_t sizes[] = { 8, 32, 128, 512 };
+	
+	for (size_t s = 0; s < 4; s++) {
+		size_t n = sizes[s];
+		CpuMatrix a = cs::math::randn(n, n);
+		CpuVector v = cs::math::randn(n);
+		
+		//about the same work for each size
+		size_t reps = std::max((size_t) 4, (size_t) 4000000 / (n * n));
+		
+		printf("%4dx%-4d", (int) n, (int) n);
+		for (int k = 0; k < 2; k++) {
+			cpu_set_allocator(allocators[k]);
+			cpu_pool_trim();
+			
+			double best = 1e30;
+			for (int r = 0; r < 3; r++) {
+				double start = wall_millis();
+				for (size_t i = 0; i < reps; i++) {
+					CpuMatrix t(n, n);
+					CpuVector u = a.dot(v);
+					t.ptr()[0] = u.ptr()[0];
+				}
+				best = std::min(best, wall_millis() - start);
+			}
+			printf("   %s: %8.3f us", names[k], best * 1000 / reps);
+		}
+		println();
+	}
+	
+	CpuPoolStats stats = cpu_pool_stats();
+	printf("hits: %d  misses: %d  huge: %d  retained: %.2f MB\n", (int) stats.hits, (int) stats.misses,
+			(int) stats.huge, stats.retained / (1024.0 * 1024.0));
+	printf("trim: %.2f MB\n", cpu_pool_trim() / (1024.0 * 1024.0));
+	println("======================================================");
+}
+
+void memory_performance() {
+	
+	println("Memory policies of large matrices, 1536x1536 products");
+	println("======================================================");
+	printf("NUMA nodes: %d\n", (int) cpu_numa_nodes());
+	
+	const char* names[] = { "small pages", "transparent", "huge, interleave, touch" };
+	CpuMemoryPolicy policies[] = { { CPU_PAGES_SMALL, CPU_PLACE_LOCAL, 0, false }, { CPU_PAGES_TRANSPARENT,
+			CPU_PLACE_LOCAL, 0, false }, { CPU_PAGES_HUGE, CPU_PLACE_INTERLEAVE, 0, true } };
+	size_t n = 1536;
+	
+	for (int k = 0; k < 3; k++) {
+		double start = wall_millis();
+		CpuMatrix a(n, n, n, false, policies[k]);
+		CpuMatrix b(n, n, n, false, policies[k]);
+		CpuMatrix c(n, n, n, false, policies[k]);
+		a.randn();
+		b.randn();
+		double fill = wall_millis() - start;
+		
+		double best = 1e30;
+		for (int r = 0; r < 3; r++) {
+			start = wall_millis();
+			a.dot(b, c);
+			best = std::min(best, wall_millis() - start);
+		}
+		
+		CpuMemoryInfo info;
+		if (cpu_memory_info(c.ptr(), info) == false) {
+			strcpy(info.policy, "?");
+		}
+		printf("%-24s  fill: %7.2f ms  product: %7.2f ms   %s, %d KB pages, %.1f MB huge\n", names[k], fill, best,
+				info.policy, (int) (info.page_bytes >> 10), info.huge_bytes / (1024.0 * 1024.0));
+	}
+	println("======================================================");
+}
+
+void memory_tracking() {
+	
+	cpu_set_memory_tracking(true);
+	
+	string data = ffull("files/adult.data");
+	Grid g = Grid(data);
+	CpuMatrix x = g.toMatrix(0, 14, true);
+	CpuMatrix yy = g.toMatrix(14, 15, false);
+	CpuMatrix y = yy.sltcols(0, 1);
+	
+	Network net = Network();
+	net << Affine(x.n, 128);
+	net << Sigmoid(128);
+	net << Affine(128, y.n);
+	net << Sigmoid(y.n);
+	net.init(x, y, false);
+	
+	MatrixView bx = x.rows(0, 256);
+	MatrixView by = y.rows(0, 256);
+	net.set_batch(bx, by);
+	
+	println("Memory of the adult data and a network, after the first step");
+	println("======================================================");
+	net.train(1);
+	cpu_print_memory();
+	
+	//the workspace already has room for the batch
+	cpu_reset_memory_peaks();
+	size_t before = cpu_memory_stats().total.allocations;
+	{
+		CpuNoAllocations none;
+		net.train(10);
+	}
+	printf("10 more steps: %d allocations\n", (int) (cpu_memory_stats().total.allocations - before));
+	
+	try {
+		CpuNoAllocations none;
+		CpuMatrix t = x.rows(0, 2);
+		printf("the copy was allocated: %d rows\n", (int) t.m);
+	} catch (Exception& e) {
+		printf("the copy was caught: %s\n", e.what());
+	}
+	println("======================================================");
+	
+	cpu_set_memory_tracking(false);
+}
+
 void test1() {
 	GpuMatrix a = { { 1, 2, 3 }, { 4, 5, 6 } };
 	GpuMatrix b = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
@@ -610,7 +2468,7 @@ void test_data() {
 	s2.set_dim(f2.out_dim());
 	s2.init();
 	
-
+	
 	
 	println("About to train");
 	int iter = 100000;
@@ -969,6 +2827,29 @@ int main(void) {
 	memtest();
 	println("ok");
 	
+	//gemm_performance();
+	//thread_scaling();
+	//train_performance();
+	//expression_performance();
+	//padding_test();
+	//view_performance();
+	//reduction_performance();
+	//sigmoid_performance();
+	//broadcast_performance();
+	//transpose_performance();
+	//gemv_performance();
+	//sparse_performance();
+	//half_performance();
+	//quantized_performance();
+	//double_performance();
+	//fixed_performance();
+	//gemm_tuning();
+	//fused_performance();
+	//workspace_test();
+	//pool_performance();
+	//memory_performance();
+	//memory_tracking();
+	//allocation_test();
 	//adult_data_cpu();
 	//networktest();
 	//adult_data_gpu();
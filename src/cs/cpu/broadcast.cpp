@@ -0,0 +1,227 @@
+/*
+ * broadcast.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+namespace cpu {
+
+//Broadcasts read each element once and write it once, so they are bound by memory
+//and there is no AVX-512 version, AVX2 already saturates it.
+
+//Elements of one task.
+static const size_t BROADCAST_CHUNK = 1 << 14;
+
+template<typename T>
+struct BroadcastKernels {
+	//dest[j] = a[j] op b[j]
+	void (*vector)(CpuOp op, const T* a, const T* b, T* dest, size_t l);
+	//dest[j] = a[j] op s
+	void (*scalar)(CpuOp op, const T* a, T s, T* dest, size_t l);
+};
+
+//Generic
+//=============================================================================
+template<typename T>
+static inline T apply(CpuOp op, T a, T b) {
+	switch (op) {
+	case CPU_ADD:
+		return a + b;
+	case CPU_SUB:
+		return a - b;
+	case CPU_MUL:
+		return a * b;
+	default:
+		return a / b;
+	}
+}
+
+template<typename T>
+static void vector_generic(CpuOp op, const T* a, const T* b, T* dest, size_t l) {
+	for (size_t j = 0; j < l; j++) {
+		dest[j] = apply(op, a[j], b[j]);
+	}
+}
+
+template<typename T>
+static void scalar_generic(CpuOp op, const T* a, T s, T* dest, size_t l) {
+	for (size_t j = 0; j < l; j++) {
+		dest[j] = apply(op, a[j], s);
+	}
+}
+
+#ifdef CS_CPU_X86
+
+//AVX2
+//=============================================================================
+CS_TARGET("avx2,fma")
+static inline __m256 apply_avx2(CpuOp op, __m256 a, __m256 b) {
+	switch (op) {
+	case CPU_ADD:
+		return _mm256_add_ps(a, b);
+	case CPU_SUB:
+		return _mm256_sub_ps(a, b);
+	case CPU_MUL:
+		return _mm256_mul_ps(a, b);
+	default:
+		return _mm256_div_ps(a, b);
+	}
+}
+
+CS_TARGET("avx2,fma")
+static void vector_avx2(CpuOp op, const float* a, const float* b, float* dest, size_t l) {
+	size_t j = 0;
+	for (; j + 8 <= l; j += 8) {
+		_mm256_storeu_ps(dest + j, apply_avx2(op, _mm256_loadu_ps(a + j), _mm256_loadu_ps(b + j)));
+	}
+	//the tail is SSE code, without clearing the upper halves every row pays an AVX to SSE transition
+	_mm256_zeroupper();
+	vector_generic(op, a + j, b + j, dest + j, l - j);
+}
+
+CS_TARGET("avx2,fma")
+static void scalar_avx2(CpuOp op, const float* a, float s, float* dest, size_t l) {
+	const __m256 vs = _mm256_set1_ps(s);
+	
+	size_t j = 0;
+	for (; j + 8 <= l; j += 8) {
+		_mm256_storeu_ps(dest + j, apply_avx2(op, _mm256_loadu_ps(a + j), vs));
+	}
+	_mm256_zeroupper();
+	scalar_generic(op, a + j, s, dest + j, l - j);
+}
+
+//AVX2, doubles
+//=============================================================================
+CS_TARGET("avx2,fma")
+static inline __m256d apply_avx2(CpuOp op, __m256d a, __m256d b) {
+	switch (op) {
+	case CPU_ADD:
+		return _mm256_add_pd(a, b);
+	case CPU_SUB:
+		return _mm256_sub_pd(a, b);
+	case CPU_MUL:
+		return _mm256_mul_pd(a, b);
+	default:
+		return _mm256_div_pd(a, b);
+	}
+}
+
+CS_TARGET("avx2,fma")
+static void vector_avx2(CpuOp op, const double* a, const double* b, double* dest, size_t l) {
+	size_t j = 0;
+	for (; j + 4 <= l; j += 4) {
+		_mm256_storeu_pd(dest + j, apply_avx2(op, _mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j)));
+	}
+	_mm256_zeroupper();
+	vector_generic(op, a + j, b + j, dest + j, l - j);
+}
+
+CS_TARGET("avx2,fma")
+static void scalar_avx2(CpuOp op, const double* a, double s, double* dest, size_t l) {
+	const __m256d vs = _mm256_set1_pd(s);
+	
+	size_t j = 0;
+	for (; j + 4 <= l; j += 4) {
+		_mm256_storeu_pd(dest + j, apply_avx2(op, _mm256_loadu_pd(a + j), vs));
+	}
+	_mm256_zeroupper();
+	scalar_generic(op, a + j, s, dest + j, l - j);
+}
+
+#endif
+
+//The kernels of each element type are overloads with the same names.
+template<typename T>
+static const BroadcastKernels<T>& broadcast_kernels() {
+	
+	static const BroadcastKernels<T> generic = { vector_generic, scalar_generic };
+#ifdef CS_CPU_X86
+	static const BroadcastKernels<T> avx2 = { vector_avx2, scalar_avx2 };
+	
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+//DEST = A op b, b along the rows (n values) or along the columns (m values).
+template<typename T>
+struct BroadcastJob {
+	CpuOp op;
+	bool cols;
+	const T* a;
+	size_t lda;
+	const T* b;
+	T* dest;
+	size_t ldd;
+	size_t m;
+	size_t n;
+	size_t rows;
+};
+
+template<typename T>
+static void broadcast_chunk(size_t task, void* ctx) {
+	
+	const BroadcastJob<T>& job = *(const BroadcastJob<T>*) ctx;
+	const BroadcastKernels<T>& k = broadcast_kernels<T>();
+	
+	size_t start = task * job.rows;
+	size_t end = std::min(job.m, start + job.rows);
+	
+	for (size_t i = start; i < end; i++) {
+		const T* a = job.a + i * job.lda;
+		T* dest = job.dest + i * job.ldd;
+	
+		if (job.cols) {
+			k.scalar(job.op, a, job.b[i], dest, job.n);
+		} else {
+			k.vector(job.op, a, job.b, dest, job.n);
+		}
+	}
+}
+
+template<typename T>
+static void broadcast(CpuOp op, bool cols, const T* a, size_t lda, const T* b, T* dest, size_t ldd, size_t m,
+		size_t n) {
+	
+	if (m == 0 || n == 0) {
+		return;
+	}
+	
+	BroadcastJob<T> job = { op, cols, a, lda, b, dest, ldd, m, n, 0 };
+	job.rows = std::max((size_t) 1, BROADCAST_CHUNK / n);
+	
+	cpu_parallel((m + job.rows - 1) / job.rows, broadcast_chunk<T>, &job);
+}
+
+void cpu_broadcast_rows(CpuOp op, float* a, size_t lda, float* b, float* dest, size_t ldd, size_t m, size_t n) {
+	broadcast(op, false, a, lda, b, dest, ldd, m, n);
+}
+
+void cpu_broadcast_cols(CpuOp op, float* a, size_t lda, float* b, float* dest, size_t ldd, size_t m, size_t n) {
+	broadcast(op, true, a, lda, b, dest, ldd, m, n);
+}
+
+void cpu_broadcast_rows(CpuOp op, double* a, size_t lda, double* b, double* dest, size_t ldd, size_t m, size_t n) {
+	broadcast(op, false, a, lda, b, dest, ldd, m, n);
+}
+
+void cpu_broadcast_cols(CpuOp op, double* a, size_t lda, double* b, double* dest, size_t ldd, size_t m, size_t n) {
+	broadcast(op, true, a, lda, b, dest, ldd, m, n);
+}
+
+} // namespace cpu
+} // namespace cs
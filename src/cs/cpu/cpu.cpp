@@ -0,0 +1,201 @@
+/*
+ * cpu.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace cs {
+using namespace core;
+namespace cpu {
+
+static std::atomic<size_t> allocations(0);
+
+bool cpu_has_avx2() {
+#ifdef CS_CPU_X86
+	static const bool ans = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	return ans;
+#else
+	return false;
+#endif
+}
+
+bool cpu_has_avx512() {
+#ifdef CS_CPU_X86
+	static const bool ans = __builtin_cpu_supports("avx512f");
+	return ans;
+#else
+	return false;
+#endif
+}
+
+bool cpu_has_avx_vnni() {
+#ifdef CS_CPU_VNNI
+	static const bool ans = cpu_has_avx2() && __builtin_cpu_supports("avxvnni");
+	return ans;
+#else
+	return false;
+#endif
+}
+
+bool cpu_has_avx512_vnni() {
+#ifdef CS_CPU_VNNI
+	static const bool ans = cpu_has_avx2() && __builtin_cpu_supports("avx512vnni")
+			&& __builtin_cpu_supports("avx512vl");
+	return ans;
+#else
+	return false;
+#endif
+}
+
+//Memory
+//=============================================================================
+//Every buffer starts with CPU_ALIGNMENT bytes that hold the allocator that gave it and its
+//size, so cpu_free releases it to the same allocator even after cpu_set_allocator, and the
+//bytes counted by the tracker (0 when it was off).
+struct BufferHeader {
+	CpuAllocator allocator;
+	size_t bytes;
+	size_t tracked;
+	CpuMemoryCategory category;
+};
+
+static_assert(sizeof(BufferHeader) <= CPU_ALIGNMENT, "The header of the buffers must fit in CPU_ALIGNMENT bytes.");
+
+static CpuAllocator& current_allocator() {
+	static CpuAllocator allocator = cpu_pool_allocator();
+	return allocator;
+}
+
+void cpu_set_allocator(CpuAllocator allocator) {
+	if (allocator.allocate == nullptr || allocator.release == nullptr) {
+		throw Exception("The allocator must have both allocate and release.");
+	}
+	current_allocator() = allocator;
+}
+
+//The buffers of a memory policy come from memory_map, their header only releases them.
+static void mapped_release(void* ptr, size_t bytes, void*) {
+	memory_unmap(ptr, bytes);
+}
+
+static bool default_policy(const CpuMemoryPolicy& policy) {
+	return policy.pages == CPU_PAGES_SMALL && policy.placement == CPU_PLACE_LOCAL && policy.parallel_touch == false;
+}
+
+//length values of size bytes
+static void* allocate(size_t length, size_t size, bool clear, const CpuMemoryPolicy& policy) {
+	
+	if (length < 1) {
+		throw Exception("Invalid length " + to_string(length) + ".");
+	}
+	
+	memory_check(size * length);
+	
+	CpuAllocator allocator = current_allocator();
+	const size_t bytes = CPU_ALIGNMENT + size * length;
+	
+	char* base;
+	if (bytes >= CPU_HUGE_PAGE && default_policy(policy) == false) {
+		base = (char*) memory_map(bytes, policy);
+		allocator.allocate = nullptr;
+		allocator.release = mapped_release;
+		allocator.ctx = nullptr;
+		
+		//the mappings start zeroed
+		clear = false;
+	} else {
+		base = (char*) allocator.allocate(bytes, allocator.ctx);
+	}
+	
+	if (base == nullptr) {
+		throw Exception("Could not allocate " + to_string(length) + " values of " + to_string(size) + " bytes.");
+	}
+	
+	BufferHeader* header = (BufferHeader*) base;
+	header->allocator = allocator;
+	header->bytes = bytes;
+	header->category = memory_category();
+	header->tracked = cpu_track_memory(header->category, size * length);
+	
+	void* ptr = base + CPU_ALIGNMENT;
+	if (clear) {
+		memset(ptr, 0, size * length);
+	}
+	
+	allocations++;
+	return ptr;
+}
+
+static void release(void* ptr) {
+	
+	if (ptr == nullptr) {
+		return;
+	}
+	
+	char* base = (char*) ptr - CPU_ALIGNMENT;
+	const BufferHeader* header = (const BufferHeader*) base;
+	cpu_untrack_memory(header->category, header->tracked);
+	header->allocator.release(base, header->bytes, header->allocator.ctx);
+}
+
+float* cpu_malloc(size_t length, bool clear) {
+	return (float*) allocate(length, sizeof(float), clear, cpu_memory_policy());
+}
+
+void cpu_free(float* ptr) {
+	release(ptr);
+}
+
+template<>
+float* cpu_malloc<float>(size_t length, bool clear) {
+	return cpu_malloc(length, clear);
+}
+
+template<>
+double* cpu_malloc<double>(size_t length, bool clear) {
+	return (double*) allocate(length, sizeof(double), clear, cpu_memory_policy());
+}
+
+template<>
+float* cpu_malloc<float>(size_t length, bool clear, const CpuMemoryPolicy& policy) {
+	return (float*) allocate(length, sizeof(float), clear, policy);
+}
+
+template<>
+double* cpu_malloc<double>(size_t length, bool clear, const CpuMemoryPolicy& policy) {
+	return (double*) allocate(length, sizeof(double), clear, policy);
+}
+
+void cpu_free(double* ptr) {
+	release(ptr);
+}
+
+size_t cpu_allocations() {
+	return allocations.load();
+}
+
+size_t cpu_padded(size_t n) {
+	const size_t floats = CPU_ALIGNMENT / sizeof(float);
+	return (n + floats - 1) / floats * floats;
+}
+
+//Blas
+//=============================================================================
+void cpu_add_inplace(float* a, float* b, const float alpha, size_t l) {
+	for (size_t i = 0; i < l; i++) {
+		a[i] += alpha * b[i];
+	}
+}
+
+} // namespace cpu
+} // namespace cs
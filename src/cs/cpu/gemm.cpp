@@ -0,0 +1,872 @@
+/*
+ * gemm.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+using namespace core;
+namespace cpu {
+
+size_t GEMM_MC = 96;
+size_t GEMM_KC = 384;
+size_t GEMM_NC = 4096;
+CpuGemmKernel GEMM_KERNEL = CPU_GEMM_AUTO;
+size_t GEMM_SMALL = 32 * 32 * 32;
+size_t GEMM_PARALLEL = 128 * 128 * 128;
+
+//The engine follows the GotoBLAS/BLIS layout: C is computed in MR x NR tiles by a
+//micro-kernel that reads a packed panel of A (kc x MR, column by column) and a packed
+//panel of B (kc x NR, row by row). Packing makes both streams contiguous and aligned.
+//
+//The micro-kernel either stores the tile (first panel of k, beta = 0) or adds it to C,
+//so C is never cleared before the product. A fused product (cpu_gemm_fused) applies
+//its epilogue to each tile right after the last panel of k is stored.
+//
+//Every element type has its own micro-kernels, a register holds half as many doubles
+//as floats so their tiles are half as wide.
+template<typename T>
+using gemm_kernel_fn = void (*)(size_t k, const T* a, const T* b, T* c, size_t ldc, bool acc);
+
+template<typename T>
+struct GemmKernel {
+	size_t mr;
+	size_t nr;
+	gemm_kernel_fn<T> fn;
+};
+
+static const size_t GEMM_MAX_MR = 12;
+static const size_t GEMM_MAX_NR = 32;
+
+template<typename T>
+static void kernel_generic_4x8(size_t k, const T* a, const T* b, T* c, size_t ldc, bool acc) {
+	
+	T ab[4 * 8] = { 0 };
+	
+	for (size_t l = 0; l < k; l++) {
+		for (size_t i = 0; i < 4; i++) {
+			const T ai = a[i];
+			for (size_t j = 0; j < 8; j++) {
+				ab[i * 8 + j] += ai * b[j];
+			}
+		}
+		a += 4;
+		b += 8;
+	}
+	
+	for (size_t i = 0; i < 4; i++) {
+		for (size_t j = 0; j < 8; j++) {
+			if (acc) {
+				c[i * ldc + j] += ab[i * 8 + j];
+			} else {
+				c[i * ldc + j] = ab[i * 8 + j];
+			}
+		}
+	}
+}
+
+#ifdef CS_CPU_X86
+
+CS_TARGET("avx2,fma")
+static void kernel_avx2_6x16(size_t k, const float* a, const float* b, float* c, size_t ldc, bool acc) {
+	
+	__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+	__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+	__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+	__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+	__m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+	__m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+	
+	for (size_t l = 0; l < k; l++) {
+		const __m256 b0 = _mm256_load_ps(b);
+		const __m256 b1 = _mm256_load_ps(b + 8);
+		__m256 ai;
+		
+		ai = _mm256_broadcast_ss(a + 0);
+		c00 = _mm256_fmadd_ps(ai, b0, c00);
+		c01 = _mm256_fmadd_ps(ai, b1, c01);
+		ai = _mm256_broadcast_ss(a + 1);
+		c10 = _mm256_fmadd_ps(ai, b0, c10);
+		c11 = _mm256_fmadd_ps(ai, b1, c11);
+		ai = _mm256_broadcast_ss(a + 2);
+		c20 = _mm256_fmadd_ps(ai, b0, c20);
+		c21 = _mm256_fmadd_ps(ai, b1, c21);
+		ai = _mm256_broadcast_ss(a + 3);
+		c30 = _mm256_fmadd_ps(ai, b0, c30);
+		c31 = _mm256_fmadd_ps(ai, b1, c31);
+		ai = _mm256_broadcast_ss(a + 4);
+		c40 = _mm256_fmadd_ps(ai, b0, c40);
+		c41 = _mm256_fmadd_ps(ai, b1, c41);
+		ai = _mm256_broadcast_ss(a + 5);
+		c50 = _mm256_fmadd_ps(ai, b0, c50);
+		c51 = _mm256_fmadd_ps(ai, b1, c51);
+		
+		a += 6;
+		b += 16;
+	}
+	
+	__m256 rows[12] = { c00, c01, c10, c11, c20, c21, c30, c31, c40, c41, c50, c51 };
+	for (size_t i = 0; i < 6; i++) {
+		float* ci = c + i * ldc;
+		__m256 r0 = rows[2 * i];
+		__m256 r1 = rows[2 * i + 1];
+		if (acc) {
+			r0 = _mm256_add_ps(_mm256_loadu_ps(ci), r0);
+			r1 = _mm256_add_ps(_mm256_loadu_ps(ci + 8), r1);
+		}
+		_mm256_storeu_ps(ci, r0);
+		_mm256_storeu_ps(ci + 8, r1);
+	}
+}
+
+CS_TARGET("avx512f")
+static void kernel_avx512_12x32(size_t k, const float* a, const float* b, float* c, size_t ldc, bool acc) {
+	
+#define CS_ROW_DECL(i) __m512 c##i##0 = _mm512_setzero_ps(), c##i##1 = _mm512_setzero_ps();
+#define CS_ROW_FMA(i) ai = _mm512_set1_ps(a[i]); \
+		c##i##0 = _mm512_fmadd_ps(ai, b0, c##i##0); \
+		c##i##1 = _mm512_fmadd_ps(ai, b1, c##i##1);
+#define CS_ROW_STORE(i) { \
+		float* ci = c + i * ldc; \
+		if (acc) { \
+			c##i##0 = _mm512_add_ps(_mm512_loadu_ps(ci), c##i##0); \
+			c##i##1 = _mm512_add_ps(_mm512_loadu_ps(ci + 16), c##i##1); \
+		} \
+		_mm512_storeu_ps(ci, c##i##0); \
+		_mm512_storeu_ps(ci + 16, c##i##1); }
+	
+	CS_ROW_DECL(0) CS_ROW_DECL(1) CS_ROW_DECL(2) CS_ROW_DECL(3)
+	CS_ROW_DECL(4) CS_ROW_DECL(5) CS_ROW_DECL(6) CS_ROW_DECL(7)
+	CS_ROW_DECL(8) CS_ROW_DECL(9) CS_ROW_DECL(10) CS_ROW_DECL(11)
+	
+	for (size_t l = 0; l < k; l++) {
+		const __m512 b0 = _mm512_load_ps(b);
+		const __m512 b1 = _mm512_load_ps(b + 16);
+		__m512 ai;
+		
+		CS_ROW_FMA(0) CS_ROW_FMA(1) CS_ROW_FMA(2) CS_ROW_FMA(3)
+		CS_ROW_FMA(4) CS_ROW_FMA(5) CS_ROW_FMA(6) CS_ROW_FMA(7)
+		CS_ROW_FMA(8) CS_ROW_FMA(9) CS_ROW_FMA(10) CS_ROW_FMA(11)
+		
+		a += 12;
+		b += 32;
+	}
+	
+	CS_ROW_STORE(0) CS_ROW_STORE(1) CS_ROW_STORE(2) CS_ROW_STORE(3)
+	CS_ROW_STORE(4) CS_ROW_STORE(5) CS_ROW_STORE(6) CS_ROW_STORE(7)
+	CS_ROW_STORE(8) CS_ROW_STORE(9) CS_ROW_STORE(10) CS_ROW_STORE(11)
+	
+#undef CS_ROW_DECL
+#undef CS_ROW_FMA
+#undef CS_ROW_STORE
+}
+
+CS_TARGET("avx2,fma")
+static void kernel_avx2_6x8(size_t k, const double* a, const double* b, double* c, size_t ldc, bool acc) {
+	
+	__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+	__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+	__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+	__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+	__m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+	__m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+	
+	for (size_t l = 0; l < k; l++) {
+		const __m256d b0 = _mm256_load_pd(b);
+		const __m256d b1 = _mm256_load_pd(b + 4);
+		__m256d ai;
+		
+		ai = _mm256_broadcast_sd(a + 0);
+		c00 = _mm256_fmadd_pd(ai, b0, c00);
+		c01 = _mm256_fmadd_pd(ai, b1, c01);
+		ai = _mm256_broadcast_sd(a + 1);
+		c10 = _mm256_fmadd_pd(ai, b0, c10);
+		c11 = _mm256_fmadd_pd(ai, b1, c11);
+		ai = _mm256_broadcast_sd(a + 2);
+		c20 = _mm256_fmadd_pd(ai, b0, c20);
+		c21 = _mm256_fmadd_pd(ai, b1, c21);
+		ai = _mm256_broadcast_sd(a + 3);
+		c30 = _mm256_fmadd_pd(ai, b0, c30);
+		c31 = _mm256_fmadd_pd(ai, b1, c31);
+		ai = _mm256_broadcast_sd(a + 4);
+		c40 = _mm256_fmadd_pd(ai, b0, c40);
+		c41 = _mm256_fmadd_pd(ai, b1, c41);
+		ai = _mm256_broadcast_sd(a + 5);
+		c50 = _mm256_fmadd_pd(ai, b0, c50);
+		c51 = _mm256_fmadd_pd(ai, b1, c51);
+		
+		a += 6;
+		b += 8;
+	}
+	
+	__m256d rows[12] = { c00, c01, c10, c11, c20, c21, c30, c31, c40, c41, c50, c51 };
+	for (size_t i = 0; i < 6; i++) {
+		double* ci = c + i * ldc;
+		__m256d r0 = rows[2 * i];
+		__m256d r1 = rows[2 * i + 1];
+		if (acc) {
+			r0 = _mm256_add_pd(_mm256_loadu_pd(ci), r0);
+			r1 = _mm256_add_pd(_mm256_loadu_pd(ci + 4), r1);
+		}
+		_mm256_storeu_pd(ci, r0);
+		_mm256_storeu_pd(ci + 4, r1);
+	}
+}
+
+CS_TARGET("avx512f")
+static void kernel_avx512_12x16(size_t k, const double* a, const double* b, double* c, size_t ldc, bool acc) {
+	
+#define CS_ROW_DECL(i) __m512d c##i##0 = _mm512_setzero_pd(), c##i##1 = _mm512_setzero_pd();
+#define CS_ROW_FMA(i) ai = _mm512_set1_pd(a[i]); \
+		c##i##0 = _mm512_fmadd_pd(ai, b0, c##i##0); \
+		c##i##1 = _mm512_fmadd_pd(ai, b1, c##i##1);
+#define CS_ROW_STORE(i) { \
+		double* ci = c + i * ldc; \
+		if (acc) { \
+			c##i##0 = _mm512_add_pd(_mm512_loadu_pd(ci), c##i##0); \
+			c##i##1 = _mm512_add_pd(_mm512_loadu_pd(ci + 8), c##i##1); \
+		} \
+		_mm512_storeu_pd(ci, c##i##0); \
+		_mm512_storeu_pd(ci + 8, c##i##1); }
+	
+	CS_ROW_DECL(0) CS_ROW_DECL(1) CS_ROW_DECL(2) CS_ROW_DECL(3)
+	CS_ROW_DECL(4) CS_ROW_DECL(5) CS_ROW_DECL(6) CS_ROW_DECL(7)
+	CS_ROW_DECL(8) CS_ROW_DECL(9) CS_ROW_DECL(10) CS_ROW_DECL(11)
+	
+	for (size_t l = 0; l < k; l++) {
+		const __m512d b0 = _mm512_load_pd(b);
+		const __m512d b1 = _mm512_load_pd(b + 8);
+		__m512d ai;
+		
+		CS_ROW_FMA(0) CS_ROW_FMA(1) CS_ROW_FMA(2) CS_ROW_FMA(3)
+		CS_ROW_FMA(4) CS_ROW_FMA(5) CS_ROW_FMA(6) CS_ROW_FMA(7)
+		CS_ROW_FMA(8) CS_ROW_FMA(9) CS_ROW_FMA(10) CS_ROW_FMA(11)
+		
+		a += 12;
+		b += 16;
+	}
+	
+	CS_ROW_STORE(0) CS_ROW_STORE(1) CS_ROW_STORE(2) CS_ROW_STORE(3)
+	CS_ROW_STORE(4) CS_ROW_STORE(5) CS_ROW_STORE(6) CS_ROW_STORE(7)
+	CS_ROW_STORE(8) CS_ROW_STORE(9) CS_ROW_STORE(10) CS_ROW_STORE(11)
+	
+#undef CS_ROW_DECL
+#undef CS_ROW_FMA
+#undef CS_ROW_STORE
+}
+
+#endif
+
+template<typename T>
+static const GemmKernel<T>& gemm_kernel();
+	
+template<>
+const GemmKernel<float>& gemm_kernel<float>() {
+	
+	static const GemmKernel<float> generic = { 4, 8, kernel_generic_4x8 };
+#ifdef CS_CPU_X86
+	static const GemmKernel<float> avx2 = { 6, 16, kernel_avx2_6x16 };
+	static const GemmKernel<float> avx512 = { 12, 32, kernel_avx512_12x32 };
+	
+	if (GEMM_KERNEL == CPU_GEMM_GENERIC) {
+		return generic;
+	}
+	
+	if (cpu_has_avx512() && GEMM_KERNEL != CPU_GEMM_AVX2) {
+		return avx512;
+	}
+	
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+template<>
+const GemmKernel<double>& gemm_kernel<double>() {
+	
+	static const GemmKernel<double> generic = { 4, 8, kernel_generic_4x8 };
+#ifdef CS_CPU_X86
+	static const GemmKernel<double> avx2 = { 6, 8, kernel_avx2_6x8 };
+	static const GemmKernel<double> avx512 = { 12, 16, kernel_avx512_12x16 };
+	
+	if (GEMM_KERNEL == CPU_GEMM_GENERIC) {
+		return generic;
+	}
+	
+	if (cpu_has_avx512() && GEMM_KERNEL != CPU_GEMM_AVX2) {
+		return avx512;
+	}
+	
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+//Per thread packing buffers, 64 bytes aligned and only grown.
+template<typename T>
+class PackBuffer {
+private:
+	T* arr = nullptr;
+	size_t capacity = 0;
+
+public:
+	T* get(size_t length) {
+		if (length > capacity) {
+			free(arr);
+			void* ptr = nullptr;
+			if (posix_memalign(&ptr, 64, sizeof(T) * length) != 0) {
+				throw Exception(
+						"Could not allocate the GEMM packing buffer of " + to_string(length) + " values of "
+								+ to_string(sizeof(T)) + " bytes.");
+			}
+			arr = (T*) ptr;
+			capacity = length;
+		}
+		return arr;
+	}
+	
+	~PackBuffer() {
+		free(arr);
+	}
+};
+
+//The packed A and B of the calling thread, one pair per element type.
+template<typename T>
+struct PackBuffers {
+	PackBuffer<T> a;
+	PackBuffer<T> b;
+};
+
+template<typename T>
+static PackBuffers<T>& pack_buffers() {
+	static thread_local PackBuffers<T> buffers;
+	return buffers;
+}
+
+static thread_local PackBuffer<float> packHalf;
+
+//A GEMM operand: op(X) where X is stored row major with leading dimension ld.
+//When trans is set the logical element (i, j) is X[j][i], so transposed products
+//read the original storage and no transposed copy is ever made.
+//A 16 bit X is in half instead of ptr, see widen, only float products have them.
+template<typename T>
+struct Operand {
+	const T* ptr;
+	size_t ld;
+	bool trans;
+	const uint16_t* half;
+	CpuHalf type;
+	
+	size_t offset(size_t i, size_t j) const {
+		return trans ? j * ld + i : i * ld + j;
+	}
+	
+	const T* at(size_t i, size_t j) const {
+		return ptr + offset(i, j);
+	}
+	
+	Operand block(size_t i, size_t j) const {
+		Operand ans = { ptr ? at(i, j) : nullptr, ld, trans, half ? half + offset(i, j) : nullptr, type };
+		return ans;
+	}
+};
+
+//The (rows x cols) block of a 16 bit op(X) converted to fp32 in a buffer of the thread, in
+//the same layout, so the packing and the micro-kernels never see the 16 bit values. A float
+//op(X) is returned as it is.
+static Operand<float> widen(const Operand<float>& x, size_t rows, size_t cols) {
+	
+	if (x.half == nullptr) {
+		return x;
+	}
+	
+	//the stored block is (cols x rows) when transposed
+	size_t m = x.trans ? cols : rows;
+	size_t n = x.trans ? rows : cols;
+	float* dest = packHalf.get(m * n);
+	cpu_from_half(x.type, const_cast<uint16_t*>(x.half), x.ld, dest, n, m, n);
+	
+	Operand<float> ans = { dest, n, x.trans, nullptr, x.type };
+	return ans;
+}
+
+static Operand<double> widen(const Operand<double>& x, size_t, size_t) {
+	return x;
+}
+
+//Copies the (mc x kc) block of op(A) into row panels of MR, each panel stored column
+//by column. The last panel is padded with zeros.
+template<typename T>
+static void pack_a(const Operand<T>& a, size_t mc, size_t kc, size_t mr, T* dest) {
+	
+	for (size_t ir = 0; ir < mc; ir += mr) {
+		size_t rows = std::min(mr, mc - ir);
+		
+		for (size_t l = 0; l < kc; l++) {
+			if (a.trans) {
+				//the MR values of this column are contiguous in A^T storage
+				const T* src = a.ptr + l * a.ld + ir;
+				for (size_t i = 0; i < rows; i++) {
+					dest[i] = src[i];
+				}
+			} else {
+				const T* src = a.ptr + ir * a.ld + l;
+				for (size_t i = 0; i < rows; i++) {
+					dest[i] = src[i * a.ld];
+				}
+			}
+			for (size_t i = rows; i < mr; i++) {
+				dest[i] = 0;
+			}
+			dest += mr;
+		}
+	}
+}
+
+//Copies the (kc x nc) block of op(B) into column panels of NR, each panel stored row
+//by row. The last panel is padded with zeros.
+template<typename T>
+static void pack_b(const Operand<T>& b, size_t kc, size_t nc, size_t nr, T* dest) {
+	
+	for (size_t jr = 0; jr < nc; jr += nr) {
+		size_t cols = std::min(nr, nc - jr);
+		
+		for (size_t l = 0; l < kc; l++) {
+			if (b.trans) {
+				const T* src = b.ptr + jr * b.ld + l;
+				for (size_t j = 0; j < cols; j++) {
+					dest[j] = src[j * b.ld];
+				}
+			} else {
+				const T* src = b.ptr + l * b.ld + jr;
+				for (size_t j = 0; j < cols; j++) {
+					dest[j] = src[j];
+				}
+			}
+			for (size_t j = cols; j < nr; j++) {
+				dest[j] = 0;
+			}
+			dest += nr;
+		}
+	}
+}
+
+//The epilogue of the block of C at (i, j).
+static CpuEpilogue epilogue_block(const CpuEpilogue& ep, size_t i, size_t j) {
+	CpuEpilogue ans = { ep.bias ? ep.bias + j : nullptr, ep.act, ep.pre ? ep.pre + i * ep.ldpre + j : nullptr,
+			ep.ldpre };
+	return ans;
+}
+
+//C = act(C + bias) on a (rows x cols) block of C, a tile is read and written once while
+//it is in L1.
+static void epilogue(const CpuEpilogue& ep, float* c, size_t ldc, size_t rows, size_t cols) {
+	gemm_epilogue(ep.act, c, ldc, ep.bias, ep.pre, ep.ldpre, rows, cols);
+}
+
+//only the float products are fused
+static void epilogue(const CpuEpilogue&, double*, size_t, size_t, size_t) {
+}
+
+//ep is the epilogue of this block of C when kc is its last panel of k, nullptr otherwise.
+template<typename T>
+static void gemm_macro(const GemmKernel<T>& kernel, const T* ap, const T* bp, T* c, size_t ldc, size_t mc, size_t nc,
+		size_t kc, bool acc, const CpuEpilogue* ep) {
+	
+	const size_t mr = kernel.mr;
+	const size_t nr = kernel.nr;
+	
+	alignas(64) T tile[GEMM_MAX_MR * GEMM_MAX_NR];
+	
+	for (size_t jr = 0; jr < nc; jr += nr) {
+		size_t cols = std::min(nr, nc - jr);
+		const T* bpanel = bp + jr * kc;
+		
+		for (size_t ir = 0; ir < mc; ir += mr) {
+			size_t rows = std::min(mr, mc - ir);
+			const T* apanel = ap + ir * kc;
+			T* ctile = c + ir * ldc + jr;
+			
+			if (rows == mr && cols == nr) {
+				kernel.fn(kc, apanel, bpanel, ctile, ldc, acc);
+				if (ep) {
+					epilogue(epilogue_block(*ep, ir, jr), ctile, ldc, rows, cols);
+				}
+				continue;
+			}
+			
+			//Edge tile: same kernel on a scratch tile so the rounding is identical
+			//to the interior ones, then only the valid part is written back.
+			kernel.fn(kc, apanel, bpanel, tile, nr, false);
+			for (size_t i = 0; i < rows; i++) {
+				for (size_t j = 0; j < cols; j++) {
+					if (acc) {
+						ctile[i * ldc + j] += tile[i * nr + j];
+					} else {
+						ctile[i * ldc + j] = tile[i * nr + j];
+					}
+				}
+			}
+			if (ep) {
+				epilogue(epilogue_block(*ep, ir, jr), ctile, ldc, rows, cols);
+			}
+		}
+	}
+}
+
+template<typename T>
+static void gemm_small(const Operand<T>& a, const Operand<T>& b, T* c, size_t ldc, size_t m, size_t n, size_t p,
+		bool acc) {
+	
+	//i-k-j order (from gsl_blas_sgemm), the first k stores instead of accumulating.
+	for (size_t i = 0; i < m; i++) {
+		T* ci = c + i * ldc;
+		
+		for (size_t k = 0; k < n; k++) {
+			const T pivot = *a.at(i, k);
+			const bool store = k == 0 && acc == false;
+			
+			const T* bk = b.at(k, 0);
+			const size_t step = b.trans ? b.ld : 1;
+			
+			for (size_t j = 0; j < p; j++) {
+				T val = pivot * bk[j * step];
+				ci[j] = store ? val : ci[j] + val;
+			}
+		}
+	}
+}
+
+//C is a single row (m == 1, a single sample through a layer) or a single column (p == 1):
+//a matrix-vector product, done by cpu_gemv when the vector and C are contiguous.
+template<typename T>
+static bool gemm_vector(const Operand<T>& a, const Operand<T>& b, T* c, size_t ldc, size_t m, size_t n, size_t p) {
+	
+	T* A = const_cast<T*>(a.ptr);
+	T* B = const_cast<T*>(b.ptr);
+	
+	if (m == 1) {
+		if (a.trans && a.ld != 1 && n > 1) {
+			return false;
+		}
+		
+		//c = op(B)^T a, B is stored (n x p), or (p x n) when transposed
+		if (b.trans) {
+			cpu_gemv(B, b.ld, false, A, c, p, n);
+		} else {
+			cpu_gemv(B, b.ld, true, A, c, n, p);
+		}
+		return true;
+	}
+	
+	if (p == 1) {
+		if ((ldc != 1 && m > 1) || (b.trans == false && b.ld != 1 && n > 1)) {
+			return false;
+		}
+		
+		//c = op(A) b, A is stored (m x n), or (n x m) when transposed
+		if (a.trans) {
+			cpu_gemv(A, a.ld, true, B, c, n, m);
+		} else {
+			cpu_gemv(A, a.ld, false, B, c, m, n);
+		}
+		return true;
+	}
+	
+	return false;
+}
+
+//C is a single column (p == 1): a matrix-vector product, where padding B to NR
+//columns would waste most of the kernel.
+template<typename T>
+static void gemm_column(const Operand<T>& a, const Operand<T>& b, T* c, size_t ldc, size_t m, size_t n, bool acc) {
+	
+	if (a.trans) {
+		//the rows of op(A) are the columns of the storage, walk the storage by rows.
+		if (acc == false) {
+			for (size_t i = 0; i < m; i++) {
+				c[i * ldc] = 0;
+			}
+		}
+		
+		for (size_t k = 0; k < n; k++) {
+			const T* ak = a.at(0, k);
+			const T bk = *b.at(k, 0);
+			for (size_t i = 0; i < m; i++) {
+				c[i * ldc] += ak[i] * bk;
+			}
+		}
+		return;
+	}
+	
+	const size_t step = b.trans ? 1 : b.ld;
+	for (size_t i = 0; i < m; i++) {
+		const T* ai = a.at(i, 0);
+		const T* bk = b.at(0, 0);
+		
+		T sum = acc ? c[i * ldc] : 0;
+		for (size_t k = 0; k < n; k++) {
+			sum += ai[k] * bk[k * step];
+		}
+		c[i * ldc] = sum;
+	}
+}
+
+template<typename T>
+static void scale(T* c, size_t ldc, size_t m, size_t p, T beta) {
+	for (size_t i = 0; i < m; i++) {
+		for (size_t j = 0; j < p; j++) {
+			c[i * ldc + j] *= beta;
+		}
+	}
+}
+
+//Runs the whole blocked algorithm on one (m x p) block of C with the calling
+//thread's packing buffers. ep, when not nullptr, is applied with the last panel of k.
+template<typename T>
+static void gemm_blocked(const GemmKernel<T>& kernel, const Operand<T>& a, const Operand<T>& b, T* c, size_t ldc,
+		size_t m, size_t n, size_t p, bool acc, const CpuEpilogue* ep) {
+	
+	const size_t mr = kernel.mr;
+	const size_t nr = kernel.nr;
+	
+	//block sizes rounded to the register tile, KC is in floats so the panels of the
+	//wider types take the same bytes of cache
+	const size_t mcBlock = std::max(mr, GEMM_MC / mr * mr);
+	const size_t ncBlock = std::max(nr, GEMM_NC / nr * nr);
+	const size_t kcBlock = std::max((size_t) 1, GEMM_KC * sizeof(float) / sizeof(T));
+	
+	PackBuffers<T>& buffers = pack_buffers<T>();
+	T* ap = buffers.a.get(mcBlock * kcBlock);
+	T* bp = buffers.b.get(kcBlock * ncBlock);
+	
+	for (size_t jc = 0; jc < p; jc += ncBlock) {
+		size_t nc = std::min(ncBlock, p - jc);
+		
+		for (size_t pc = 0; pc < n; pc += kcBlock) {
+			size_t kc = std::min(kcBlock, n - pc);
+			bool accBlock = acc || pc > 0;
+			
+			pack_b(b.block(pc, jc), kc, nc, nr, bp);
+			
+			for (size_t ic = 0; ic < m; ic += mcBlock) {
+				size_t mc = std::min(mcBlock, m - ic);
+				
+				pack_a(widen(a.block(ic, pc), mc, kc), mc, kc, mr, ap);
+				
+				CpuEpilogue block;
+				const CpuEpilogue* last = nullptr;
+				if (ep && pc + kc == n) {
+					block = epilogue_block(*ep, ic, jc);
+					last = &block;
+				}
+				gemm_macro(kernel, ap, bp, c + ic * ldc + jc, ldc, mc, nc, kc, accBlock, last);
+			}
+		}
+	}
+}
+
+template<typename T>
+struct GemmJob {
+	const GemmKernel<T>* kernel;
+	Operand<T> a;
+	Operand<T> b;
+	T* c;
+	size_t ldc;
+	size_t m;
+	size_t n;
+	size_t p;
+	bool acc;
+	const CpuEpilogue* ep;
+	
+	size_t tileRows;
+	size_t tileCols;
+	size_t colTiles;
+};
+
+template<typename T>
+static void gemm_tile(size_t task, void* ctx) {
+	
+	const GemmJob<T>& job = *(const GemmJob<T>*) ctx;
+	
+	size_t i = task / job.colTiles * job.tileRows;
+	size_t j = task % job.colTiles * job.tileCols;
+	
+	size_t rows = std::min(job.tileRows, job.m - i);
+	size_t cols = std::min(job.tileCols, job.p - j);
+	
+	CpuEpilogue block;
+	if (job.ep) {
+		block = epilogue_block(*job.ep, i, j);
+	}
+	
+	gemm_blocked(*job.kernel, job.a.block(i, 0), job.b.block(0, j), job.c + i * job.ldc + j, job.ldc, rows, job.n,
+			cols, job.acc, job.ep ? &block : nullptr);
+}
+
+//The packed algorithm, on the calling thread or split in tiles of C.
+template<typename T>
+static void gemm_engine(const Operand<T>& opA, const Operand<T>& opB, T* c, size_t ldc, size_t m, size_t n, size_t p,
+		bool acc, const CpuEpilogue* ep) {
+	
+	gemm_configure();
+	
+	const GemmKernel<T>& kernel = gemm_kernel<T>();
+	size_t threads = cpu_threads();
+	
+	if (threads == 1 || m * n * p <= GEMM_PARALLEL) {
+		gemm_blocked(kernel, opA, opB, c, ldc, m, n, p, acc, ep);
+		return;
+	}
+	
+	//2D tiles of C: full MC row blocks, and the columns are split (in multiples
+	//of NR) until there are a few tiles per thread. Each element of C is computed
+	//by exactly the same sequence of operations whatever the tiling, so the result
+	//is bit-identical for any number of threads.
+	GemmJob<T> job = { &kernel, opA, opB, c, ldc, m, n, p, acc, ep, 0, 0, 0 };
+	
+	job.tileRows = std::max(kernel.mr, GEMM_MC / kernel.mr * kernel.mr);
+	size_t rowTiles = (m + job.tileRows - 1) / job.tileRows;
+	
+	size_t colTiles = 1;
+	size_t panels = (p + kernel.nr - 1) / kernel.nr;
+	while (rowTiles * colTiles < 4 * threads && colTiles < panels) {
+		colTiles++;
+	}
+	
+	job.tileCols = (panels + colTiles - 1) / colTiles * kernel.nr;
+	job.colTiles = (p + job.tileCols - 1) / job.tileCols;
+	
+	cpu_parallel(rowTiles * job.colTiles, gemm_tile<T>, &job);
+}
+
+static void check_gemm(size_t m, size_t n, size_t p) {
+	if (m == 0 || n == 0 || p == 0) {
+		throw Exception(
+				"Invalid GEMM dimensions (" + to_string(m) + "x" + to_string(n) + ") x (" + to_string(n) + "x"
+						+ to_string(p) + ").");
+	}
+}
+
+template<typename T>
+static void gemm(T* a, size_t lda, bool transA, T* b, size_t ldb, bool transB, T* c, size_t ldc, size_t m, size_t n,
+		size_t p, T beta) {
+	
+	check_gemm(m, n, p);
+	
+	const Operand<T> opA = { a, lda, transA, nullptr, CPU_BF16 };
+	const Operand<T> opB = { b, ldb, transB, nullptr, CPU_BF16 };
+	
+	bool acc = beta != 0;
+	if (acc && beta != 1) {
+		scale(c, ldc, m, p, beta);
+	}
+	
+	if (acc == false && (m == 1 || p == 1) && gemm_vector(opA, opB, c, ldc, m, n, p)) {
+		return;
+	}
+	
+	if (m * n * p <= GEMM_SMALL) {
+		gemm_small(opA, opB, c, ldc, m, n, p, acc);
+		return;
+	}
+	
+	if (p == 1) {
+		gemm_column(opA, opB, c, ldc, m, n, acc);
+		return;
+	}
+	
+	gemm_engine(opA, opB, c, ldc, m, n, p, acc, nullptr);
+}
+
+void cpu_gemm(float* a, size_t lda, bool transA, float* b, size_t ldb, bool transB, float* c, size_t ldc, size_t m,
+		size_t n, size_t p, float beta) {
+	gemm(a, lda, transA, b, ldb, transB, c, ldc, m, n, p, beta);
+}
+
+void cpu_gemm(double* a, size_t lda, bool transA, double* b, size_t ldb, bool transB, double* c, size_t ldc, size_t m,
+		size_t n, size_t p, double beta) {
+	gemm(a, lda, transA, b, ldb, transB, c, ldc, m, n, p, beta);
+}
+
+void cpu_gemm_half(CpuHalf type, uint16_t* a, size_t lda, bool transA, float* b, size_t ldb, bool transB, float* c,
+		size_t ldc, size_t m, size_t n, size_t p, float beta) {
+	
+	check_gemm(m, n, p);
+	
+	//only the packed path widens A, it is taken even for the small products
+	const Operand<float> opA = { nullptr, lda, transA, a, type };
+	const Operand<float> opB = { b, ldb, transB, nullptr, CPU_BF16 };
+	
+	bool acc = beta != 0.0f;
+	if (acc && beta != 1.0f) {
+		scale(c, ldc, m, p, beta);
+	}
+	
+	gemm_engine(opA, opB, c, ldc, m, n, p, acc, nullptr);
+}
+
+void cpu_gemm_fused(float* a, size_t lda, bool transA, float* b, size_t ldb, bool transB, float* c, size_t ldc,
+		size_t m, size_t n, size_t p, const CpuEpilogue& epilogue) {
+	
+	check_gemm(m, n, p);
+	
+	if (epilogue.pre && epilogue.ldpre < p) {
+		throw Exception(
+				"The leading dimension of the pre-activations is " + to_string(epilogue.ldpre) + ", expected at least "
+						+ to_string(p) + ".");
+	}
+	
+	//the vectors and the small products have no tiles, the epilogue is a second pass
+	//over a C that is still in cache
+	if (m == 1 || p == 1 || m * n * p <= GEMM_SMALL) {
+		cpu_gemm(a, lda, transA, b, ldb, transB, c, ldc, m, n, p, 0.0f);
+		cs::cpu::epilogue(epilogue, c, ldc, m, p);
+		return;
+	}
+	
+	const Operand<float> opA = { a, lda, transA, nullptr, CPU_BF16 };
+	const Operand<float> opB = { b, ldb, transB, nullptr, CPU_BF16 };
+	
+	gemm_engine(opA, opB, c, ldc, m, n, p, false, &epilogue);
+}
+
+void cpu_dot(float* a, float* b, float* c, size_t m, size_t n, size_t p) {
+	cpu_gemm(a, n, false, b, p, false, c, p, m, n, p, 0.0f);
+}
+
+void cpu_dot(float* a, bool transA, float* b, float* c, size_t m, size_t n, size_t p) {
+	if (transA) {
+		//A is (m x n), B is (m x p), C = A^T x B is (n x p)
+		cpu_gemm(a, n, true, b, p, false, c, p, n, m, p, 0.0f);
+	} else {
+		cpu_dot(a, b, c, m, n, p);
+	}
+}
+
+void cpu_dot(float* a, float* b, bool transB, float* c, size_t m, size_t n, size_t o, size_t p) {
+	if (transB) {
+		//A is (m x n), B is (o x p) with p == n, C = A x B^T is (m x o)
+		cpu_gemm(a, n, false, b, p, true, c, o, m, n, o, 0.0f);
+	} else {
+		cpu_dot(a, b, c, m, n, p);
+	}
+}
+
+} // namespace cpu
+} // namespace cs
@@ -0,0 +1,492 @@
+/*
+ * gemv.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+namespace cpu {
+
+//A matrix-vector product reads every element of A once, so it is bound by memory for
+//large A and by latency for the small ones (a single sample through a layer). The
+//kernels keep x or y in registers and use AVX2, AVX-512 would not read A faster.
+//
+//y = A x is a dot product per row, 4 rows at a time so x is loaded once for all of them.
+//y = A^T x walks A by rows and keeps a block of 32 values of y in registers (16 for
+//the doubles, a register holds half as many).
+
+//Values of y of a block of A^T x.
+static const size_t GEMV_COLS = 32;
+
+template<typename T>
+struct GemvKernels {
+	T (*dot)(const T* a, const T* b, size_t l);
+	//y = A x, A is (m x n)
+	void (*rows)(const T* a, size_t lda, const T* x, T* y, size_t m, size_t n);
+	//y = A^T x, A is (m x n)
+	void (*cols)(const T* a, size_t lda, const T* x, T* y, size_t m, size_t n);
+};
+
+//Generic
+//=============================================================================
+template<typename T>
+static T dot_generic(const T* a, const T* b, size_t l) {
+	T ans = 0;
+	for (size_t i = 0; i < l; i++) {
+		ans += a[i] * b[i];
+	}
+	return ans;
+}
+
+template<typename T>
+static void rows_generic(const T* a, size_t lda, const T* x, T* y, size_t m, size_t n) {
+	for (size_t i = 0; i < m; i++) {
+		y[i] = dot_generic(a + i * lda, x, n);
+	}
+}
+
+template<typename T>
+static void cols_generic(const T* a, size_t lda, const T* x, T* y, size_t m, size_t n) {
+	std::fill(y, y + n, (T) 0);
+	for (size_t i = 0; i < m; i++) {
+		const T* ai = a + i * lda;
+		for (size_t j = 0; j < n; j++) {
+			y[j] += ai[j] * x[i];
+		}
+	}
+}
+
+#ifdef CS_CPU_X86
+
+//AVX2
+//=============================================================================
+CS_TARGET("avx2,fma")
+static inline float hsum_avx2(__m256 v) {
+	__m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+	s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+	s = _mm_add_ss(s, _mm_movehdup_ps(s));
+	return _mm_cvtss_f32(s);
+}
+
+CS_TARGET("avx2,fma")
+static float dot_avx2(const float* a, const float* b, size_t l) {
+	__m256 s0 = _mm256_setzero_ps();
+	__m256 s1 = _mm256_setzero_ps();
+	__m256 s2 = _mm256_setzero_ps();
+	__m256 s3 = _mm256_setzero_ps();
+	
+	size_t i = 0;
+	for (; i + 32 <= l; i += 32) {
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+		s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), s1);
+		s2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), s2);
+		s3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), s3);
+	}
+	for (; i + 8 <= l; i += 8) {
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+	}
+	
+	float ans = hsum_avx2(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+	for (; i < l; i++) {
+		ans += a[i] * b[i];
+	}
+	return ans;
+}
+
+CS_TARGET("avx2,fma")
+static void rows_avx2(const float* a, size_t lda, const float* x, float* y, size_t m, size_t n) {
+	
+	size_t n8 = n - n % 8;
+	
+	if (n8 == 0) {
+		for (size_t i = 0; i < m; i++) {
+			float val = 0.0f;
+			for (size_t j = 0; j < n; j++) {
+				val += a[i * lda + j] * x[j];
+			}
+			y[i] = val;
+		}
+		return;
+	}
+	
+	size_t i = 0;
+	for (; i + 4 <= m; i += 4) {
+		const float* a0 = a + i * lda;
+		const float* a1 = a0 + lda;
+		const float* a2 = a1 + lda;
+		const float* a3 = a2 + lda;
+	
+		__m256 s0 = _mm256_setzero_ps();
+		__m256 s1 = _mm256_setzero_ps();
+		__m256 s2 = _mm256_setzero_ps();
+		__m256 s3 = _mm256_setzero_ps();
+	
+		for (size_t j = 0; j < n8; j += 8) {
+			__m256 xj = _mm256_loadu_ps(x + j);
+			s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a0 + j), xj, s0);
+			s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a1 + j), xj, s1);
+			s2 = _mm256_fmadd_ps(_mm256_loadu_ps(a2 + j), xj, s2);
+			s3 = _mm256_fmadd_ps(_mm256_loadu_ps(a3 + j), xj, s3);
+		}
+	
+		float y0 = hsum_avx2(s0);
+		float y1 = hsum_avx2(s1);
+		float y2 = hsum_avx2(s2);
+		float y3 = hsum_avx2(s3);
+		
+		//the tail inline, calling the generic code from here costs an AVX to SSE transition
+		for (size_t j = n8; j < n; j++) {
+			y0 += a0[j] * x[j];
+			y1 += a1[j] * x[j];
+			y2 += a2[j] * x[j];
+			y3 += a3[j] * x[j];
+		}
+		
+		y[i + 0] = y0;
+		y[i + 1] = y1;
+		y[i + 2] = y2;
+		y[i + 3] = y3;
+	}
+	
+	for (; i < m; i++) {
+		y[i] = dot_avx2(a + i * lda, x, n);
+	}
+}
+
+CS_TARGET("avx2,fma")
+static void cols_avx2(const float* a, size_t lda, const float* x, float* y, size_t m, size_t n) {
+	
+	size_t j = 0;
+	for (; j + GEMV_COLS <= n; j += GEMV_COLS) {
+		__m256 y0 = _mm256_setzero_ps();
+		__m256 y1 = _mm256_setzero_ps();
+		__m256 y2 = _mm256_setzero_ps();
+		__m256 y3 = _mm256_setzero_ps();
+	
+		for (size_t i = 0; i < m; i++) {
+			const float* ai = a + i * lda + j;
+			__m256 xi = _mm256_set1_ps(x[i]);
+			y0 = _mm256_fmadd_ps(_mm256_loadu_ps(ai), xi, y0);
+			y1 = _mm256_fmadd_ps(_mm256_loadu_ps(ai + 8), xi, y1);
+			y2 = _mm256_fmadd_ps(_mm256_loadu_ps(ai + 16), xi, y2);
+			y3 = _mm256_fmadd_ps(_mm256_loadu_ps(ai + 24), xi, y3);
+		}
+	
+		_mm256_storeu_ps(y + j, y0);
+		_mm256_storeu_ps(y + j + 8, y1);
+		_mm256_storeu_ps(y + j + 16, y2);
+		_mm256_storeu_ps(y + j + 24, y3);
+	}
+	
+	for (; j + 8 <= n; j += 8) {
+		__m256 y0 = _mm256_setzero_ps();
+		for (size_t i = 0; i < m; i++) {
+			y0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i * lda + j), _mm256_set1_ps(x[i]), y0);
+		}
+		_mm256_storeu_ps(y + j, y0);
+	}
+	
+	if (j < n) {
+		_mm256_zeroupper();
+		cols_generic(a + j, lda, x, y + j, m, n - j);
+	}
+}
+
+//AVX2, doubles
+//=============================================================================
+CS_TARGET("avx2,fma")
+static inline double hsum_avx2(__m256d v) {
+	__m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+	s = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+	return _mm_cvtsd_f64(s);
+}
+
+CS_TARGET("avx2,fma")
+static double dot_avx2(const double* a, const double* b, size_t l) {
+	__m256d s0 = _mm256_setzero_pd();
+	__m256d s1 = _mm256_setzero_pd();
+	__m256d s2 = _mm256_setzero_pd();
+	__m256d s3 = _mm256_setzero_pd();
+	
+	size_t i = 0;
+	for (; i + 16 <= l; i += 16) {
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+		s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+		s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), s2);
+		s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
+	}
+	for (; i + 4 <= l; i += 4) {
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+	}
+	
+	double ans = hsum_avx2(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+	for (; i < l; i++) {
+		ans += a[i] * b[i];
+	}
+	return ans;
+}
+
+CS_TARGET("avx2,fma")
+static void rows_avx2(const double* a, size_t lda, const double* x, double* y, size_t m, size_t n) {
+	
+	size_t n4 = n - n % 4;
+	
+	if (n4 == 0) {
+		for (size_t i = 0; i < m; i++) {
+			double val = 0.0;
+			for (size_t j = 0; j < n; j++) {
+				val += a[i * lda + j] * x[j];
+			}
+			y[i] = val;
+		}
+		return;
+	}
+	
+	size_t i = 0;
+	for (; i + 4 <= m; i += 4) {
+		const double* a0 = a + i * lda;
+		const double* a1 = a0 + lda;
+		const double* a2 = a1 + lda;
+		const double* a3 = a2 + lda;
+	
+		__m256d s0 = _mm256_setzero_pd();
+		__m256d s1 = _mm256_setzero_pd();
+		__m256d s2 = _mm256_setzero_pd();
+		__m256d s3 = _mm256_setzero_pd();
+	
+		for (size_t j = 0; j < n4; j += 4) {
+			__m256d xj = _mm256_loadu_pd(x + j);
+			s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + j), xj, s0);
+			s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a1 + j), xj, s1);
+			s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a2 + j), xj, s2);
+			s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a3 + j), xj, s3);
+		}
+	
+		double y0 = hsum_avx2(s0);
+		double y1 = hsum_avx2(s1);
+		double y2 = hsum_avx2(s2);
+		double y3 = hsum_avx2(s3);
+		
+		for (size_t j = n4; j < n; j++) {
+			y0 += a0[j] * x[j];
+			y1 += a1[j] * x[j];
+			y2 += a2[j] * x[j];
+			y3 += a3[j] * x[j];
+		}
+		
+		y[i + 0] = y0;
+		y[i + 1] = y1;
+		y[i + 2] = y2;
+		y[i + 3] = y3;
+	}
+	
+	for (; i < m; i++) {
+		y[i] = dot_avx2(a + i * lda, x, n);
+	}
+}
+
+CS_TARGET("avx2,fma")
+static void cols_avx2(const double* a, size_t lda, const double* x, double* y, size_t m, size_t n) {
+	
+	size_t j = 0;
+	for (; j + GEMV_COLS / 2 <= n; j += GEMV_COLS / 2) {
+		__m256d y0 = _mm256_setzero_pd();
+		__m256d y1 = _mm256_setzero_pd();
+		__m256d y2 = _mm256_setzero_pd();
+		__m256d y3 = _mm256_setzero_pd();
+	
+		for (size_t i = 0; i < m; i++) {
+			const double* ai = a + i * lda + j;
+			__m256d xi = _mm256_set1_pd(x[i]);
+			y0 = _mm256_fmadd_pd(_mm256_loadu_pd(ai), xi, y0);
+			y1 = _mm256_fmadd_pd(_mm256_loadu_pd(ai + 4), xi, y1);
+			y2 = _mm256_fmadd_pd(_mm256_loadu_pd(ai + 8), xi, y2);
+			y3 = _mm256_fmadd_pd(_mm256_loadu_pd(ai + 12), xi, y3);
+		}
+	
+		_mm256_storeu_pd(y + j, y0);
+		_mm256_storeu_pd(y + j + 4, y1);
+		_mm256_storeu_pd(y + j + 8, y2);
+		_mm256_storeu_pd(y + j + 12, y3);
+	}
+	
+	for (; j + 4 <= n; j += 4) {
+		__m256d y0 = _mm256_setzero_pd();
+		for (size_t i = 0; i < m; i++) {
+			y0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i * lda + j), _mm256_set1_pd(x[i]), y0);
+		}
+		_mm256_storeu_pd(y + j, y0);
+	}
+	
+	if (j < n) {
+		_mm256_zeroupper();
+		cols_generic(a + j, lda, x, y + j, m, n - j);
+	}
+}
+
+#endif
+
+template<typename T>
+static const GemvKernels<T>& gemv_kernels() {
+	
+	static const GemvKernels<T> generic = { dot_generic, rows_generic, cols_generic };
+#ifdef CS_CPU_X86
+	static const GemvKernels<T> avx2 = { dot_avx2, rows_avx2, cols_avx2 };
+	
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+//Elements of A of a task of a batch.
+static const size_t GEMV_BATCH_WORK = 1 << 15;
+
+//y_k = op(A_k) x_k for k < batch. A batch runs a few whole products per task, a single
+//large product is split in chunks of y: rows of A for A x, and columns of A for A^T x.
+template<typename T>
+struct GemvJob {
+	const T* a;
+	size_t lda;
+	size_t strideA;
+	bool trans;
+	const T* x;
+	size_t strideX;
+	T* y;
+	size_t strideY;
+	size_t m;
+	size_t n;
+	size_t batch;
+	//products of a task
+	size_t products;
+	//values of y of a task, all of them unless the product is split
+	size_t chunk;
+};
+
+template<typename T>
+static void gemv_product(const GemvKernels<T>& k, const GemvJob<T>& job, size_t b, size_t start, size_t l) {
+	
+	const T* a = job.a + b * job.strideA;
+	const T* x = job.x + b * job.strideX;
+	T* y = job.y + b * job.strideY;
+	
+	if (job.trans) {
+		k.cols(a + start, job.lda, x, y + start, job.m, l);
+	} else {
+		k.rows(a + start * job.lda, job.lda, x, y + start, l, job.n);
+	}
+}
+
+template<typename T>
+static void gemv_chunk(size_t task, void* ctx) {
+	
+	const GemvJob<T>& job = *(const GemvJob<T>*) ctx;
+	const GemvKernels<T>& k = gemv_kernels<T>();
+	
+	size_t l = job.trans ? job.n : job.m;
+	
+	if (job.chunk < l) {
+		size_t start = task * job.chunk;
+		gemv_product(k, job, 0, start, std::min(job.chunk, l - start));
+		return;
+	}
+	
+	size_t start = task * job.products;
+	size_t end = std::min(job.batch, start + job.products);
+	for (size_t b = start; b < end; b++) {
+		gemv_product(k, job, b, 0, l);
+	}
+}
+
+template<typename T>
+static void gemv_batched(T* a, size_t lda, size_t strideA, bool transA, T* x, size_t strideX, T* y, size_t strideY,
+		size_t m, size_t n, size_t batch) {
+	
+	if (m == 0 || n == 0 || batch == 0) {
+		return;
+	}
+	
+	//y has m values, or n for A^T x
+	size_t l = transA ? n : m;
+	
+	//rows shorter than a register take the scalar loops of the kernels anyway, small ones
+	//run them here, the thread pool and the kernel table cost more than the product (4x4)
+	if (n < 32 / sizeof(T) && m * n * batch <= GEMV_BATCH_WORK) {
+		for (size_t b = 0; b < batch; b++) {
+			if (transA) {
+				cols_generic(a + b * strideA, lda, x + b * strideX, y + b * strideY, m, n);
+			} else {
+				rows_generic(a + b * strideA, lda, x + b * strideX, y + b * strideY, m, n);
+			}
+		}
+		return;
+	}
+	
+	//many vectors through the same matrix are the rows of a product with it
+	if (strideA == 0 && batch > 1 && strideX >= (transA ? m : n) && strideY >= l) {
+		if (transA) {
+			cpu_gemm(x, strideX, false, a, lda, false, y, strideY, batch, m, n, (T) 0);
+		} else {
+			cpu_gemm(x, strideX, false, a, lda, true, y, strideY, batch, n, m, (T) 0);
+		}
+		return;
+	}
+	GemvJob<T> job = { a, lda, strideA, transA, x, strideX, y, strideY, m, n, batch, 1, l };
+	
+	size_t tasks;
+	size_t threads = cpu_threads();
+	if (batch == 1 && threads > 1 && m * n > GEMM_PARALLEL / 64) {
+		size_t step = transA ? GEMV_COLS : 64;
+		job.chunk = std::max(step, (l + 4 * threads - 1) / (4 * threads) / step * step);
+		tasks = (l + job.chunk - 1) / job.chunk;
+	} else {
+		job.products = std::max((size_t) 1, GEMV_BATCH_WORK / (m * n));
+		tasks = (batch + job.products - 1) / job.products;
+	}
+	
+	cpu_parallel(tasks, gemv_chunk<T>, &job);
+}
+
+void cpu_gemv_batched(float* a, size_t lda, size_t strideA, bool transA, float* x, size_t strideX, float* y,
+		size_t strideY, size_t m, size_t n, size_t batch) {
+	gemv_batched(a, lda, strideA, transA, x, strideX, y, strideY, m, n, batch);
+}
+
+void cpu_gemv_batched(double* a, size_t lda, size_t strideA, bool transA, double* x, size_t strideX, double* y,
+		size_t strideY, size_t m, size_t n, size_t batch) {
+	gemv_batched(a, lda, strideA, transA, x, strideX, y, strideY, m, n, batch);
+}
+
+void cpu_gemv(float* a, size_t lda, bool transA, float* x, float* y, size_t m, size_t n) {
+	gemv_batched(a, lda, 0, transA, x, 0, y, 0, m, n, 1);
+}
+
+void cpu_gemv(double* a, size_t lda, bool transA, double* x, double* y, size_t m, size_t n) {
+	gemv_batched(a, lda, 0, transA, x, 0, y, 0, m, n, 1);
+}
+
+void cpu_gemv(float* a, size_t lda, float* x, float* y, size_t m, size_t n) {
+	cpu_gemv(a, lda, false, x, y, m, n);
+}
+
+float cpu_vdot(float* a, float* b, size_t l) {
+	return gemv_kernels<float>().dot(a, b, l);
+}
+
+double cpu_vdot(double* a, double* b, size_t l) {
+	return gemv_kernels<double>().dot(a, b, l);
+}
+
+} // namespace cpu
+} // namespace cs
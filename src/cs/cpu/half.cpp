@@ -0,0 +1,385 @@
+/*
+ * half.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+namespace cpu {
+
+//The 16 bit matrices are only storage: every kernel widens them to fp32 in registers
+//and computes in fp32. The conversions are bound by memory, AVX2 (with F16C for the
+//IEEE halves, present on every AVX2 processor) already saturates it.
+
+//Elements of one task.
+static const size_t HALF_CHUNK = 1 << 14;
+
+struct HalfKernels {
+	void (*to_half)(const float* src, uint16_t* dest, size_t l);
+	void (*from_half)(const uint16_t* src, float* dest, size_t l);
+	float (*sum)(const uint16_t* src, size_t l);
+};
+
+static inline uint32_t float_bits(float f) {
+	uint32_t ans;
+	memcpy(&ans, &f, sizeof(ans));
+	return ans;
+}
+
+static inline float bits_float(uint32_t u) {
+	float ans;
+	memcpy(&ans, &u, sizeof(ans));
+	return ans;
+}
+
+//Generic
+//=============================================================================
+static inline uint16_t bf16_from_float(float f) {
+	uint32_t x = float_bits(f);
+	if ((x & 0x7FFFFFFF) > 0x7F800000) {
+		//a quiet NaN, the rounding could turn it into an infinity
+		return (uint16_t) ((x >> 16) | 0x40);
+	}
+	return (uint16_t) ((x + 0x7FFF + ((x >> 16) & 1)) >> 16);
+}
+
+static inline float bf16_to_float(uint16_t h) {
+	return bits_float((uint32_t) h << 16);
+}
+
+//From "float_to_half_fast3_rtne" and "half_to_float" by F. Giesen, the results are
+//the ones of the F16C instructions.
+static inline uint16_t fp16_from_float(float f) {
+	const uint32_t infinity = 255u << 23;
+	const uint32_t overflow = (127u + 16) << 23;
+	const uint32_t denormal = ((127u - 15) + (23 - 10) + 1) << 23;
+	
+	uint32_t x = float_bits(f);
+	uint32_t sign = x & 0x80000000u;
+	x ^= sign;
+	
+	uint32_t ans;
+	if (x >= overflow) {
+		ans = x > infinity ? 0x7E00 : 0x7C00;
+	} else if (x < (113u << 23)) {
+		//the addition aligns the subnormal mantissa and rounds it
+		ans = float_bits(bits_float(x) + bits_float(denormal)) - denormal;
+	} else {
+		uint32_t odd = (x >> 13) & 1;
+		x += ((uint32_t) (15 - 127) << 23) + 0xFFF;
+		x += odd;
+		ans = x >> 13;
+	}
+	return (uint16_t) (ans | (sign >> 16));
+}
+
+static inline float fp16_to_float(uint16_t h) {
+	const uint32_t exponent = 0x7C00u << 13;
+	
+	uint32_t x = ((uint32_t) h & 0x7FFF) << 13;
+	uint32_t exp = x & exponent;
+	x += (127u - 15) << 23;
+	
+	if (exp == exponent) {
+		x += (128u - 16) << 23;
+	} else if (exp == 0) {
+		x += 1u << 23;
+		x = float_bits(bits_float(x) - bits_float(113u << 23));
+	}
+	return bits_float(x | (((uint32_t) h & 0x8000) << 16));
+}
+
+static void bf16_to_half_generic(const float* src, uint16_t* dest, size_t l) {
+	for (size_t j = 0; j < l; j++) {
+		dest[j] = bf16_from_float(src[j]);
+	}
+}
+
+static void bf16_from_half_generic(const uint16_t* src, float* dest, size_t l) {
+	for (size_t j = 0; j < l; j++) {
+		dest[j] = bf16_to_float(src[j]);
+	}
+}
+
+static float bf16_sum_generic(const uint16_t* src, size_t l) {
+	float ans = 0.0f;
+	for (size_t j = 0; j < l; j++) {
+		ans += bf16_to_float(src[j]);
+	}
+	return ans;
+}
+
+static void fp16_to_half_generic(const float* src, uint16_t* dest, size_t l) {
+	for (size_t j = 0; j < l; j++) {
+		dest[j] = fp16_from_float(src[j]);
+	}
+}
+
+static void fp16_from_half_generic(const uint16_t* src, float* dest, size_t l) {
+	for (size_t j = 0; j < l; j++) {
+		dest[j] = fp16_to_float(src[j]);
+	}
+}
+
+static float fp16_sum_generic(const uint16_t* src, size_t l) {
+	float ans = 0.0f;
+	for (size_t j = 0; j < l; j++) {
+		ans += fp16_to_float(src[j]);
+	}
+	return ans;
+}
+
+#ifdef CS_CPU_X86
+
+//AVX2
+//=============================================================================
+CS_TARGET("avx2,fma,f16c")
+static inline float hsum_avx2(__m256 v) {
+	__m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+	s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+	s = _mm_add_ss(s, _mm_movehdup_ps(s));
+	return _mm_cvtss_f32(s);
+}
+
+CS_TARGET("avx2,fma,f16c")
+static inline __m256 bf16_load_avx2(const uint16_t* src) {
+	__m256i h = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) src));
+	return _mm256_castsi256_ps(_mm256_slli_epi32(h, 16));
+}
+
+CS_TARGET("avx2,fma,f16c")
+static void bf16_to_half_avx2(const float* src, uint16_t* dest, size_t l) {
+	const __m256i bias = _mm256_set1_epi32(0x7FFF);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i quiet = _mm256_set1_epi32(0x40);
+	
+	size_t j = 0;
+	for (; j + 8 <= l; j += 8) {
+		__m256 v = _mm256_loadu_ps(src + j);
+		__m256i x = _mm256_castps_si256(v);
+	
+		//x + 0x7FFF + the lowest kept bit, so the ties go to even
+		__m256i odd = _mm256_and_si256(_mm256_srli_epi32(x, 16), one);
+		__m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(x, bias), odd), 16);
+		__m256i nan = _mm256_or_si256(_mm256_srli_epi32(x, 16), quiet);
+		__m256 unordered = _mm256_cmp_ps(v, v, _CMP_UNORD_Q);
+		__m256i h = _mm256_blendv_epi8(rounded, nan, _mm256_castps_si256(unordered));
+	
+		//the 8 values are below 0x10000, so the saturation never applies
+		__m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+		_mm_storeu_si128((__m128i*) (dest + j), packed);
+	}
+	//the scalar tail is SSE code, see broadcast.cpp
+	_mm256_zeroupper();
+	for (; j < l; j++) {
+		dest[j] = bf16_from_float(src[j]);
+	}
+}
+
+CS_TARGET("avx2,fma,f16c")
+static void bf16_from_half_avx2(const uint16_t* src, float* dest, size_t l) {
+	size_t j = 0;
+	for (; j + 8 <= l; j += 8) {
+		_mm256_storeu_ps(dest + j, bf16_load_avx2(src + j));
+	}
+	_mm256_zeroupper();
+	for (; j < l; j++) {
+		dest[j] = bf16_to_float(src[j]);
+	}
+}
+
+CS_TARGET("avx2,fma,f16c")
+static float bf16_sum_avx2(const uint16_t* src, size_t l) {
+	__m256 s0 = _mm256_setzero_ps();
+	__m256 s1 = _mm256_setzero_ps();
+	
+	size_t j = 0;
+	for (; j + 16 <= l; j += 16) {
+		s0 = _mm256_add_ps(s0, bf16_load_avx2(src + j));
+		s1 = _mm256_add_ps(s1, bf16_load_avx2(src + j + 8));
+	}
+	for (; j + 8 <= l; j += 8) {
+		s0 = _mm256_add_ps(s0, bf16_load_avx2(src + j));
+	}
+	
+	float ans = hsum_avx2(_mm256_add_ps(s0, s1));
+	_mm256_zeroupper();
+	for (; j < l; j++) {
+		ans += bf16_to_float(src[j]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx2,fma,f16c")
+static void fp16_to_half_avx2(const float* src, uint16_t* dest, size_t l) {
+	size_t j = 0;
+	for (; j + 8 <= l; j += 8) {
+		__m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + j), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i*) (dest + j), h);
+	}
+	_mm256_zeroupper();
+	for (; j < l; j++) {
+		dest[j] = fp16_from_float(src[j]);
+	}
+}
+
+CS_TARGET("avx2,fma,f16c")
+static void fp16_from_half_avx2(const uint16_t* src, float* dest, size_t l) {
+	size_t j = 0;
+	for (; j + 8 <= l; j += 8) {
+		_mm256_storeu_ps(dest + j, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (src + j))));
+	}
+	_mm256_zeroupper();
+	for (; j < l; j++) {
+		dest[j] = fp16_to_float(src[j]);
+	}
+}
+
+CS_TARGET("avx2,fma,f16c")
+static float fp16_sum_avx2(const uint16_t* src, size_t l) {
+	__m256 s0 = _mm256_setzero_ps();
+	__m256 s1 = _mm256_setzero_ps();
+	
+	size_t j = 0;
+	for (; j + 16 <= l; j += 16) {
+		s0 = _mm256_add_ps(s0, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (src + j))));
+		s1 = _mm256_add_ps(s1, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (src + j + 8))));
+	}
+	for (; j + 8 <= l; j += 8) {
+		s0 = _mm256_add_ps(s0, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (src + j))));
+	}
+	
+	float ans = hsum_avx2(_mm256_add_ps(s0, s1));
+	_mm256_zeroupper();
+	for (; j < l; j++) {
+		ans += fp16_to_float(src[j]);
+	}
+	return ans;
+}
+
+#endif
+
+static const HalfKernels& half_kernels(CpuHalf type) {
+	
+	static const HalfKernels bf16 = { bf16_to_half_generic, bf16_from_half_generic, bf16_sum_generic };
+	static const HalfKernels fp16 = { fp16_to_half_generic, fp16_from_half_generic, fp16_sum_generic };
+#ifdef CS_CPU_X86
+	static const HalfKernels bf16Avx2 = { bf16_to_half_avx2, bf16_from_half_avx2, bf16_sum_avx2 };
+	static const HalfKernels fp16Avx2 = { fp16_to_half_avx2, fp16_from_half_avx2, fp16_sum_avx2 };
+	
+	if (cpu_has_avx2()) {
+		return type == CPU_BF16 ? bf16Avx2 : fp16Avx2;
+	}
+#endif
+	return type == CPU_BF16 ? bf16 : fp16;
+}
+
+//A conversion of an (m x n) block, or the partial sums of one, by chunks of rows.
+struct HalfJob {
+	const HalfKernels* kernels;
+	const float* f;
+	size_t ldf;
+	const uint16_t* h;
+	size_t ldh;
+	bool widen;
+	size_t m;
+	size_t n;
+	size_t rows;
+	//one sum per task, null for the conversions
+	float* sums;
+};
+
+static void half_chunk(size_t task, void* ctx) {
+	
+	const HalfJob& job = *(const HalfJob*) ctx;
+	
+	size_t start = task * job.rows;
+	size_t end = std::min(job.m, start + job.rows);
+	
+	float sum = 0.0f;
+	for (size_t i = start; i < end; i++) {
+		float* f = const_cast<float*>(job.f) + i * job.ldf;
+		uint16_t* h = const_cast<uint16_t*>(job.h) + i * job.ldh;
+	
+		if (job.sums) {
+			sum += job.kernels->sum(h, job.n);
+		} else if (job.widen) {
+			job.kernels->from_half(h, f, job.n);
+		} else {
+			job.kernels->to_half(f, h, job.n);
+		}
+	}
+	
+	if (job.sums) {
+		job.sums[task] = sum;
+	}
+}
+
+static size_t half_tasks(HalfJob& job) {
+	job.rows = std::max((size_t) 1, HALF_CHUNK / job.n);
+	return (job.m + job.rows - 1) / job.rows;
+}
+
+void cpu_to_half(CpuHalf type, float* src, size_t lds, uint16_t* dest, size_t ldd, size_t m, size_t n) {
+	
+	if (m == 0 || n == 0) {
+		return;
+	}
+	
+	HalfJob job = { &half_kernels(type), src, lds, dest, ldd, false, m, n, 0, nullptr };
+	cpu_parallel(half_tasks(job), half_chunk, &job);
+}
+
+void cpu_from_half(CpuHalf type, uint16_t* src, size_t lds, float* dest, size_t ldd, size_t m, size_t n) {
+	
+	if (m == 0 || n == 0) {
+		return;
+	}
+	
+	HalfJob job = { &half_kernels(type), dest, ldd, src, lds, true, m, n, 0, nullptr };
+	cpu_parallel(half_tasks(job), half_chunk, &job);
+}
+
+uint16_t cpu_to_half(CpuHalf type, float val) {
+	return type == CPU_BF16 ? bf16_from_float(val) : fp16_from_float(val);
+}
+
+float cpu_from_half(CpuHalf type, uint16_t val) {
+	return type == CPU_BF16 ? bf16_to_float(val) : fp16_to_float(val);
+}
+
+float cpu_half_sum(CpuHalf type, uint16_t* a, size_t lda, size_t m, size_t n) {
+	
+	if (m == 0 || n == 0) {
+		return 0.0f;
+	}
+	
+	HalfJob job = { &half_kernels(type), nullptr, 0, a, lda, false, m, n, 0, nullptr };
+	size_t tasks = half_tasks(job);
+	
+	//the partial sums are added in task order, the result does not depend on the threads
+	std::vector<float> sums(tasks);
+	job.sums = sums.data();
+	cpu_parallel(tasks, half_chunk, &job);
+	
+	float ans = 0.0f;
+	for (size_t t = 0; t < tasks; t++) {
+		ans += sums[t];
+	}
+	return ans;
+}
+
+} // namespace cpu
+} // namespace cs
@@ -0,0 +1,264 @@
+/*
+ * memory.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace cs {
+using namespace core;
+namespace cpu {
+
+//The modes of mbind from <numaif.h>, without linking libnuma.
+static const int MPOL_MODE_BIND = 2;
+static const int MPOL_MODE_INTERLEAVE = 3;
+
+//The nodes in a mask of 64 bits, the NUMA machines have less.
+static const size_t MAX_NODES = 64;
+
+//The online nodes from a list like "0", "0-1" or "0,2-3", bit k for node k.
+static uint64_t online_nodes() {
+	
+	static uint64_t mask = [] {
+		uint64_t ans = 0;
+		ifstream file("/sys/devices/system/node/online");
+		string list;
+		if (getline(file, list)) {
+			stringstream in(list);
+			string range;
+			while (getline(in, range, ',')) {
+				size_t first = 0;
+				size_t last = 0;
+				int read = sscanf(range.c_str(), "%zu-%zu", &first, &last);
+				if (read < 1) {
+					continue;
+				}
+				if (read == 1) {
+					last = first;
+				}
+				for (size_t k = first; k <= last && k < MAX_NODES; k++) {
+					ans |= (uint64_t) 1 << k;
+				}
+			}
+		}
+		return ans ? ans : (uint64_t) 1;
+	}();
+	return mask;
+}
+
+size_t cpu_numa_nodes() {
+	return 64 - __builtin_clzll((unsigned long long) online_nodes());
+}
+
+static CpuMemoryPolicy& current_policy() {
+	static CpuMemoryPolicy policy = { CPU_PAGES_SMALL, CPU_PLACE_LOCAL, 0, false };
+	return policy;
+}
+
+static void check(const CpuMemoryPolicy& policy) {
+	
+	if ((size_t) policy.pages > CPU_PAGES_HUGE || (size_t) policy.placement > CPU_PLACE_NODE) {
+		throw Exception("Invalid memory policy.");
+	}
+	
+	if (policy.placement == CPU_PLACE_NODE
+			&& (policy.node < 0 || policy.node >= (int) MAX_NODES || (online_nodes() >> policy.node & 1) == 0)) {
+		throw Exception("There is no NUMA node " + to_string(policy.node) + ".");
+	}
+}
+
+void cpu_set_memory_policy(CpuMemoryPolicy policy) {
+	check(policy);
+	current_policy() = policy;
+}
+
+CpuMemoryPolicy cpu_memory_policy() {
+	return current_policy();
+}
+
+//The bytes of the mapping of a buffer, whole huge pages.
+static size_t mapped_bytes(size_t bytes) {
+	return (bytes + CPU_HUGE_PAGE - 1) / CPU_HUGE_PAGE * CPU_HUGE_PAGE;
+}
+
+//A mapping of length bytes at a CPU_HUGE_PAGE boundary, the extra bytes around it are unmapped.
+static char* map_aligned(size_t length) {
+	
+	size_t extra = length + CPU_HUGE_PAGE;
+	void* ptr = mmap(nullptr, extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr == MAP_FAILED) {
+		return nullptr;
+	}
+	
+	char* start = (char*) ptr;
+	char* aligned = (char*) (((uintptr_t) start + CPU_HUGE_PAGE - 1) / CPU_HUGE_PAGE * CPU_HUGE_PAGE);
+	if (aligned > start) {
+		munmap(start, aligned - start);
+	}
+	if (aligned + length < start + extra) {
+		munmap(aligned + length, start + extra - (aligned + length));
+	}
+	return aligned;
+}
+
+static void bind(char* ptr, size_t length, const CpuMemoryPolicy& policy) {
+	
+	if (policy.placement == CPU_PLACE_LOCAL) {
+		return;
+	}
+	
+	unsigned long mask = policy.placement == CPU_PLACE_NODE ? 1ul << policy.node : (unsigned long) online_nodes();
+	int mode = policy.placement == CPU_PLACE_NODE ? MPOL_MODE_BIND : MPOL_MODE_INTERLEAVE;
+	
+	//maxnode counts one bit more than the mask has
+	if (syscall(SYS_mbind, ptr, length, mode, &mask, 8 * sizeof(mask) + 1, 0) != 0 && errno != ENOSYS) {
+		int error = errno;
+		munmap(ptr, length);
+		throw Exception("Could not place " + to_string(length) + " bytes on the NUMA nodes: " + strerror(error) + ".");
+	}
+}
+
+struct TouchJob {
+	char* ptr;
+	size_t length;
+	size_t page;
+	size_t tasks;
+};
+
+static void touch_chunk(size_t task, void* ctx) {
+	
+	const TouchJob& job = *(const TouchJob*) ctx;
+	size_t pages = job.length / job.page;
+	size_t start = pages * task / job.tasks;
+	size_t end = pages * (task + 1) / job.tasks;
+	
+	for (size_t p = start; p < end; p++) {
+		((volatile char*) job.ptr)[p * job.page] = 0;
+	}
+}
+
+void* memory_map(size_t bytes, const CpuMemoryPolicy& policy) {
+	
+	check(policy);
+	size_t length = mapped_bytes(bytes);
+	
+	char* ptr = nullptr;
+	bool huge = false;
+	if (policy.pages == CPU_PAGES_HUGE) {
+		void* reserved = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1,
+				0);
+		if (reserved != MAP_FAILED) {
+			ptr = (char*) reserved;
+			huge = true;
+		}
+	}
+	
+	if (ptr == nullptr) {
+		ptr = map_aligned(length);
+		if (ptr == nullptr) {
+			return nullptr;
+		}
+		
+		//without reserved huge pages the transparent ones are the closest
+		if (policy.pages != CPU_PAGES_SMALL) {
+			madvise(ptr, length, MADV_HUGEPAGE);
+		}
+	}
+	
+	//before the first write, which places the pages
+	bind(ptr, length, policy);
+	
+	if (policy.parallel_touch) {
+		size_t page = huge || policy.pages != CPU_PAGES_SMALL ? CPU_HUGE_PAGE : (size_t) sysconf(_SC_PAGESIZE);
+		size_t pages = length / page;
+		TouchJob job = { ptr, length, page, std::min(cpu_threads(), pages) };
+		cpu_parallel(job.tasks, touch_chunk, &job);
+	}
+	
+	return ptr;
+}
+
+void memory_unmap(void* ptr, size_t bytes) {
+	munmap(ptr, mapped_bytes(bytes));
+}
+
+bool cpu_memory_info(const void* ptr, CpuMemoryInfo& info) {
+	
+	memset(&info, 0, sizeof(info));
+	uintptr_t address = (uintptr_t) ptr;
+	
+	//smaps has the range of each mapping followed by its fields
+	ifstream smaps("/proc/self/smaps");
+	string line;
+	uintptr_t start = 0;
+	bool found = false;
+	while (getline(smaps, line)) {
+		unsigned long first;
+		unsigned long last;
+		if (sscanf(line.c_str(), "%lx-%lx ", &first, &last) == 2 && line.find(':') > line.find(' ')) {
+			if (found) {
+				break;
+			}
+			found = address >= first && address < last;
+			start = first;
+			continue;
+		}
+		
+		size_t kb;
+		if (found && sscanf(line.c_str(), "KernelPageSize: %zu kB", &kb) == 1) {
+			info.page_bytes = kb << 10;
+		} else if (found && sscanf(line.c_str(), "AnonHugePages: %zu kB", &kb) == 1) {
+			info.huge_bytes = kb << 10;
+		}
+	}
+	
+	if (found == false) {
+		return false;
+	}
+	
+	//numa_maps has a line for each mapping, "start policy fields", with Nk=pages for the nodes
+	ifstream numa("/proc/self/numa_maps");
+	strcpy(info.policy, "default");
+	while (getline(numa, line)) {
+		stringstream in(line);
+		string field;
+		unsigned long first;
+		if (!(in >> hex >> first) || first != start) {
+			continue;
+		}
+		
+		if (in >> field) {
+			strncpy(info.policy, field.c_str(), sizeof(info.policy) - 1);
+		}
+		
+		while (in >> field) {
+			size_t node;
+			if (sscanf(field.c_str(), "N%zu=", &node) == 1 && node < MAX_NODES) {
+				info.nodes |= (uint64_t) 1 << node;
+			}
+		}
+		break;
+	}
+	
+	return true;
+}
+
+} // namespace cpu
+} // namespace cs
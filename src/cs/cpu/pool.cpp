@@ -0,0 +1,205 @@
+/*
+ * pool.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <stdlib.h>
+#include <atomic>
+
+namespace cs {
+namespace cpu {
+
+//4 classes per power of two from 64 bytes to CPU_POOL_MAX, so a buffer wastes less than a
+//quarter of its size: 64, 80, 96, 112, 128, 160, 192, 224, 256, 320...
+static const size_t POOL_MIN = 64;
+static const size_t POOL_CLASSES = 77;
+
+static_assert(POOL_MIN == 1 << 6 && CPU_POOL_MAX == 1 << 25, "POOL_CLASSES must follow POOL_MIN and CPU_POOL_MAX.");
+
+static std::atomic<size_t> hits(0);
+static std::atomic<size_t> misses(0);
+static std::atomic<size_t> huge(0);
+static std::atomic<size_t> retained(0);
+static std::atomic<size_t> trimmed(0);
+
+static size_t default_limit() {
+	
+	const char* env = getenv("CS_POOL_LIMIT");
+	if (env) {
+		long val = atol(env);
+		if (val >= 0 && *env != '\0') {
+			return (size_t) val << 20;
+		}
+	}
+	
+	return (size_t) 256 << 20;
+}
+
+static std::atomic<size_t>& limit() {
+	static std::atomic<size_t> instance(default_limit());
+	return instance;
+}
+
+//The class of bytes <= CPU_POOL_MAX, and its size in size.
+static size_t size_class(size_t bytes, size_t& size) {
+	
+	if (bytes <= POOL_MIN) {
+		size = POOL_MIN;
+		return 0;
+	}
+	
+	//2^p < bytes <= 2^(p + 1), split in 4 steps
+	size_t p = 63 - __builtin_clzll((unsigned long long) (bytes - 1));
+	size_t low = (size_t) 1 << p;
+	size_t step = low >> 2;
+	size_t k = (bytes - 1 - low) / step;
+	
+	size = low + (k + 1) * step;
+	return (p - 6) * 4 + k + 1;
+}
+
+static void* system_allocate(size_t bytes, void*) {
+	void* ptr = nullptr;
+	if (posix_memalign(&ptr, CPU_ALIGNMENT, bytes) != 0) {
+		return nullptr;
+	}
+	return ptr;
+}
+
+static void system_release(void* ptr, size_t, void*) {
+	free(ptr);
+}
+
+//The free lists of a thread. The next buffer of a list is written in the first bytes of
+//each buffer, so the lists take no memory of their own.
+struct PoolCache {
+	void* heads[POOL_CLASSES];
+	size_t bytes;
+	
+	PoolCache() :
+			bytes(0) {
+		for (size_t i = 0; i < POOL_CLASSES; i++) {
+			heads[i] = nullptr;
+		}
+	}
+	
+	size_t trim() {
+		
+		for (size_t i = 0; i < POOL_CLASSES; i++) {
+			while (heads[i]) {
+				void* next = *(void**) heads[i];
+				free(heads[i]);
+				heads[i] = next;
+			}
+		}
+		
+		size_t ans = bytes;
+		bytes = 0;
+		retained -= ans;
+		trimmed += ans;
+		return ans;
+	}
+	
+	~PoolCache();
+};
+
+//0 before the first use of the cache of the thread, 1 while it lives and 2 after it is
+//destroyed, the buffers of static objects are released after that.
+static thread_local int state = 0;
+static thread_local PoolCache cache;
+
+PoolCache::~PoolCache() {
+	trim();
+	state = 2;
+}
+
+static PoolCache* thread_cache() {
+	
+	if (state == 2) {
+		return nullptr;
+	}
+	
+	state = 1;
+	return &cache;
+}
+
+static void* pool_allocate(size_t bytes, void* ctx) {
+	
+	if (bytes > CPU_POOL_MAX) {
+		huge++;
+		return system_allocate(bytes, ctx);
+	}
+	
+	size_t size;
+	size_t c = size_class(bytes, size);
+	
+	PoolCache* cache = thread_cache();
+	if (cache && cache->heads[c]) {
+		void* ptr = cache->heads[c];
+		cache->heads[c] = *(void**) ptr;
+		cache->bytes -= size;
+		retained -= size;
+		hits++;
+		return ptr;
+	}
+	
+	misses++;
+	return system_allocate(size, ctx);
+}
+
+static void pool_release(void* ptr, size_t bytes, void* ctx) {
+	
+	if (bytes > CPU_POOL_MAX) {
+		system_release(ptr, bytes, ctx);
+		return;
+	}
+	
+	size_t size;
+	size_t c = size_class(bytes, size);
+	
+	PoolCache* cache = thread_cache();
+	if (cache == nullptr || cache->bytes + size > limit().load()) {
+		free(ptr);
+		trimmed += size;
+		return;
+	}
+	
+	*(void**) ptr = cache->heads[c];
+	cache->heads[c] = ptr;
+	cache->bytes += size;
+	retained += size;
+}
+
+CpuAllocator cpu_pool_allocator() {
+	CpuAllocator ans = { pool_allocate, pool_release, nullptr };
+	return ans;
+}
+
+CpuAllocator cpu_system_allocator() {
+	CpuAllocator ans = { system_allocate, system_release, nullptr };
+	return ans;
+}
+
+CpuPoolStats cpu_pool_stats() {
+	CpuPoolStats ans = { hits.load(), misses.load(), huge.load(), retained.load(), trimmed.load() };
+	return ans;
+}
+
+void cpu_set_pool_limit(size_t bytes) {
+	limit() = bytes;
+}
+
+size_t cpu_pool_limit() {
+	return limit().load();
+}
+
+size_t cpu_pool_trim() {
+	PoolCache* cache = thread_cache();
+	return cache ? cache->trim() : 0;
+}
+
+} // namespace cpu
+} // namespace cs
@@ -0,0 +1,512 @@
+/*
+ * quant.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+namespace cpu {
+
+//The int8 inference of the Affine layers: the inputs are uint8 (asymmetric, one scale per
+//batch) and the weights int8 (symmetric, one scale per output), so
+//
+//	x W[:, j] = sx * sw[j] * (qx . qw[:, j] - zero * sum(qw[:, j]))
+//
+//and the dot products are exact in int32. The tiles take 4 consecutive values of a row of A
+//at a time: vpmaddubsw multiplies the uint8 by the int8 and adds the pairs to int16, vpdpbusd
+//(VNNI) adds the 4 products straight to int32.
+
+//The weights are in [-63, 63] so the pairs of vpmaddubsw (255 * 63 * 2) never saturate the
+//int16. Every kernel uses the same 7 bit weights, the results do not depend on the processor.
+static const int32_t QWEIGHT_MAX = 63;
+
+//Rows and columns of C of a tile. The columns of W are packed in blocks of QNR: for each
+//group of 4 rows of W, the 4 values of the column j of the block are at j * 4.
+static const size_t QMR = 4;
+static const size_t QNR = 16;
+
+//Rows of C of a task, a multiple of QMR.
+static const size_t QROWS = 64;
+
+//Elements of a task of the quantization.
+static const size_t QUANT_CHUNK = 1 << 14;
+
+//A tile of C: rows a[r] of A and c[r] of C, a null c[r] is a row past the end of C.
+struct QTile {
+	const uint8_t* a[QMR];
+	float* c[QMR];
+	//groups of 4 values of a row of A
+	size_t groups;
+	//the packed block of QNR columns
+	const int8_t* b;
+	//zero * the column sums, sx * sw and the bias of the columns of the block
+	const int32_t* zsums;
+	const float* mults;
+	const float* bias;
+	//columns of the block in C, at most QNR
+	size_t cols;
+};
+
+struct QuantKernels {
+	//lo = min(lo, src) and hi = max(hi, src) over the (m x n) SRC, where lo <= 0 <= hi
+	void (*range)(const float* src, size_t lds, size_t m, size_t n, float& lo, float& hi);
+	//dest = round(src * inv) + zero clamped to [0, 255], for l values
+	void (*quantize)(const float* src, uint8_t* dest, size_t l, float inv, int32_t zero);
+	void (*tile)(const QTile& t);
+};
+
+static inline int32_t load_group(const uint8_t* a) {
+	int32_t ans;
+	memcpy(&ans, a, sizeof(ans));
+	return ans;
+}
+
+//Generic
+//=============================================================================
+static inline uint8_t quantize_value(float x, float inv, int32_t zero) {
+	//nearbyint rounds to even like vcvtps2dq
+	int32_t q = (int32_t) nearbyintf(x * inv) + zero;
+	return (uint8_t) std::min(255, std::max(0, q));
+}
+
+static void range_generic(const float* src, size_t lds, size_t m, size_t n, float& lo, float& hi) {
+	for (size_t i = 0; i < m; i++) {
+		for (size_t j = 0; j < n; j++) {
+			lo = std::min(lo, src[i * lds + j]);
+			hi = std::max(hi, src[i * lds + j]);
+		}
+	}
+}
+
+static void quantize_generic(const float* src, uint8_t* dest, size_t l, float inv, int32_t zero) {
+	for (size_t i = 0; i < l; i++) {
+		dest[i] = quantize_value(src[i], inv, zero);
+	}
+}
+
+static void tile_generic(const QTile& t) {
+	
+	for (size_t r = 0; r < QMR; r++) {
+		if (t.c[r] == nullptr) {
+			continue;
+		}
+	
+		for (size_t j = 0; j < t.cols; j++) {
+			int32_t acc = 0;
+			for (size_t g = 0; g < t.groups; g++) {
+				const uint8_t* a = t.a[r] + g * 4;
+				const int8_t* b = t.b + g * 4 * QNR + j * 4;
+				acc += a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+			}
+			t.c[r][j] = (float) (acc - t.zsums[j]) * t.mults[j] + t.bias[j];
+		}
+	}
+}
+
+#ifdef CS_CPU_X86
+
+//AVX2
+//=============================================================================
+//The first rem lanes.
+CS_TARGET("avx2,fma")
+static inline __m256i tail_mask(size_t rem) {
+	return _mm256_cmpgt_epi32(_mm256_set1_epi32((int) rem), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+CS_TARGET("avx2,fma")
+static void range_avx2(const float* src, size_t lds, size_t m, size_t n, float& lo, float& hi) {
+	
+	__m256 vlo = _mm256_set1_ps(lo);
+	__m256 vhi = _mm256_set1_ps(hi);
+	const __m256i mask = tail_mask(n % 8);
+	
+	for (size_t i = 0; i < m; i++) {
+		const float* row = src + i * lds;
+		
+		size_t j = 0;
+		for (; j + 8 <= n; j += 8) {
+			__m256 v = _mm256_loadu_ps(row + j);
+			vlo = _mm256_min_ps(vlo, v);
+			vhi = _mm256_max_ps(vhi, v);
+		}
+		
+		if (j < n) {
+			//the masked lanes are 0, which is already in the range
+			__m256 v = _mm256_maskload_ps(row + j, mask);
+			vlo = _mm256_min_ps(vlo, v);
+			vhi = _mm256_max_ps(vhi, v);
+		}
+	}
+	
+	float lanes[8];
+	_mm256_storeu_ps(lanes, vlo);
+	lo = *std::min_element(lanes, lanes + 8);
+	_mm256_storeu_ps(lanes, vhi);
+	hi = *std::max_element(lanes, lanes + 8);
+}
+
+//8 values to uint8, in the low 8 bytes.
+CS_TARGET("avx2,fma")
+static inline __m128i quantize8_avx2(__m256 v, __m256 vinv, __m256i vzero) {
+	__m256i q = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(v, vinv)), vzero);
+	__m128i w = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+	return _mm_packus_epi16(w, w);
+}
+
+CS_TARGET("avx2,fma")
+static void quantize_avx2(const float* src, uint8_t* dest, size_t l, float inv, int32_t zero) {
+	
+	const __m256 vinv = _mm256_set1_ps(inv);
+	const __m256i vzero = _mm256_set1_epi32(zero);
+	//the packs interleave the 128 bit lanes
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	
+	size_t i = 0;
+	for (; i + 32 <= l; i += 32) {
+		__m256i q0 = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), vinv)), vzero);
+		__m256i q1 = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), vinv)), vzero);
+		__m256i q2 = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 16), vinv)), vzero);
+		__m256i q3 = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 24), vinv)), vzero);
+		
+		//the unsigned saturation is the clamp to [0, 255]
+		__m256i q = _mm256_packus_epi16(_mm256_packs_epi32(q0, q1), _mm256_packs_epi32(q2, q3));
+		_mm256_storeu_si256((__m256i*) (dest + i), _mm256_permutevar8x32_epi32(q, order));
+	}
+	
+	for (; i + 8 <= l; i += 8) {
+		_mm_storel_epi64((__m128i*) (dest + i), quantize8_avx2(_mm256_loadu_ps(src + i), vinv, vzero));
+	}
+	
+	//the rows of the inputs are often shorter than 8
+	if (i < l) {
+		uint8_t tmp[16];
+		_mm_storeu_si128((__m128i*) tmp, quantize8_avx2(_mm256_maskload_ps(src + i, tail_mask(l - i)), vinv, vzero));
+		memcpy(dest + i, tmp, l - i);
+	}
+}
+
+//C of a row from the int32 sums of its 16 columns.
+CS_TARGET("avx2,fma")
+static inline void tile_store_avx2(const QTile& t, float* c, __m256i lo, __m256i hi) {
+	
+	__m256 f0 = _mm256_cvtepi32_ps(_mm256_sub_epi32(lo, _mm256_loadu_si256((const __m256i*) t.zsums)));
+	__m256 f1 = _mm256_cvtepi32_ps(_mm256_sub_epi32(hi, _mm256_loadu_si256((const __m256i*) (t.zsums + 8))));
+	f0 = _mm256_fmadd_ps(f0, _mm256_loadu_ps(t.mults), _mm256_loadu_ps(t.bias));
+	f1 = _mm256_fmadd_ps(f1, _mm256_loadu_ps(t.mults + 8), _mm256_loadu_ps(t.bias + 8));
+	
+	if (t.cols == QNR) {
+		_mm256_storeu_ps(c, f0);
+		_mm256_storeu_ps(c + 8, f1);
+		return;
+	}
+	
+	float tmp[QNR];
+	_mm256_storeu_ps(tmp, f0);
+	_mm256_storeu_ps(tmp + 8, f1);
+	std::copy(tmp, tmp + t.cols, c);
+}
+
+//A 4 x 16 tile, CS_QDOT(acc, a, b) adds the products of the groups of 4 bytes of a and b to acc.
+#define CS_QROW_DECL(i) __m256i c##i##0 = _mm256_setzero_si256(), c##i##1 = _mm256_setzero_si256();
+#define CS_QROW_DOT(i) a = _mm256_set1_epi32(load_group(t.a[i] + g * 4)); \
+		CS_QDOT(c##i##0, a, b0) \
+		CS_QDOT(c##i##1, a, b1)
+#define CS_QROW_STORE(i) if (t.c[i]) { \
+		tile_store_avx2(t, t.c[i], c##i##0, c##i##1); \
+	}
+
+CS_TARGET("avx2,fma")
+static void tile_avx2(const QTile& t) {
+	const __m256i ones = _mm256_set1_epi16(1);
+#define CS_QDOT(acc, a, b) acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+	CS_QROW_DECL(0) CS_QROW_DECL(1) CS_QROW_DECL(2) CS_QROW_DECL(3)
+	
+	const int8_t* b = t.b;
+	for (size_t g = 0; g < t.groups; g++) {
+		__m256i b0 = _mm256_loadu_si256((const __m256i*) b);
+		__m256i b1 = _mm256_loadu_si256((const __m256i*) (b + 32));
+		__m256i a;
+		
+		CS_QROW_DOT(0) CS_QROW_DOT(1) CS_QROW_DOT(2) CS_QROW_DOT(3)
+		b += 4 * QNR;
+	}
+	
+	CS_QROW_STORE(0) CS_QROW_STORE(1) CS_QROW_STORE(2) CS_QROW_STORE(3)
+#undef CS_QDOT
+}
+
+#ifdef CS_CPU_VNNI
+
+//VNNI
+//=============================================================================
+CS_TARGET("avx2,fma,avxvnni")
+static void tile_avx_vnni(const QTile& t) {
+#define CS_QDOT(acc, a, b) acc = _mm256_dpbusd_avx_epi32(acc, a, b);
+	CS_QROW_DECL(0) CS_QROW_DECL(1) CS_QROW_DECL(2) CS_QROW_DECL(3)
+	
+	const int8_t* b = t.b;
+	for (size_t g = 0; g < t.groups; g++) {
+		__m256i b0 = _mm256_loadu_si256((const __m256i*) b);
+		__m256i b1 = _mm256_loadu_si256((const __m256i*) (b + 32));
+		__m256i a;
+		
+		CS_QROW_DOT(0) CS_QROW_DOT(1) CS_QROW_DOT(2) CS_QROW_DOT(3)
+		b += 4 * QNR;
+	}
+	
+	CS_QROW_STORE(0) CS_QROW_STORE(1) CS_QROW_STORE(2) CS_QROW_STORE(3)
+#undef CS_QDOT
+}
+
+CS_TARGET("avx2,fma,avx512vnni,avx512vl")
+static void tile_avx512_vnni(const QTile& t) {
+#define CS_QDOT(acc, a, b) acc = _mm256_dpbusd_epi32(acc, a, b);
+	CS_QROW_DECL(0) CS_QROW_DECL(1) CS_QROW_DECL(2) CS_QROW_DECL(3)
+	
+	const int8_t* b = t.b;
+	for (size_t g = 0; g < t.groups; g++) {
+		__m256i b0 = _mm256_loadu_si256((const __m256i*) b);
+		__m256i b1 = _mm256_loadu_si256((const __m256i*) (b + 32));
+		__m256i a;
+		
+		CS_QROW_DOT(0) CS_QROW_DOT(1) CS_QROW_DOT(2) CS_QROW_DOT(3)
+		b += 4 * QNR;
+	}
+	
+	CS_QROW_STORE(0) CS_QROW_STORE(1) CS_QROW_STORE(2) CS_QROW_STORE(3)
+#undef CS_QDOT
+}
+
+#endif
+
+#undef CS_QROW_DECL
+#undef CS_QROW_DOT
+#undef CS_QROW_STORE
+
+#endif
+
+static const QuantKernels& quant_kernels() {
+	
+	static const QuantKernels generic = { range_generic, quantize_generic, tile_generic };
+#ifdef CS_CPU_X86
+	static const QuantKernels avx2 = { range_avx2, quantize_avx2, tile_avx2 };
+#ifdef CS_CPU_VNNI
+	static const QuantKernels avxVnni = { range_avx2, quantize_avx2, tile_avx_vnni };
+	static const QuantKernels avx512Vnni = { range_avx2, quantize_avx2, tile_avx512_vnni };
+	
+	if (cpu_has_avx_vnni()) {
+		return avxVnni;
+	}
+	
+	if (cpu_has_avx512_vnni()) {
+		return avx512Vnni;
+	}
+#endif
+
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+struct QuantizeJob {
+	const float* src;
+	size_t lds;
+	uint8_t* dest;
+	size_t ldd;
+	size_t m;
+	size_t n;
+	float inv;
+	int32_t zero;
+	size_t rows;
+	//the range of each task instead of the quantization, when not null
+	float* los;
+	float* his;
+};
+
+static void quantize_chunk(size_t task, void* ctx) {
+	
+	const QuantizeJob& job = *(const QuantizeJob*) ctx;
+	const QuantKernels& kernels = quant_kernels();
+	
+	size_t start = task * job.rows;
+	size_t end = std::min(job.m, start + job.rows);
+	
+	//the rows without padding are a single one, the inputs often have a few columns
+	size_t rows = end - start;
+	size_t n = job.n;
+	bool packed = job.lds == job.n && (job.los || job.ldd == job.n);
+	if (packed) {
+		n *= rows;
+		rows = 1;
+	}
+	
+	const float* src = job.src + start * job.lds;
+	if (job.los) {
+		float lo = 0.0f;
+		float hi = 0.0f;
+		kernels.range(src, job.lds, rows, n, lo, hi);
+		job.los[task] = lo;
+		job.his[task] = hi;
+		return;
+	}
+	
+	uint8_t* dest = job.dest + start * job.ldd;
+	for (size_t i = 0; i < rows; i++) {
+		kernels.quantize(src + i * job.lds, dest + i * job.ldd, n, job.inv, job.zero);
+	}
+}
+
+CpuQuant cpu_quantize(float* src, size_t lds, uint8_t* dest, size_t ldd, size_t m, size_t n) {
+	
+	CpuQuant q = { 1.0f, 0 };
+	if (m == 0 || n == 0) {
+		return q;
+	}
+	
+	QuantizeJob job = { src, lds, dest, ldd, m, n, 1.0f, 0, std::max((size_t) 1, QUANT_CHUNK / n), nullptr, nullptr };
+	size_t tasks = (m + job.rows - 1) / job.rows;
+	
+	//the range in one pass, 0 is in it so the zeros of the inputs (the one hot columns) stay exact
+	std::vector<float> los(tasks);
+	std::vector<float> his(tasks);
+	job.los = los.data();
+	job.his = his.data();
+	cpu_parallel(tasks, quantize_chunk, &job);
+	
+	float lo = *std::min_element(los.begin(), los.end());
+	float hi = *std::max_element(his.begin(), his.end());
+	if (hi > lo) {
+		q.scale = (hi - lo) / 255.0f;
+		q.zero = std::min(255, std::max(0, (int32_t) nearbyintf(-lo / q.scale)));
+	}
+	
+	job.inv = 1.0f / q.scale;
+	job.zero = q.zero;
+	job.los = nullptr;
+	job.his = nullptr;
+	cpu_parallel(tasks, quantize_chunk, &job);
+	
+	return q;
+}
+
+//Groups of 4 rows of W.
+static size_t qgroups(size_t n) {
+	return (n + 3) / 4;
+}
+
+size_t cpu_qpack_size(size_t n, size_t p) {
+	return (p + QNR - 1) / QNR * qgroups(n) * 4 * QNR;
+}
+
+void cpu_qpack(float* w, size_t ldw, size_t n, size_t p, int8_t* packed, float* scales, int32_t* sums) {
+	
+	size_t groups = qgroups(n);
+	std::fill(packed, packed + cpu_qpack_size(n, p), (int8_t) 0);
+	
+	for (size_t j = 0; j < p; j++) {
+	
+		float amax = 0.0f;
+		for (size_t k = 0; k < n; k++) {
+			amax = std::max(amax, fabsf(w[k * ldw + j]));
+		}
+	
+		scales[j] = amax > 0.0f ? amax / QWEIGHT_MAX : 1.0f;
+		sums[j] = 0;
+	
+		int8_t* block = packed + j / QNR * groups * 4 * QNR + j % QNR * 4;
+		for (size_t k = 0; k < n; k++) {
+			int32_t q = (int32_t) nearbyintf(w[k * ldw + j] / scales[j]);
+			q = std::min(QWEIGHT_MAX, std::max(-QWEIGHT_MAX, q));
+	
+			block[k / 4 * 4 * QNR + k % 4] = (int8_t) q;
+			sums[j] += q;
+		}
+	}
+}
+
+struct QAffineJob {
+	const uint8_t* a;
+	size_t lda;
+	const int8_t* packed;
+	float* c;
+	size_t ldc;
+	size_t m;
+	size_t n;
+	size_t p;
+	//per column, padded to the blocks
+	const int32_t* zsums;
+	const float* mults;
+	const float* bias;
+};
+
+static void qaffine_chunk(size_t task, void* ctx) {
+	
+	const QAffineJob& job = *(const QAffineJob*) ctx;
+	const QuantKernels& kernels = quant_kernels();
+	
+	size_t start = task * QROWS;
+	size_t end = std::min(job.m, start + QROWS);
+	size_t groups = qgroups(job.n);
+	
+	QTile t;
+	t.groups = groups;
+	
+	//a block of columns is reused by all the rows of the task, which stay in L1
+	for (size_t jb = 0; jb < job.p; jb += QNR) {
+		t.b = job.packed + jb / QNR * groups * 4 * QNR;
+		t.zsums = job.zsums + jb;
+		t.mults = job.mults + jb;
+		t.bias = job.bias + jb;
+		t.cols = std::min(QNR, job.p - jb);
+	
+		for (size_t i = start; i < end; i += QMR) {
+			for (size_t r = 0; r < QMR; r++) {
+				//the rows past the end repeat the first one and are not stored
+				bool inside = i + r < end;
+				t.a[r] = job.a + (inside ? i + r : i) * job.lda;
+				t.c[r] = inside ? job.c + (i + r) * job.ldc + jb : nullptr;
+			}
+			kernels.tile(t);
+		}
+	}
+}
+
+void cpu_qaffine(uint8_t* a, size_t lda, CpuQuant q, int8_t* packed, float* scales, int32_t* sums, float* b,
+		float* c, size_t ldc, size_t m, size_t n, size_t p) {
+	
+	if (m == 0 || p == 0) {
+		return;
+	}
+	
+	//the tiles read whole blocks of columns
+	size_t padded = (p + QNR - 1) / QNR * QNR;
+	std::vector<int32_t> zsums(padded, 0);
+	std::vector<float> mults(padded, 0.0f);
+	std::vector<float> bias(padded, 0.0f);
+	for (size_t j = 0; j < p; j++) {
+		zsums[j] = q.zero * sums[j];
+		mults[j] = q.scale * scales[j];
+		bias[j] = b[j];
+	}
+	
+	QAffineJob job = { a, lda, packed, c, ldc, m, n, p, zsums.data(), mults.data(), bias.data() };
+	cpu_parallel((m + QROWS - 1) / QROWS, qaffine_chunk, &job);
+}
+
+} // namespace cpu
+} // namespace cs
@@ -0,0 +1,1021 @@
+/*
+ * reduce.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+namespace cpu {
+
+//The kernels reduce a contiguous range with several independent accumulators, so
+//consecutive adds do not wait for each other, and every lane of the accumulators
+//holds its own partial result. A sum is computed in blocks of REDUCE_BLOCK floats,
+//each block in float (every lane adds at most REDUCE_BLOCK / 32 values) and the
+//blocks in double, so the error does not grow with the length like a single float
+//accumulator does. The doubles are summed in double, a block of them in 4 or 8 lanes.
+//
+//Large inputs are split in tasks of a fixed size that do not depend on the number
+//of threads and the partial results are combined in task order, so the result is
+//the same for any thread count.
+static const size_t REDUCE_BLOCK = 4096;
+
+//Elements reduced by one task.
+static const size_t REDUCE_CHUNK = 1 << 16;
+
+//Rows reduced by one task of the reductions over the rows.
+static const size_t REDUCE_ROWS_CHUNK = 1024;
+
+enum ReduceOp {
+	REDUCE_SUM, REDUCE_MAX, REDUCE_MIN, REDUCE_SQ_DEV
+};
+
+template<typename T>
+struct ReduceKernels {
+	T (*sum)(const T* a, size_t l);
+	T (*max)(const T* a, size_t l);
+	T (*min)(const T* a, size_t l);
+	//sum of (a[i] - center)^2
+	T (*sq_dev)(const T* a, size_t l, T center);
+	
+	//dest[j] = op(dest[j], row[j])
+	void (*add_row)(T* dest, const T* row, size_t n);
+	void (*max_row)(T* dest, const T* row, size_t n);
+	void (*min_row)(T* dest, const T* row, size_t n);
+};
+
+//Adds the lanes in pairs, as a tree.
+template<typename T>
+static T lanes_sum(T* lanes, size_t k) {
+	for (; k > 1; k /= 2) {
+		for (size_t i = 0; i < k / 2; i++) {
+			lanes[i] = lanes[i] + lanes[i + k / 2];
+		}
+	}
+	return lanes[0];
+}
+
+template<typename T>
+static T lanes_max(const T* lanes, size_t k) {
+	return *std::max_element(lanes, lanes + k);
+}
+
+template<typename T>
+static T lanes_min(const T* lanes, size_t k) {
+	return *std::min_element(lanes, lanes + k);
+}
+
+//Generic
+//=============================================================================
+template<typename T>
+static T sum_generic(const T* a, size_t l) {
+	
+	T s[8] = { 0 };
+	size_t i = 0;
+	for (; i + 8 <= l; i += 8) {
+		for (size_t k = 0; k < 8; k++) {
+			s[k] += a[i + k];
+		}
+	}
+	
+	T ans = lanes_sum(s, 8);
+	for (; i < l; i++) {
+		ans += a[i];
+	}
+	return ans;
+}
+
+template<typename T>
+static T max_generic(const T* a, size_t l) {
+	
+	T ans = a[0];
+	for (size_t i = 1; i < l; i++) {
+		ans = std::max(ans, a[i]);
+	}
+	return ans;
+}
+
+template<typename T>
+static T min_generic(const T* a, size_t l) {
+	
+	T ans = a[0];
+	for (size_t i = 1; i < l; i++) {
+		ans = std::min(ans, a[i]);
+	}
+	return ans;
+}
+
+template<typename T>
+static T sq_dev_generic(const T* a, size_t l, T center) {
+	
+	T s[8] = { 0 };
+	size_t i = 0;
+	for (; i + 8 <= l; i += 8) {
+		for (size_t k = 0; k < 8; k++) {
+			T d = a[i + k] - center;
+			s[k] += d * d;
+		}
+	}
+	
+	T ans = lanes_sum(s, 8);
+	for (; i < l; i++) {
+		T d = a[i] - center;
+		ans += d * d;
+	}
+	return ans;
+}
+
+template<typename T>
+static void add_row_generic(T* dest, const T* row, size_t n) {
+	for (size_t j = 0; j < n; j++) {
+		dest[j] += row[j];
+	}
+}
+
+template<typename T>
+static void max_row_generic(T* dest, const T* row, size_t n) {
+	for (size_t j = 0; j < n; j++) {
+		dest[j] = std::max(dest[j], row[j]);
+	}
+}
+
+template<typename T>
+static void min_row_generic(T* dest, const T* row, size_t n) {
+	for (size_t j = 0; j < n; j++) {
+		dest[j] = std::min(dest[j], row[j]);
+	}
+}
+
+#ifdef CS_CPU_X86
+
+//AVX2, 4 accumulators of 8 lanes
+//=============================================================================
+CS_TARGET("avx2")
+static float sum_avx2(const float* a, size_t l) {
+	
+	__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+	__m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+	
+	size_t i = 0;
+	for (; i + 32 <= l; i += 32) {
+		s0 = _mm256_add_ps(s0, _mm256_loadu_ps(a + i));
+		s1 = _mm256_add_ps(s1, _mm256_loadu_ps(a + i + 8));
+		s2 = _mm256_add_ps(s2, _mm256_loadu_ps(a + i + 16));
+		s3 = _mm256_add_ps(s3, _mm256_loadu_ps(a + i + 24));
+	}
+	for (; i + 8 <= l; i += 8) {
+		s0 = _mm256_add_ps(s0, _mm256_loadu_ps(a + i));
+	}
+	
+	float lanes[8];
+	_mm256_storeu_ps(lanes, _mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+	
+	float ans = lanes_sum(lanes, 8);
+	for (; i < l; i++) {
+		ans += a[i];
+	}
+	return ans;
+}
+
+CS_TARGET("avx2")
+static float max_avx2(const float* a, size_t l) {
+	
+	if (l < 8) {
+		return max_generic(a, l);
+	}
+	
+	__m256 m0 = _mm256_loadu_ps(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 8;
+	for (; i + 32 <= l; i += 32) {
+		m0 = _mm256_max_ps(m0, _mm256_loadu_ps(a + i));
+		m1 = _mm256_max_ps(m1, _mm256_loadu_ps(a + i + 8));
+		m2 = _mm256_max_ps(m2, _mm256_loadu_ps(a + i + 16));
+		m3 = _mm256_max_ps(m3, _mm256_loadu_ps(a + i + 24));
+	}
+	for (; i + 8 <= l; i += 8) {
+		m0 = _mm256_max_ps(m0, _mm256_loadu_ps(a + i));
+	}
+	
+	float lanes[8];
+	_mm256_storeu_ps(lanes, _mm256_max_ps(_mm256_max_ps(m0, m1), _mm256_max_ps(m2, m3)));
+	
+	float ans = lanes_max(lanes, 8);
+	for (; i < l; i++) {
+		ans = std::max(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx2")
+static float min_avx2(const float* a, size_t l) {
+	
+	if (l < 8) {
+		return min_generic(a, l);
+	}
+	
+	__m256 m0 = _mm256_loadu_ps(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 8;
+	for (; i + 32 <= l; i += 32) {
+		m0 = _mm256_min_ps(m0, _mm256_loadu_ps(a + i));
+		m1 = _mm256_min_ps(m1, _mm256_loadu_ps(a + i + 8));
+		m2 = _mm256_min_ps(m2, _mm256_loadu_ps(a + i + 16));
+		m3 = _mm256_min_ps(m3, _mm256_loadu_ps(a + i + 24));
+	}
+	for (; i + 8 <= l; i += 8) {
+		m0 = _mm256_min_ps(m0, _mm256_loadu_ps(a + i));
+	}
+	
+	float lanes[8];
+	_mm256_storeu_ps(lanes, _mm256_min_ps(_mm256_min_ps(m0, m1), _mm256_min_ps(m2, m3)));
+	
+	float ans = lanes_min(lanes, 8);
+	for (; i < l; i++) {
+		ans = std::min(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx2,fma")
+static float sq_dev_avx2(const float* a, size_t l, float center) {
+	
+	const __m256 c = _mm256_set1_ps(center);
+	__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+	__m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+	__m256 d0, d1, d2, d3;
+	
+	size_t i = 0;
+	for (; i + 32 <= l; i += 32) {
+		d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), c);
+		d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), c);
+		d2 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 16), c);
+		d3 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 24), c);
+		s0 = _mm256_fmadd_ps(d0, d0, s0);
+		s1 = _mm256_fmadd_ps(d1, d1, s1);
+		s2 = _mm256_fmadd_ps(d2, d2, s2);
+		s3 = _mm256_fmadd_ps(d3, d3, s3);
+	}
+	for (; i + 8 <= l; i += 8) {
+		d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), c);
+		s0 = _mm256_fmadd_ps(d0, d0, s0);
+	}
+	
+	float lanes[8];
+	_mm256_storeu_ps(lanes, _mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+	
+	float ans = lanes_sum(lanes, 8);
+	for (; i < l; i++) {
+		float d = a[i] - center;
+		ans += d * d;
+	}
+	return ans;
+}
+
+CS_TARGET("avx2")
+static void add_row_avx2(float* dest, const float* row, size_t n) {
+	size_t j = 0;
+	for (; j + 8 <= n; j += 8) {
+		_mm256_storeu_ps(dest + j, _mm256_add_ps(_mm256_loadu_ps(dest + j), _mm256_loadu_ps(row + j)));
+	}
+	//avoids the AVX to SSE transition of the generic tail, paid once per row otherwise
+	_mm256_zeroupper();
+	add_row_generic(dest + j, row + j, n - j);
+}
+
+CS_TARGET("avx2")
+static void max_row_avx2(float* dest, const float* row, size_t n) {
+	size_t j = 0;
+	for (; j + 8 <= n; j += 8) {
+		_mm256_storeu_ps(dest + j, _mm256_max_ps(_mm256_loadu_ps(dest + j), _mm256_loadu_ps(row + j)));
+	}
+	_mm256_zeroupper();
+	max_row_generic(dest + j, row + j, n - j);
+}
+
+CS_TARGET("avx2")
+static void min_row_avx2(float* dest, const float* row, size_t n) {
+	size_t j = 0;
+	for (; j + 8 <= n; j += 8) {
+		_mm256_storeu_ps(dest + j, _mm256_min_ps(_mm256_loadu_ps(dest + j), _mm256_loadu_ps(row + j)));
+	}
+	_mm256_zeroupper();
+	min_row_generic(dest + j, row + j, n - j);
+}
+
+//AVX2 doubles, 4 accumulators of 4 lanes
+//=============================================================================
+CS_TARGET("avx2")
+static double sum_avx2(const double* a, size_t l) {
+	
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+	__m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+	
+	size_t i = 0;
+	for (; i + 16 <= l; i += 16) {
+		s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+		s1 = _mm256_add_pd(s1, _mm256_loadu_pd(a + i + 4));
+		s2 = _mm256_add_pd(s2, _mm256_loadu_pd(a + i + 8));
+		s3 = _mm256_add_pd(s3, _mm256_loadu_pd(a + i + 12));
+	}
+	for (; i + 4 <= l; i += 4) {
+		s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+	}
+	
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+	
+	double ans = lanes_sum(lanes, 4);
+	for (; i < l; i++) {
+		ans += a[i];
+	}
+	return ans;
+}
+
+CS_TARGET("avx2")
+static double max_avx2(const double* a, size_t l) {
+	
+	if (l < 4) {
+		return max_generic(a, l);
+	}
+	
+	__m256d m0 = _mm256_loadu_pd(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 4;
+	for (; i + 16 <= l; i += 16) {
+		m0 = _mm256_max_pd(m0, _mm256_loadu_pd(a + i));
+		m1 = _mm256_max_pd(m1, _mm256_loadu_pd(a + i + 4));
+		m2 = _mm256_max_pd(m2, _mm256_loadu_pd(a + i + 8));
+		m3 = _mm256_max_pd(m3, _mm256_loadu_pd(a + i + 12));
+	}
+	for (; i + 4 <= l; i += 4) {
+		m0 = _mm256_max_pd(m0, _mm256_loadu_pd(a + i));
+	}
+	
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_max_pd(_mm256_max_pd(m0, m1), _mm256_max_pd(m2, m3)));
+	
+	double ans = lanes_max(lanes, 4);
+	for (; i < l; i++) {
+		ans = std::max(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx2")
+static double min_avx2(const double* a, size_t l) {
+	
+	if (l < 4) {
+		return min_generic(a, l);
+	}
+	
+	__m256d m0 = _mm256_loadu_pd(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 4;
+	for (; i + 16 <= l; i += 16) {
+		m0 = _mm256_min_pd(m0, _mm256_loadu_pd(a + i));
+		m1 = _mm256_min_pd(m1, _mm256_loadu_pd(a + i + 4));
+		m2 = _mm256_min_pd(m2, _mm256_loadu_pd(a + i + 8));
+		m3 = _mm256_min_pd(m3, _mm256_loadu_pd(a + i + 12));
+	}
+	for (; i + 4 <= l; i += 4) {
+		m0 = _mm256_min_pd(m0, _mm256_loadu_pd(a + i));
+	}
+	
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_min_pd(_mm256_min_pd(m0, m1), _mm256_min_pd(m2, m3)));
+	
+	double ans = lanes_min(lanes, 4);
+	for (; i < l; i++) {
+		ans = std::min(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx2,fma")
+static double sq_dev_avx2(const double* a, size_t l, double center) {
+	
+	const __m256d c = _mm256_set1_pd(center);
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+	__m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+	__m256d d0, d1, d2, d3;
+	
+	size_t i = 0;
+	for (; i + 16 <= l; i += 16) {
+		d0 = _mm256_sub_pd(_mm256_loadu_pd(a + i), c);
+		d1 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), c);
+		d2 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 8), c);
+		d3 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 12), c);
+		s0 = _mm256_fmadd_pd(d0, d0, s0);
+		s1 = _mm256_fmadd_pd(d1, d1, s1);
+		s2 = _mm256_fmadd_pd(d2, d2, s2);
+		s3 = _mm256_fmadd_pd(d3, d3, s3);
+	}
+	for (; i + 4 <= l; i += 4) {
+		d0 = _mm256_sub_pd(_mm256_loadu_pd(a + i), c);
+		s0 = _mm256_fmadd_pd(d0, d0, s0);
+	}
+	
+	double lanes[4];
+	_mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+	
+	double ans = lanes_sum(lanes, 4);
+	for (; i < l; i++) {
+		double d = a[i] - center;
+		ans += d * d;
+	}
+	return ans;
+}
+
+CS_TARGET("avx2")
+static void add_row_avx2(double* dest, const double* row, size_t n) {
+	size_t j = 0;
+	for (; j + 4 <= n; j += 4) {
+		_mm256_storeu_pd(dest + j, _mm256_add_pd(_mm256_loadu_pd(dest + j), _mm256_loadu_pd(row + j)));
+	}
+	_mm256_zeroupper();
+	add_row_generic(dest + j, row + j, n - j);
+}
+
+CS_TARGET("avx2")
+static void max_row_avx2(double* dest, const double* row, size_t n) {
+	size_t j = 0;
+	for (; j + 4 <= n; j += 4) {
+		_mm256_storeu_pd(dest + j, _mm256_max_pd(_mm256_loadu_pd(dest + j), _mm256_loadu_pd(row + j)));
+	}
+	_mm256_zeroupper();
+	max_row_generic(dest + j, row + j, n - j);
+}
+
+CS_TARGET("avx2")
+static void min_row_avx2(double* dest, const double* row, size_t n) {
+	size_t j = 0;
+	for (; j + 4 <= n; j += 4) {
+		_mm256_storeu_pd(dest + j, _mm256_min_pd(_mm256_loadu_pd(dest + j), _mm256_loadu_pd(row + j)));
+	}
+	_mm256_zeroupper();
+	min_row_generic(dest + j, row + j, n - j);
+}
+
+//AVX-512, 4 accumulators of 16 lanes
+//=============================================================================
+CS_TARGET("avx512f")
+static float sum_avx512(const float* a, size_t l) {
+	
+	__m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+	__m512 s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+	
+	size_t i = 0;
+	for (; i + 64 <= l; i += 64) {
+		s0 = _mm512_add_ps(s0, _mm512_loadu_ps(a + i));
+		s1 = _mm512_add_ps(s1, _mm512_loadu_ps(a + i + 16));
+		s2 = _mm512_add_ps(s2, _mm512_loadu_ps(a + i + 32));
+		s3 = _mm512_add_ps(s3, _mm512_loadu_ps(a + i + 48));
+	}
+	for (; i + 16 <= l; i += 16) {
+		s0 = _mm512_add_ps(s0, _mm512_loadu_ps(a + i));
+	}
+	
+	float lanes[16];
+	_mm512_storeu_ps(lanes, _mm512_add_ps(_mm512_add_ps(s0, s1), _mm512_add_ps(s2, s3)));
+	
+	float ans = lanes_sum(lanes, 16);
+	for (; i < l; i++) {
+		ans += a[i];
+	}
+	return ans;
+}
+
+CS_TARGET("avx512f")
+static float max_avx512(const float* a, size_t l) {
+	
+	if (l < 16) {
+		return max_generic(a, l);
+	}
+	
+	__m512 m0 = _mm512_loadu_ps(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 16;
+	for (; i + 64 <= l; i += 64) {
+		m0 = _mm512_max_ps(m0, _mm512_loadu_ps(a + i));
+		m1 = _mm512_max_ps(m1, _mm512_loadu_ps(a + i + 16));
+		m2 = _mm512_max_ps(m2, _mm512_loadu_ps(a + i + 32));
+		m3 = _mm512_max_ps(m3, _mm512_loadu_ps(a + i + 48));
+	}
+	for (; i + 16 <= l; i += 16) {
+		m0 = _mm512_max_ps(m0, _mm512_loadu_ps(a + i));
+	}
+	
+	float lanes[16];
+	_mm512_storeu_ps(lanes, _mm512_max_ps(_mm512_max_ps(m0, m1), _mm512_max_ps(m2, m3)));
+	
+	float ans = lanes_max(lanes, 16);
+	for (; i < l; i++) {
+		ans = std::max(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx512f")
+static float min_avx512(const float* a, size_t l) {
+	
+	if (l < 16) {
+		return min_generic(a, l);
+	}
+	
+	__m512 m0 = _mm512_loadu_ps(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 16;
+	for (; i + 64 <= l; i += 64) {
+		m0 = _mm512_min_ps(m0, _mm512_loadu_ps(a + i));
+		m1 = _mm512_min_ps(m1, _mm512_loadu_ps(a + i + 16));
+		m2 = _mm512_min_ps(m2, _mm512_loadu_ps(a + i + 32));
+		m3 = _mm512_min_ps(m3, _mm512_loadu_ps(a + i + 48));
+	}
+	for (; i + 16 <= l; i += 16) {
+		m0 = _mm512_min_ps(m0, _mm512_loadu_ps(a + i));
+	}
+	
+	float lanes[16];
+	_mm512_storeu_ps(lanes, _mm512_min_ps(_mm512_min_ps(m0, m1), _mm512_min_ps(m2, m3)));
+	
+	float ans = lanes_min(lanes, 16);
+	for (; i < l; i++) {
+		ans = std::min(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx512f")
+static float sq_dev_avx512(const float* a, size_t l, float center) {
+	
+	const __m512 c = _mm512_set1_ps(center);
+	__m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+	__m512 s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+	__m512 d0, d1, d2, d3;
+	
+	size_t i = 0;
+	for (; i + 64 <= l; i += 64) {
+		d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), c);
+		d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), c);
+		d2 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 32), c);
+		d3 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 48), c);
+		s0 = _mm512_fmadd_ps(d0, d0, s0);
+		s1 = _mm512_fmadd_ps(d1, d1, s1);
+		s2 = _mm512_fmadd_ps(d2, d2, s2);
+		s3 = _mm512_fmadd_ps(d3, d3, s3);
+	}
+	for (; i + 16 <= l; i += 16) {
+		d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), c);
+		s0 = _mm512_fmadd_ps(d0, d0, s0);
+	}
+	
+	float lanes[16];
+	_mm512_storeu_ps(lanes, _mm512_add_ps(_mm512_add_ps(s0, s1), _mm512_add_ps(s2, s3)));
+	
+	float ans = lanes_sum(lanes, 16);
+	for (; i < l; i++) {
+		float d = a[i] - center;
+		ans += d * d;
+	}
+	return ans;
+}
+
+//AVX-512 doubles, 4 accumulators of 8 lanes
+//=============================================================================
+CS_TARGET("avx512f")
+static double sum_avx512(const double* a, size_t l) {
+	
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+	__m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+	
+	size_t i = 0;
+	for (; i + 32 <= l; i += 32) {
+		s0 = _mm512_add_pd(s0, _mm512_loadu_pd(a + i));
+		s1 = _mm512_add_pd(s1, _mm512_loadu_pd(a + i + 8));
+		s2 = _mm512_add_pd(s2, _mm512_loadu_pd(a + i + 16));
+		s3 = _mm512_add_pd(s3, _mm512_loadu_pd(a + i + 24));
+	}
+	for (; i + 8 <= l; i += 8) {
+		s0 = _mm512_add_pd(s0, _mm512_loadu_pd(a + i));
+	}
+	
+	double lanes[8];
+	_mm512_storeu_pd(lanes, _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+	
+	double ans = lanes_sum(lanes, 8);
+	for (; i < l; i++) {
+		ans += a[i];
+	}
+	return ans;
+}
+
+CS_TARGET("avx512f")
+static double max_avx512(const double* a, size_t l) {
+	
+	if (l < 8) {
+		return max_generic(a, l);
+	}
+	
+	__m512d m0 = _mm512_loadu_pd(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 8;
+	for (; i + 32 <= l; i += 32) {
+		m0 = _mm512_max_pd(m0, _mm512_loadu_pd(a + i));
+		m1 = _mm512_max_pd(m1, _mm512_loadu_pd(a + i + 8));
+		m2 = _mm512_max_pd(m2, _mm512_loadu_pd(a + i + 16));
+		m3 = _mm512_max_pd(m3, _mm512_loadu_pd(a + i + 24));
+	}
+	for (; i + 8 <= l; i += 8) {
+		m0 = _mm512_max_pd(m0, _mm512_loadu_pd(a + i));
+	}
+	
+	double lanes[8];
+	_mm512_storeu_pd(lanes, _mm512_max_pd(_mm512_max_pd(m0, m1), _mm512_max_pd(m2, m3)));
+	
+	double ans = lanes_max(lanes, 8);
+	for (; i < l; i++) {
+		ans = std::max(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx512f")
+static double min_avx512(const double* a, size_t l) {
+	
+	if (l < 8) {
+		return min_generic(a, l);
+	}
+	
+	__m512d m0 = _mm512_loadu_pd(a), m1 = m0, m2 = m0, m3 = m0;
+	
+	size_t i = 8;
+	for (; i + 32 <= l; i += 32) {
+		m0 = _mm512_min_pd(m0, _mm512_loadu_pd(a + i));
+		m1 = _mm512_min_pd(m1, _mm512_loadu_pd(a + i + 8));
+		m2 = _mm512_min_pd(m2, _mm512_loadu_pd(a + i + 16));
+		m3 = _mm512_min_pd(m3, _mm512_loadu_pd(a + i + 24));
+	}
+	for (; i + 8 <= l; i += 8) {
+		m0 = _mm512_min_pd(m0, _mm512_loadu_pd(a + i));
+	}
+	
+	double lanes[8];
+	_mm512_storeu_pd(lanes, _mm512_min_pd(_mm512_min_pd(m0, m1), _mm512_min_pd(m2, m3)));
+	
+	double ans = lanes_min(lanes, 8);
+	for (; i < l; i++) {
+		ans = std::min(ans, a[i]);
+	}
+	return ans;
+}
+
+CS_TARGET("avx512f")
+static double sq_dev_avx512(const double* a, size_t l, double center) {
+	
+	const __m512d c = _mm512_set1_pd(center);
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+	__m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+	__m512d d0, d1, d2, d3;
+	
+	size_t i = 0;
+	for (; i + 32 <= l; i += 32) {
+		d0 = _mm512_sub_pd(_mm512_loadu_pd(a + i), c);
+		d1 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 8), c);
+		d2 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 16), c);
+		d3 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 24), c);
+		s0 = _mm512_fmadd_pd(d0, d0, s0);
+		s1 = _mm512_fmadd_pd(d1, d1, s1);
+		s2 = _mm512_fmadd_pd(d2, d2, s2);
+		s3 = _mm512_fmadd_pd(d3, d3, s3);
+	}
+	for (; i + 8 <= l; i += 8) {
+		d0 = _mm512_sub_pd(_mm512_loadu_pd(a + i), c);
+		s0 = _mm512_fmadd_pd(d0, d0, s0);
+	}
+	
+	double lanes[8];
+	_mm512_storeu_pd(lanes, _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+	
+	double ans = lanes_sum(lanes, 8);
+	for (; i < l; i++) {
+		double d = a[i] - center;
+		ans += d * d;
+	}
+	return ans;
+}
+
+#endif
+
+//The kernels of each element type are overloads with the same names.
+template<typename T>
+static const ReduceKernels<T>& reduce_kernels() {
+	
+	static const ReduceKernels<T> generic = { sum_generic, max_generic, min_generic, sq_dev_generic, add_row_generic,
+			max_row_generic, min_row_generic };
+#ifdef CS_CPU_X86
+	//the reductions over the rows are bound by memory, AVX2 is enough for them
+	static const ReduceKernels<T> avx2 = { sum_avx2, max_avx2, min_avx2, sq_dev_avx2, add_row_avx2, max_row_avx2,
+			min_row_avx2 };
+	static const ReduceKernels<T> avx512 = { sum_avx512, max_avx512, min_avx512, sq_dev_avx512, add_row_avx2,
+			max_row_avx2, min_row_avx2 };
+	
+	if (cpu_has_avx512()) {
+		return avx512;
+	}
+	
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+//Reduction of a whole matrix
+//=============================================================================
+
+//Reduces a contiguous range, in blocks for the sums.
+template<typename T>
+static double reduce_range(ReduceOp op, const T* a, size_t l, T center) {
+	
+	const ReduceKernels<T>& k = reduce_kernels<T>();
+	
+	if (op == REDUCE_MAX) {
+		return k.max(a, l);
+	}
+	
+	if (op == REDUCE_MIN) {
+		return k.min(a, l);
+	}
+	
+	double ans = 0.0;
+	for (size_t i = 0; i < l; i += REDUCE_BLOCK) {
+		size_t len = std::min(REDUCE_BLOCK, l - i);
+		ans += op == REDUCE_SUM ? k.sum(a + i, len) : k.sq_dev(a + i, len, center);
+	}
+	return ans;
+}
+
+static double reduce_combine(ReduceOp op, double a, double b) {
+	
+	if (op == REDUCE_MAX) {
+		return std::max(a, b);
+	}
+	
+	if (op == REDUCE_MIN) {
+		return std::min(a, b);
+	}
+	
+	return a + b;
+}
+
+template<typename T>
+struct ReduceJob {
+	ReduceOp op;
+	const T* a;
+	size_t lda;
+	size_t m;
+	size_t n;
+	T center;
+	//rows of a task, 0 when the matrix is reduced as a single contiguous range
+	size_t rows;
+	double* partial;
+};
+
+template<typename T>
+static void reduce_chunk(size_t task, void* ctx) {
+	
+	const ReduceJob<T>& job = *(const ReduceJob<T>*) ctx;
+	
+	if (job.rows == 0) {
+		size_t start = task * REDUCE_CHUNK;
+		size_t l = std::min(REDUCE_CHUNK, job.m * job.n - start);
+		job.partial[task] = reduce_range(job.op, job.a + start, l, job.center);
+		return;
+	}
+	
+	size_t start = task * job.rows;
+	size_t end = std::min(job.m, start + job.rows);
+	
+	double ans = reduce_range(job.op, job.a + start * job.lda, job.n, job.center);
+	for (size_t i = start + 1; i < end; i++) {
+		ans = reduce_combine(job.op, ans, reduce_range(job.op, job.a + i * job.lda, job.n, job.center));
+	}
+	job.partial[task] = ans;
+}
+
+template<typename T>
+static double reduce(ReduceOp op, T* a, size_t lda, size_t m, size_t n, T center) {
+	
+	ReduceJob<T> job = { op, a, lda, m, n, center, 0, nullptr };
+	
+	size_t tasks;
+	if (lda == n) {
+		//the padding is not in between, a single range
+		tasks = (m * n + REDUCE_CHUNK - 1) / REDUCE_CHUNK;
+	} else {
+		job.rows = std::max((size_t) 1, REDUCE_CHUNK / n);
+		tasks = (m + job.rows - 1) / job.rows;
+	}
+	
+	static thread_local std::vector<double> partial;
+	partial.resize(tasks);
+	job.partial = partial.data();
+	
+	if (tasks == 1) {
+		reduce_chunk<T>(0, &job);
+	} else {
+		cpu_parallel(tasks, reduce_chunk<T>, &job);
+	}
+	
+	double ans = partial[0];
+	for (size_t t = 1; t < tasks; t++) {
+		ans = reduce_combine(op, ans, partial[t]);
+	}
+	return ans;
+}
+
+float cpu_sum(float* a, size_t lda, size_t m, size_t n) {
+	return reduce(REDUCE_SUM, a, lda, m, n, 0.0f);
+}
+
+float cpu_max(float* a, size_t lda, size_t m, size_t n) {
+	return reduce(REDUCE_MAX, a, lda, m, n, 0.0f);
+}
+
+float cpu_min(float* a, size_t lda, size_t m, size_t n) {
+	return reduce(REDUCE_MIN, a, lda, m, n, 0.0f);
+}
+
+float cpu_sum_sq_dev(float* a, size_t lda, size_t m, size_t n, float center) {
+	return reduce(REDUCE_SQ_DEV, a, lda, m, n, center);
+}
+
+double cpu_sum(double* a, size_t lda, size_t m, size_t n) {
+	return reduce(REDUCE_SUM, a, lda, m, n, 0.0);
+}
+
+double cpu_max(double* a, size_t lda, size_t m, size_t n) {
+	return reduce(REDUCE_MAX, a, lda, m, n, 0.0);
+}
+
+double cpu_min(double* a, size_t lda, size_t m, size_t n) {
+	return reduce(REDUCE_MIN, a, lda, m, n, 0.0);
+}
+
+double cpu_sum_sq_dev(double* a, size_t lda, size_t m, size_t n, double center) {
+	return reduce(REDUCE_SQ_DEV, a, lda, m, n, center);
+}
+
+//Reductions over the rows, one result per column
+//=============================================================================
+
+template<typename T>
+struct ReduceRowsJob {
+	ReduceOp op;
+	const T* a;
+	T* partial;
+	size_t lda;
+	size_t m;
+	size_t n;
+};
+
+template<typename T>
+static void reduce_rows_range(ReduceOp op, const T* a, size_t lda, T* dest, size_t rows, size_t n) {
+	
+	const ReduceKernels<T>& k = reduce_kernels<T>();
+	void (*combine)(T*, const T*, size_t) =
+			op == REDUCE_MAX ? k.max_row : op == REDUCE_MIN ? k.min_row : k.add_row;
+	
+	std::copy(a, a + n, dest);
+	for (size_t i = 1; i < rows; i++) {
+		combine(dest, a + i * lda, n);
+	}
+}
+
+template<typename T>
+static void reduce_rows_chunk(size_t task, void* ctx) {
+	const ReduceRowsJob<T>& job = *(const ReduceRowsJob<T>*) ctx;
+	
+	size_t start = task * REDUCE_ROWS_CHUNK;
+	size_t rows = std::min(REDUCE_ROWS_CHUNK, job.m - start);
+	
+	reduce_rows_range(job.op, job.a + start * job.lda, job.lda, job.partial + task * job.n, rows, job.n);
+}
+
+template<typename T>
+static void reduce_rows(ReduceOp op, T* a, size_t lda, T* dest, size_t m, size_t n) {
+	
+	size_t tasks = (m + REDUCE_ROWS_CHUNK - 1) / REDUCE_ROWS_CHUNK;
+	if (tasks <= 1) {
+		reduce_rows_range(op, a, lda, dest, m, n);
+		return;
+	}
+	
+	//kept between calls, so a training loop does not allocate it every step
+	static thread_local std::vector<T> partial;
+	partial.resize(tasks * n);
+	
+	ReduceRowsJob<T> job = { op, a, partial.data(), lda, m, n };
+	cpu_parallel(tasks, reduce_rows_chunk<T>, &job);
+	
+	reduce_rows_range(op, partial.data(), n, dest, tasks, n);
+}
+
+void cpu_sum_rows(float* a, size_t lda, float* dest, size_t m, size_t n) {
+	reduce_rows(REDUCE_SUM, a, lda, dest, m, n);
+}
+
+void cpu_max_rows(float* a, size_t lda, float* dest, size_t m, size_t n) {
+	reduce_rows(REDUCE_MAX, a, lda, dest, m, n);
+}
+
+void cpu_min_rows(float* a, size_t lda, float* dest, size_t m, size_t n) {
+	reduce_rows(REDUCE_MIN, a, lda, dest, m, n);
+}
+
+void cpu_sum_rows(double* a, size_t lda, double* dest, size_t m, size_t n) {
+	reduce_rows(REDUCE_SUM, a, lda, dest, m, n);
+}
+
+void cpu_max_rows(double* a, size_t lda, double* dest, size_t m, size_t n) {
+	reduce_rows(REDUCE_MAX, a, lda, dest, m, n);
+}
+
+void cpu_min_rows(double* a, size_t lda, double* dest, size_t m, size_t n) {
+	reduce_rows(REDUCE_MIN, a, lda, dest, m, n);
+}
+
+//Reductions over the columns, one result per row
+//=============================================================================
+
+template<typename T>
+struct ReduceColsJob {
+	ReduceOp op;
+	const T* a;
+	T* dest;
+	size_t lda;
+	size_t m;
+	size_t n;
+	size_t rows;
+};
+
+template<typename T>
+static void reduce_cols_chunk(size_t task, void* ctx) {
+	const ReduceColsJob<T>& job = *(const ReduceColsJob<T>*) ctx;
+	
+	size_t start = task * job.rows;
+	size_t end = std::min(job.m, start + job.rows);
+	
+	for (size_t i = start; i < end; i++) {
+		job.dest[i] = reduce_range(job.op, job.a + i * job.lda, job.n, (T) 0);
+	}
+}
+
+template<typename T>
+static void reduce_cols(ReduceOp op, T* a, size_t lda, T* dest, size_t m, size_t n) {
+	
+	//every row is independent, any split gives the same result
+	size_t rows = std::max((size_t) 1, REDUCE_CHUNK / n);
+	size_t tasks = (m + rows - 1) / rows;
+	
+	ReduceColsJob<T> job = { op, a, dest, lda, m, n, rows };
+	cpu_parallel(tasks, reduce_cols_chunk<T>, &job);
+}
+
+void cpu_sum_cols(float* a, size_t lda, float* dest, size_t m, size_t n) {
+	reduce_cols(REDUCE_SUM, a, lda, dest, m, n);
+}
+
+void cpu_max_cols(float* a, size_t lda, float* dest, size_t m, size_t n) {
+	reduce_cols(REDUCE_MAX, a, lda, dest, m, n);
+}
+
+void cpu_min_cols(float* a, size_t lda, float* dest, size_t m, size_t n) {
+	reduce_cols(REDUCE_MIN, a, lda, dest, m, n);
+}
+
+void cpu_sum_cols(double* a, size_t lda, double* dest, size_t m, size_t n) {
+	reduce_cols(REDUCE_SUM, a, lda, dest, m, n);
+}
+
+void cpu_max_cols(double* a, size_t lda, double* dest, size_t m, size_t n) {
+	reduce_cols(REDUCE_MAX, a, lda, dest, m, n);
+}
+
+void cpu_min_cols(double* a, size_t lda, double* dest, size_t m, size_t n) {
+	reduce_cols(REDUCE_MIN, a, lda, dest, m, n);
+}
+
+} // namespace cpu
+} // namespace cs
@@ -0,0 +1,178 @@
+/*
+ * sparse.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+namespace cpu {
+
+//A row of C = S x B gathers the rows of B picked by the columns of S, so only the rows
+//of the active features are read. It is built in blocks of 32 values kept in registers,
+//like gemv.cpp. S^T x B is the same product over the transpose of S, see CpuSparseMatrix.
+
+//Values of S of a task.
+static const size_t SPMM_CHUNK = 1 << 12;
+
+//Values of a row of C of a block.
+static const size_t SPMM_BLOCK = 32;
+
+struct SpmmKernels {
+	//dest = sum of vals[k] * the row cols[k] of B, for k < nnz. dest has l values.
+	void (*gather)(const float* vals, const size_t* cols, size_t nnz, const float* b, size_t ldb, float* dest,
+			size_t l);
+};
+
+//Generic
+//=============================================================================
+static void gather_generic(const float* vals, const size_t* cols, size_t nnz, const float* b, size_t ldb,
+		float* dest, size_t l) {
+	std::fill(dest, dest + l, 0.0f);
+	for (size_t k = 0; k < nnz; k++) {
+		const float* row = b + cols[k] * ldb;
+		for (size_t j = 0; j < l; j++) {
+			dest[j] += vals[k] * row[j];
+		}
+	}
+}
+
+#ifdef CS_CPU_X86
+
+//AVX2
+//=============================================================================
+CS_TARGET("avx2,fma")
+static void gather_avx2(const float* vals, const size_t* cols, size_t nnz, const float* b, size_t ldb, float* dest,
+		size_t l) {
+	
+	size_t j = 0;
+	for (; j + SPMM_BLOCK <= l; j += SPMM_BLOCK) {
+		__m256 c0 = _mm256_setzero_ps();
+		__m256 c1 = _mm256_setzero_ps();
+		__m256 c2 = _mm256_setzero_ps();
+		__m256 c3 = _mm256_setzero_ps();
+	
+		for (size_t k = 0; k < nnz; k++) {
+			const float* row = b + cols[k] * ldb + j;
+			__m256 v = _mm256_set1_ps(vals[k]);
+			c0 = _mm256_fmadd_ps(v, _mm256_loadu_ps(row), c0);
+			c1 = _mm256_fmadd_ps(v, _mm256_loadu_ps(row + 8), c1);
+			c2 = _mm256_fmadd_ps(v, _mm256_loadu_ps(row + 16), c2);
+			c3 = _mm256_fmadd_ps(v, _mm256_loadu_ps(row + 24), c3);
+		}
+	
+		_mm256_storeu_ps(dest + j, c0);
+		_mm256_storeu_ps(dest + j + 8, c1);
+		_mm256_storeu_ps(dest + j + 16, c2);
+		_mm256_storeu_ps(dest + j + 24, c3);
+	}
+	
+	for (; j + 8 <= l; j += 8) {
+		__m256 c0 = _mm256_setzero_ps();
+		for (size_t k = 0; k < nnz; k++) {
+			c0 = _mm256_fmadd_ps(_mm256_set1_ps(vals[k]), _mm256_loadu_ps(b + cols[k] * ldb + j), c0);
+		}
+		_mm256_storeu_ps(dest + j, c0);
+	}
+	
+	if (j < l) {
+		_mm256_zeroupper();
+		gather_generic(vals, cols, nnz, b + j, ldb, dest + j, l - j);
+	}
+}
+
+#endif
+
+static const SpmmKernels& spmm_kernels() {
+	
+	static const SpmmKernels generic = { gather_generic };
+#ifdef CS_CPU_X86
+	static const SpmmKernels avx2 = { gather_avx2 };
+	
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+struct SpmmJob {
+	const float* vals;
+	const size_t* cols;
+	const size_t* rows;
+	const float* b;
+	size_t ldb;
+	float* c;
+	size_t ldc;
+	size_t m;
+	size_t p;
+	//rows of S of a task
+	size_t chunk;
+};
+
+static void spmm_chunk(size_t task, void* ctx) {
+	
+	const SpmmJob& job = *(const SpmmJob*) ctx;
+	const SpmmKernels& kernels = spmm_kernels();
+	
+	size_t start = task * job.chunk;
+	size_t end = std::min(job.m, start + job.chunk);
+	
+	for (size_t i = start; i < end; i++) {
+		size_t k = job.rows[i];
+		kernels.gather(job.vals + k, job.cols + k, job.rows[i + 1] - k, job.b, job.ldb, job.c + i * job.ldc, job.p);
+	}
+}
+
+void cpu_spmm(float* vals, size_t* cols, size_t* rows, float* b, size_t ldb, float* c, size_t ldc, size_t m,
+		size_t p) {
+	
+	if (m == 0 || p == 0) {
+		return;
+	}
+	
+	//rows with about SPMM_CHUNK values per task
+	size_t perRow = std::max((size_t) 1, rows[m] / m);
+	SpmmJob job = { vals, cols, rows, b, ldb, c, ldc, m, p, std::max((size_t) 1, SPMM_CHUNK / perRow) };
+	
+	cpu_parallel((m + job.chunk - 1) / job.chunk, spmm_chunk, &job);
+}
+
+void cpu_csr_transpose(float* vals, size_t* cols, size_t* rows, size_t m, size_t n, float* tvals, size_t* tcols,
+		size_t* trows) {
+	
+	//a counting sort of the values by column, the rows of a column stay sorted
+	std::fill(trows, trows + n + 1, (size_t) 0);
+	for (size_t k = 0; k < rows[m]; k++) {
+		trows[cols[k] + 1]++;
+	}
+	for (size_t j = 0; j < n; j++) {
+		trows[j + 1] += trows[j];
+	}
+	
+	for (size_t i = 0; i < m; i++) {
+		for (size_t k = rows[i]; k < rows[i + 1]; k++) {
+			size_t dest = trows[cols[k]]++;
+			tcols[dest] = i;
+			tvals[dest] = vals[k];
+		}
+	}
+	
+	//trows[j] is now the start of column j + 1
+	for (size_t j = n; j > 0; j--) {
+		trows[j] = trows[j - 1];
+	}
+	trows[0] = 0;
+}
+
+} // namespace cpu
+} // namespace cs
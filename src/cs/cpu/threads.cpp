@@ -0,0 +1,226 @@
+/*
+ * threads.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace cs {
+using namespace core;
+namespace cpu {
+
+//A fixed pool of workers. The caller of cpu_parallel also takes tasks, so with
+//N threads there are N - 1 workers. Tasks are claimed from an atomic counter;
+//which thread runs a task never changes what the task computes.
+class ThreadPool {
+	
+private:
+	vector<thread> workers;
+	mutex lock;
+	condition_variable wake;
+	condition_variable done;
+	
+	//current job, guarded by lock
+	size_t generation = 0;
+	bool stop = false;
+	void (*fn)(size_t task, void* ctx) = nullptr;
+	void* ctx = nullptr;
+	size_t tasks = 0;
+	atomic<size_t> next;
+	size_t joined = 0;
+	size_t running = 0;
+	
+	void run_tasks(void (*f)(size_t, void*), void* c, size_t total) {
+		for (;;) {
+			size_t task = next.fetch_add(1);
+			if (task >= total) {
+				break;
+			}
+			f(task, c);
+		}
+	}
+	
+	void work();
+
+public:
+	//serializes the jobs of different callers
+	mutex busy;
+	
+	ThreadPool() :
+			next(0) {
+	}
+	
+	size_t size() const {
+		return workers.size() + 1;
+	}
+	
+	void resize(size_t threads);
+	void run(size_t total, void (*f)(size_t, void*), void* c);
+	
+	~ThreadPool() {
+		resize(1);
+	}
+};
+
+static thread_local bool inside_pool = false;
+
+void ThreadPool::work() {
+	inside_pool = true;
+	
+	size_t seen = 0;
+	for (;;) {
+		void (*f)(size_t, void*);
+		void* c;
+		size_t total;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&] {return stop || generation != seen;});
+			if (stop) {
+				return;
+			}
+			seen = generation;
+			f = fn;
+			c = ctx;
+			total = tasks;
+			joined++;
+			running++;
+		}
+		
+		run_tasks(f, c, total);
+		
+		{
+			unique_lock<mutex> guard(lock);
+			running--;
+			if (running == 0 && joined == workers.size()) {
+				done.notify_all();
+			}
+		}
+	}
+}
+
+void ThreadPool::resize(size_t threads) {
+	
+	if (threads < 1) {
+		threads = 1;
+	}
+	
+	if (threads == size()) {
+		return;
+	}
+	
+	{
+		unique_lock<mutex> guard(lock);
+		stop = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+	workers.clear();
+	
+	stop = false;
+	generation = 0;
+	for (size_t i = 1; i < threads; i++) {
+		workers.push_back(thread(&ThreadPool::work, this));
+	}
+}
+
+void ThreadPool::run(size_t total, void (*f)(size_t, void*), void* c) {
+	
+	{
+		unique_lock<mutex> guard(lock);
+		fn = f;
+		ctx = c;
+		tasks = total;
+		next.store(0);
+		joined = 0;
+		generation++;
+	}
+	wake.notify_all();
+	
+	inside_pool = true;
+	run_tasks(f, c, total);
+	inside_pool = false;
+	
+	//Every worker must have seen this job and left it before the caller's context
+	//goes away, otherwise a late worker could claim tasks of the next job.
+	unique_lock<mutex> guard(lock);
+	done.wait(guard, [&] {return running == 0 && joined == workers.size();});
+}
+
+static size_t default_threads() {
+	
+	const char* env = getenv("CS_THREADS");
+	if (env) {
+		long val = atol(env);
+		if (val > 0) {
+			return (size_t) val;
+		}
+	}
+	
+	size_t hw = thread::hardware_concurrency();
+	return hw > 0 ? hw : 1;
+}
+
+static ThreadPool& pool() {
+	static ThreadPool instance;
+	static once_flag init;
+	call_once(init, [] {instance.resize(default_threads());});
+	return instance;
+}
+
+void cpu_set_threads(size_t threads) {
+	if (threads < 1) {
+		throw Exception("Invalid number of threads: " + to_string(threads) + ".");
+	}
+	
+	ThreadPool& p = pool();
+	lock_guard<mutex> guard(p.busy);
+	p.resize(threads);
+}
+
+size_t cpu_threads() {
+	return pool().size();
+}
+
+void cpu_parallel(size_t tasks, void (*fn)(size_t task, void* ctx), void* ctx) {
+	
+	if (tasks == 0) {
+		return;
+	}
+	
+	ThreadPool& p = pool();
+	
+	//Nested calls, a single task, a single thread or a pool already working for
+	//another caller: run inline. The tasks compute the same thing either way.
+	if (inside_pool || tasks == 1 || p.size() == 1 || p.busy.try_lock() == false) {
+		for (size_t t = 0; t < tasks; t++) {
+			fn(t, ctx);
+		}
+		return;
+	}
+	
+	try {
+		p.run(tasks, fn, ctx);
+	} catch (...) {
+		p.busy.unlock();
+		throw;
+	}
+	p.busy.unlock();
+}
+
+} // namespace cpu
+} // namespace cs
@@ -0,0 +1,187 @@
+/*
+ * track.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+namespace cs {
+using namespace core;
+namespace cpu {
+
+static const char* CATEGORY_NAMES[] = { "temporaries", "data", "params", "grads", "activations" };
+
+struct Counters {
+	atomic<size_t> live;
+	atomic<size_t> peak;
+	atomic<size_t> allocations;
+	atomic<size_t> releases;
+};
+
+//the last one is the total, its peak is not the sum of the others
+static Counters counters[CPU_MEMORY_CATEGORIES + 1];
+
+static thread_local CpuMemoryCategory category = CPU_MEMORY_TEMPORARIES;
+//CpuMemoryScope objects alive in the thread
+static thread_local size_t scopes = 0;
+static thread_local size_t forbidden = 0;
+
+static bool env_tracking() {
+	
+	const char* env = getenv("CS_MEMORY_TRACK");
+	if (env && strcmp(env, "1") == 0) {
+		cpu_print_memory_at_exit();
+		return true;
+	}
+	return false;
+}
+
+static atomic<bool>& tracking() {
+	static atomic<bool> instance(env_tracking());
+	return instance;
+}
+
+CpuMemoryScope::CpuMemoryScope(CpuMemoryCategory category) :
+		previous(cpu::category) {
+	
+	if ((size_t) category >= CPU_MEMORY_CATEGORIES) {
+		throw Exception("Invalid memory category " + to_string((size_t) category) + ".");
+	}
+	cpu::category = category;
+	scopes++;
+}
+
+CpuMemoryScope::~CpuMemoryScope() {
+	category = previous;
+	scopes--;
+}
+
+CpuNoAllocations::CpuNoAllocations() {
+	forbidden++;
+}
+
+CpuNoAllocations::~CpuNoAllocations() {
+	forbidden--;
+}
+
+CpuMemoryCategory memory_category() {
+	return category;
+}
+
+bool memory_scoped() {
+	return scopes > 0;
+}
+
+void memory_check(size_t bytes) {
+	if (forbidden > 0) {
+		throw Exception(
+				"cpu_malloc of " + to_string(bytes) + " bytes for " + CATEGORY_NAMES[category]
+						+ " inside a CpuNoAllocations scope.");
+	}
+}
+
+void cpu_set_memory_tracking(bool enabled) {
+	tracking() = enabled;
+}
+
+bool cpu_memory_tracking() {
+	return tracking().load();
+}
+
+static void add(Counters& c, size_t bytes) {
+	
+	size_t live = c.live += bytes;
+	c.allocations++;
+	
+	size_t peak = c.peak.load();
+	while (live > peak && c.peak.compare_exchange_weak(peak, live) == false) {
+	}
+}
+
+size_t cpu_track_memory(CpuMemoryCategory category, size_t bytes) {
+	
+	if ((size_t) category >= CPU_MEMORY_CATEGORIES) {
+		throw Exception("Invalid memory category " + to_string((size_t) category) + ".");
+	}
+	
+	if (cpu_memory_tracking() == false) {
+		return 0;
+	}
+	
+	add(counters[category], bytes);
+	add(counters[CPU_MEMORY_CATEGORIES], bytes);
+	return bytes;
+}
+
+void cpu_untrack_memory(CpuMemoryCategory category, size_t bytes) {
+	
+	if ((size_t) category >= CPU_MEMORY_CATEGORIES || bytes == 0) {
+		return;
+	}
+	
+	counters[category].live -= bytes;
+	counters[category].releases++;
+	counters[CPU_MEMORY_CATEGORIES].live -= bytes;
+	counters[CPU_MEMORY_CATEGORIES].releases++;
+}
+
+static CpuMemoryCounters read(const Counters& c) {
+	CpuMemoryCounters ans = { c.live.load(), c.peak.load(), c.allocations.load(), c.releases.load() };
+	return ans;
+}
+
+CpuMemoryStats cpu_memory_stats() {
+	
+	CpuMemoryStats ans;
+	for (size_t k = 0; k < CPU_MEMORY_CATEGORIES; k++) {
+		ans.categories[k] = read(counters[k]);
+	}
+	ans.total = read(counters[CPU_MEMORY_CATEGORIES]);
+	return ans;
+}
+
+void cpu_reset_memory_peaks() {
+	for (size_t k = 0; k <= CPU_MEMORY_CATEGORIES; k++) {
+		counters[k].peak = counters[k].live.load();
+	}
+}
+
+static void print_counters(const char* name, const CpuMemoryCounters& c) {
+	printf("%-14s %12.3f %12.3f %12zu %12zu\n", name, c.live / (1024.0 * 1024.0), c.peak / (1024.0 * 1024.0),
+			c.allocations, c.releases);
+}
+
+void cpu_print_memory() {
+	
+	CpuMemoryStats stats = cpu_memory_stats();
+	printf("%-14s %12s %12s %12s %12s\n", "memory", "live MB", "peak MB", "allocations", "releases");
+	for (size_t k = 0; k < CPU_MEMORY_CATEGORIES; k++) {
+		print_counters(CATEGORY_NAMES[k], stats.categories[k]);
+	}
+	print_counters("total", stats.total);
+	fflush(stdout);
+}
+
+static void print_at_exit() {
+	cpu_print_memory();
+}
+
+void cpu_print_memory_at_exit() {
+	static once_flag registered;
+	call_once(registered, [] {atexit(print_at_exit);});
+}
+
+} // namespace cpu
+} // namespace cs
@@ -0,0 +1,370 @@
+/*
+ * tune.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef CS_CPU_X86
+#include <cpuid.h>
+#endif
+
+namespace cs {
+using namespace core;
+namespace cpu {
+
+//The side of the products tuned before the first one, with CS_GEMM_TUNE=1.
+static const size_t TUNE_SIZE = 512;
+
+//Candidates of each dimension, in floats. KC x NR floats of B and MR x KC of A are
+//the panels of the micro-kernel (L1), MC x KC is the block of A (L2) and KC x NC the
+//block of B (L3), so the ranges cover caches from 32 KB/256 KB to 2 MB/64 MB.
+static const size_t TUNE_KC[] = { 128, 192, 256, 384, 512, 768 };
+static const size_t TUNE_MC[] = { 48, 72, 96, 144, 192, 288 };
+static const size_t TUNE_NC[] = { 1024, 2048, 4096, 8192 };
+
+static const char* KERNEL_NAMES[] = { "auto", "generic", "avx2", "avx512" };
+
+//Set by the thread that tunes before the first product, its own products must not
+//wait for the configuration they are computing.
+static thread_local bool tuning = false;
+
+//Sets tuning while it is alive, also when the tuning throws.
+struct TuningScope {
+	TuningScope() {
+		tuning = true;
+	}
+	
+	~TuningScope() {
+		tuning = false;
+	}
+};
+
+static bool supported(CpuGemmKernel kernel) {
+	switch (kernel) {
+	case CPU_GEMM_AVX2:
+		return cpu_has_avx2();
+	case CPU_GEMM_AVX512:
+		return cpu_has_avx512();
+	default:
+		return true;
+	}
+}
+
+static void apply(CpuGemmConfig config) {
+	
+	if (config.mc < 1 || config.kc < 1 || config.nc < 1) {
+		throw Exception(
+				"Invalid GEMM blocking mc: " + to_string(config.mc) + ", kc: " + to_string(config.kc) + ", nc: "
+						+ to_string(config.nc) + ".");
+	}
+	
+	if ((size_t) config.kernel > CPU_GEMM_AVX512) {
+		throw Exception("Invalid GEMM kernel " + to_string((size_t) config.kernel) + ".");
+	}
+	
+	if (supported(config.kernel) == false) {
+		throw Exception("This CPU does not have the " + string(KERNEL_NAMES[config.kernel]) + " GEMM kernel.");
+	}
+	
+	GEMM_MC = config.mc;
+	GEMM_KC = config.kc;
+	GEMM_NC = config.nc;
+	GEMM_KERNEL = config.kernel;
+}
+
+//The configuration in use, with the kernel that AUTO picks.
+static CpuGemmConfig current() {
+	
+	CpuGemmKernel kernel = GEMM_KERNEL;
+	if (kernel == CPU_GEMM_AUTO) {
+		kernel = cpu_has_avx512() ? CPU_GEMM_AVX512 : cpu_has_avx2() ? CPU_GEMM_AVX2 : CPU_GEMM_GENERIC;
+	}
+	
+	CpuGemmConfig ans = { GEMM_MC, GEMM_KC, GEMM_NC, kernel };
+	return ans;
+}
+
+//The brand string of the CPU and its widest kernel, like "Intel(R) Xeon(R) Gold 6148 CPU @ 2.40GHz
+//(avx512)". It is the key of the lines of the file.
+static string cpu_model() {
+	
+	string brand;
+#ifdef CS_CPU_X86
+	unsigned int regs[12] = { };
+	unsigned int max = __get_cpuid_max(0x80000000, nullptr);
+	if (max >= 0x80000004) {
+		for (unsigned int i = 0; i < 3; i++) {
+			__get_cpuid(0x80000002 + i, &regs[4 * i], &regs[4 * i + 1], &regs[4 * i + 2], &regs[4 * i + 3]);
+		}
+		brand = string((const char*) regs, strnlen((const char*) regs, sizeof(regs)));
+	}
+#endif
+
+	size_t start = brand.find_first_not_of(' ');
+	size_t end = brand.find_last_not_of(' ');
+	brand = start == string::npos ? "unknown" : brand.substr(start, end - start + 1);
+	
+	const char* widest = cpu_has_avx512() ? "avx512" : cpu_has_avx2() ? "avx2" : "generic";
+	return brand + " (" + widest + ")";
+}
+
+static string default_path() {
+	
+	const char* env = getenv("CS_GEMM_CONFIG");
+	if (env && *env) {
+		return env;
+	}
+	
+	const char* home = getenv("HOME");
+	if (home && *home) {
+		return string(home) + "/.cs_gemm";
+	}
+	return "";
+}
+
+//A line is "mc kc nc kernel model". The lines that can not be read are ignored, the
+//file only makes the products faster.
+static bool parse(const string& line, CpuGemmConfig& config, string& model) {
+	
+	if (line.empty() || line[0] == '#') {
+		return false;
+	}
+	
+	istringstream in(line);
+	string kernel;
+	if (!(in >> config.mc >> config.kc >> config.nc >> kernel)) {
+		return false;
+	}
+	
+	getline(in, model);
+	size_t start = model.find_first_not_of(' ');
+	model = start == string::npos ? "" : model.substr(start);
+	
+	for (size_t k = 0; k <= CPU_GEMM_AVX512; k++) {
+		if (kernel == KERNEL_NAMES[k]) {
+			config.kernel = (CpuGemmKernel) k;
+			return config.mc > 0 && config.kc > 0 && config.nc > 0;
+		}
+	}
+	return false;
+}
+
+static bool load(const string& path) {
+	
+	if (path.empty()) {
+		return false;
+	}
+	
+	ifstream file(path.c_str());
+	if (!file) {
+		return false;
+	}
+	
+	const string model = cpu_model();
+	string line;
+	while (getline(file, line)) {
+		CpuGemmConfig config;
+		string key;
+		if (parse(line, config, key) && key == model && supported(config.kernel)) {
+			apply(config);
+			return true;
+		}
+	}
+	return false;
+}
+
+static void save(const string& path) {
+	
+	if (path.empty()) {
+		throw Exception("There is no file for the GEMM configuration, set CS_GEMM_CONFIG or HOME.");
+	}
+	
+	const string model = cpu_model();
+	
+	//the lines of the other CPUs are kept
+	vector<string> lines;
+	{
+		ifstream file(path.c_str());
+		string line;
+		while (getline(file, line)) {
+			CpuGemmConfig config;
+			string key;
+			if (line.empty() || (parse(line, config, key) && key == model)) {
+				continue;
+			}
+			lines.push_back(line);
+		}
+	}
+	if (lines.empty()) {
+		lines.push_back("# GEMM blocking of cs for each CPU: mc kc nc kernel model");
+	}
+	
+	//not cpu_gemm_config(), this runs inside the first gemm_configure()
+	CpuGemmConfig config = current();
+	lines.push_back(
+			to_string(config.mc) + " " + to_string(config.kc) + " " + to_string(config.nc) + " "
+					+ KERNEL_NAMES[config.kernel] + " " + model);
+	
+	ofstream file(path.c_str(), ios::trunc);
+	for (size_t i = 0; i < lines.size(); i++) {
+		file << lines[i] << "\n";
+	}
+	file.close();
+	if (!file) {
+		throw Exception("Could not write the GEMM configuration to " + path + ".");
+	}
+}
+
+void gemm_configure() {
+	
+	static once_flag startup;
+	if (tuning) {
+		return;
+	}
+	
+	call_once(startup, [] {
+		string path = default_path();
+		if (load(path)) {
+			return;
+		}
+	
+		const char* env = getenv("CS_GEMM_TUNE");
+		if (env && strcmp(env, "1") == 0) {
+			{
+				TuningScope scope;
+				cpu_gemm_tune(TUNE_SIZE);
+			}
+	
+			//the tuned configuration is used anyway, a product must not fail because of the file
+			if (path.empty() == false) {
+				try {
+					save(path);
+				} catch (const exception& e) {
+					fprintf(stderr, "%s\n", e.what());
+				}
+			}
+		}
+	});
+}
+
+CpuGemmConfig cpu_gemm_config() {
+	gemm_configure();
+	return current();
+}
+
+void cpu_set_gemm_config(CpuGemmConfig config) {
+	//after the saved one, which would replace it otherwise
+	gemm_configure();
+	apply(config);
+}
+
+//Best of 3 products of the tuning data, in seconds.
+static double product_seconds(vector<float>& a, vector<float>& b, vector<float>& c, size_t size) {
+	
+	double best = 1e30;
+	for (int r = 0; r < 3; r++) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		cpu_gemm(a.data(), size, false, b.data(), size, false, c.data(), size, size, size, size, 0.0f);
+		best = std::min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+//Tries the values of one dimension with the others fixed, and leaves the fastest in config.
+static double tune_dimension(CpuGemmConfig& config, size_t CpuGemmConfig::*dim, const size_t* values, size_t count,
+		vector<float>& a, vector<float>& b, vector<float>& c, size_t size) {
+	
+	double best = 1e30;
+	size_t bestValue = config.*dim;
+	for (size_t i = 0; i < count; i++) {
+		config.*dim = values[i];
+		apply(config);
+	
+		double seconds = product_seconds(a, b, c, size);
+		if (seconds < best) {
+			best = seconds;
+			bestValue = values[i];
+		}
+	}
+	
+	config.*dim = bestValue;
+	return best;
+}
+
+CpuGemmConfig cpu_gemm_tune(size_t size) {
+	
+	if (size < 64) {
+		throw Exception("The tuning products must be at least 64x64, got " + to_string(size) + ".");
+	}
+	
+	gemm_configure();
+	
+	//the product must take the blocked path, so it is larger than GEMM_SMALL and not a vector
+	vector<float> a(size * size);
+	vector<float> b(size * size);
+	vector<float> c(size * size);
+	for (size_t i = 0; i < a.size(); i++) {
+		a[i] = (float) (i % 17) / 17 - 0.5f;
+		b[i] = (float) (i % 13) / 13 - 0.5f;
+	}
+	
+	vector<CpuGemmKernel> kernels;
+	if (cpu_has_avx512()) {
+		kernels.push_back(CPU_GEMM_AVX512);
+	}
+	if (cpu_has_avx2()) {
+		kernels.push_back(CPU_GEMM_AVX2);
+	}
+	if (kernels.empty()) {
+		kernels.push_back(CPU_GEMM_GENERIC);
+	}
+	
+	const CpuGemmConfig start = current();
+	CpuGemmConfig best = start;
+	double bestSeconds = 1e30;
+	
+	//KC first, it sizes the panels of both A and B, then the blocks of A and of B
+	for (size_t k = 0; k < kernels.size(); k++) {
+		CpuGemmConfig config = { start.mc, start.kc, start.nc, kernels[k] };
+		tune_dimension(config, &CpuGemmConfig::kc, TUNE_KC, sizeof(TUNE_KC) / sizeof(size_t), a, b, c, size);
+		tune_dimension(config, &CpuGemmConfig::mc, TUNE_MC, sizeof(TUNE_MC) / sizeof(size_t), a, b, c, size);
+		double seconds = tune_dimension(config, &CpuGemmConfig::nc, TUNE_NC, sizeof(TUNE_NC) / sizeof(size_t), a, b,
+				c, size);
+	
+		if (seconds < bestSeconds) {
+			bestSeconds = seconds;
+			best = config;
+		}
+	}
+	
+	apply(best);
+	return best;
+}
+
+void cpu_gemm_save(const char* path) {
+	gemm_configure();
+	save(path ? string(path) : default_path());
+}
+
+bool cpu_gemm_load(const char* path) {
+	gemm_configure();
+	return load(path ? string(path) : default_path());
+}
+
+} // namespace cpu
+} // namespace cs
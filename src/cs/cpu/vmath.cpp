@@ -0,0 +1,450 @@
+/*
+ * vmath.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+
+#ifdef CS_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace cs {
+namespace cpu {
+
+//Vectorized exp, the Cephes expf algorithm: x = n * ln2 + r with |r| <= ln2 / 2,
+//exp(r) by a degree 7 polynomial and 2^n built in the exponent bits (as two factors
+//with AVX2, so the subnormal results below 2^-126 keep their value). The input is
+//clamped to [EXP_MIN, EXP_MAX], so exp never returns inf: above EXP_MAX it stays at
+//exp(EXP_MAX) ~ 2.4 * 10^38, and below -103.97 it is 0 like the true value rounded to
+//float. For the results of at least 2^-126 (x >= -87.34) the relative error is below
+//2 ulp (3 * 10^-7), measured against the double exp, the subnormal ones below that
+//are within one unit of the smallest subnormal (1.4 * 10^-45). NaN gives NaN, and so
+//do the sigmoid and the tanh.
+//
+//The sigmoid is 1 / (1 + exp(-x)) with a true division, so its relative error
+//is below 4 ulp, and its backward uses the activation of the forward, fx * (1 - fx),
+//without evaluating exp again.
+//
+//The tanh is 1 - 2 / (exp(2x) + 1) on the same exp, its absolute error is below
+//2 * 10^-7 (so the relative one grows near 0, where tanh(x) ~ x).
+static const float EXP_MAX = 88.3762626647949f;
+static const float EXP_MIN = -104.0f;
+static const float EXP_LOG2E = 1.44269504088896341f;
+static const float EXP_LN2_HI = 0.693359375f;
+static const float EXP_LN2_LO = -2.12194440e-4f;
+
+static const float EXP_P0 = 1.9875691500E-4f;
+static const float EXP_P1 = 1.3981999507E-3f;
+static const float EXP_P2 = 8.3334519073E-3f;
+static const float EXP_P3 = 4.1665795894E-2f;
+static const float EXP_P4 = 1.6666665459E-1f;
+static const float EXP_P5 = 5.0000001201E-1f;
+
+//Elements of one task.
+static const size_t VMATH_CHUNK = 1 << 14;
+
+struct VmathKernels {
+	void (*exp)(const float* a, float* dest, size_t l);
+	void (*sigmoid_fx)(const float* x, float* fx, size_t l);
+	void (*sigmoid_dx)(const float* fx, const float* dg, float* dx, size_t l);
+	void (*epilogue)(CpuActivation act, float* c, size_t ldc, const float* bias, float* pre, size_t ldpre, size_t m,
+			size_t n);
+};
+
+//Generic
+//=============================================================================
+static float exp_scalar(float x) {
+	//std::max and std::min return a NaN x
+	return expf(std::min(std::max(x, EXP_MIN), EXP_MAX));
+}
+
+static void exp_generic(const float* a, float* dest, size_t l) {
+	for (size_t i = 0; i < l; i++) {
+		dest[i] = exp_scalar(a[i]);
+	}
+}
+
+static void sigmoid_fx_generic(const float* x, float* fx, size_t l) {
+	for (size_t i = 0; i < l; i++) {
+		fx[i] = 1.0f / (1.0f + exp_scalar(-x[i]));
+	}
+}
+
+static void sigmoid_dx_generic(const float* fx, const float* dg, float* dx, size_t l) {
+	for (size_t i = 0; i < l; i++) {
+		dx[i] = fx[i] * (1.0f - fx[i]) * dg[i];
+	}
+}
+
+static inline float activation_scalar(CpuActivation act, float x) {
+	switch (act) {
+	case CPU_SIGMOID:
+		return 1.0f / (1.0f + exp_scalar(-x));
+	case CPU_RELU:
+		return x > 0.0f ? x : 0.0f;
+	case CPU_TANH:
+		return 1.0f - 2.0f / (exp_scalar(2.0f * x) + 1.0f);
+	default:
+		return x;
+	}
+}
+
+//C = act(C + bias) and PRE = C + bias, where C is (m x n), bias has n values and pre can be
+//nullptr. A whole GEMM tile is a single call.
+static void epilogue_row_generic(CpuActivation act, float* c, const float* bias, float* pre, size_t n) {
+	for (size_t j = 0; j < n; j++) {
+		float v = bias ? c[j] + bias[j] : c[j];
+		if (pre) {
+			pre[j] = v;
+		}
+		c[j] = activation_scalar(act, v);
+	}
+}
+
+static void epilogue_generic(CpuActivation act, float* c, size_t ldc, const float* bias, float* pre, size_t ldpre,
+		size_t m, size_t n) {
+	for (size_t i = 0; i < m; i++) {
+		epilogue_row_generic(act, c + i * ldc, bias, pre ? pre + i * ldpre : nullptr, n);
+	}
+}
+
+#ifdef CS_CPU_X86
+
+//AVX2
+//=============================================================================
+CS_TARGET("avx2,fma")
+static inline __m256 exp_avx2(__m256 in) {
+	
+	__m256 x = _mm256_min_ps(_mm256_max_ps(in, _mm256_set1_ps(EXP_MIN)), _mm256_set1_ps(EXP_MAX));
+	
+	//n = round(x / ln2), r = x - n * ln2 in two steps to keep the low bits
+	__m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(EXP_LOG2E)),
+			_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_HI), x);
+	r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_LO), r);
+	
+	__m256 p = _mm256_set1_ps(EXP_P0);
+	p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P1));
+	p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P2));
+	p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P3));
+	p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P4));
+	p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P5));
+	p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+	
+	//2^n = 2^a * 2^b with a = n / 2, n is in [-150, 128] and a, b in [-75, 64]
+	__m256i ni = _mm256_cvtps_epi32(n);
+	__m256i a = _mm256_srai_epi32(ni, 1);
+	__m256i b = _mm256_sub_epi32(ni, a);
+	__m256 ea = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(a, _mm256_set1_epi32(127)), 23));
+	__m256 eb = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(b, _mm256_set1_epi32(127)), 23));
+	__m256 ans = _mm256_mul_ps(_mm256_mul_ps(p, ea), eb);
+	
+	//the clamp turned NaN into a bound
+	return _mm256_blendv_ps(ans, in, _mm256_cmp_ps(in, in, _CMP_UNORD_Q));
+}
+
+CS_TARGET("avx2,fma")
+static void exp_avx2(const float* a, float* dest, size_t l) {
+	size_t i = 0;
+	for (; i + 8 <= l; i += 8) {
+		_mm256_storeu_ps(dest + i, exp_avx2(_mm256_loadu_ps(a + i)));
+	}
+	//the generic tail is not VEX encoded, clear the upper halves before it
+	_mm256_zeroupper();
+	exp_generic(a + i, dest + i, l - i);
+}
+
+CS_TARGET("avx2,fma")
+static void sigmoid_fx_avx2(const float* x, float* fx, size_t l) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 zero = _mm256_setzero_ps();
+	
+	size_t i = 0;
+	for (; i + 8 <= l; i += 8) {
+		__m256 e = exp_avx2(_mm256_sub_ps(zero, _mm256_loadu_ps(x + i)));
+		_mm256_storeu_ps(fx + i, _mm256_div_ps(one, _mm256_add_ps(one, e)));
+	}
+	_mm256_zeroupper();
+	sigmoid_fx_generic(x + i, fx + i, l - i);
+}
+
+CS_TARGET("avx2,fma")
+static void sigmoid_dx_avx2(const float* fx, const float* dg, float* dx, size_t l) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	
+	size_t i = 0;
+	for (; i + 8 <= l; i += 8) {
+		__m256 f = _mm256_loadu_ps(fx + i);
+		__m256 d = _mm256_mul_ps(_mm256_mul_ps(f, _mm256_sub_ps(one, f)), _mm256_loadu_ps(dg + i));
+		_mm256_storeu_ps(dx + i, d);
+	}
+	_mm256_zeroupper();
+	sigmoid_dx_generic(fx + i, dg + i, dx + i, l - i);
+}
+
+CS_TARGET("avx2,fma")
+static inline __m256 activation_avx2(CpuActivation act, __m256 x) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+	
+	switch (act) {
+	case CPU_SIGMOID:
+		return _mm256_div_ps(one, _mm256_add_ps(one, exp_avx2(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+	case CPU_RELU:
+		return _mm256_max_ps(x, _mm256_setzero_ps());
+	case CPU_TANH:
+		return _mm256_sub_ps(one, _mm256_div_ps(two, _mm256_add_ps(exp_avx2(_mm256_mul_ps(two, x)), one)));
+	default:
+		return x;
+	}
+}
+
+CS_TARGET("avx2,fma")
+static void epilogue_avx2(CpuActivation act, float* c, size_t ldc, const float* bias, float* pre, size_t ldpre,
+		size_t m, size_t n) {
+	
+	for (size_t i = 0; i < m; i++) {
+		float* ci = c + i * ldc;
+		float* prei = pre ? pre + i * ldpre : nullptr;
+		
+		size_t j = 0;
+		for (; j + 8 <= n; j += 8) {
+			__m256 v = _mm256_loadu_ps(ci + j);
+			if (bias) {
+				v = _mm256_add_ps(v, _mm256_loadu_ps(bias + j));
+			}
+			if (prei) {
+				_mm256_storeu_ps(prei + j, v);
+			}
+			_mm256_storeu_ps(ci + j, activation_avx2(act, v));
+		}
+		_mm256_zeroupper();
+		epilogue_row_generic(act, ci + j, bias ? bias + j : nullptr, prei ? prei + j : nullptr, n - j);
+	}
+}
+
+//AVX-512
+//=============================================================================
+CS_TARGET("avx512f")
+static inline __m512 exp_avx512(__m512 in) {
+	
+	__m512 x = _mm512_min_ps(_mm512_max_ps(in, _mm512_set1_ps(EXP_MIN)), _mm512_set1_ps(EXP_MAX));
+	
+	__m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(EXP_LOG2E)),
+			_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_HI), x);
+	r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_LO), r);
+	
+	__m512 p = _mm512_set1_ps(EXP_P0);
+	p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P1));
+	p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P2));
+	p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P3));
+	p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P4));
+	p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P5));
+	p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+	
+	//p * 2^n, with the subnormal results
+	__m512 ans = _mm512_scalef_ps(p, n);
+	
+	//the clamp turned NaN into a bound
+	return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(in, in, _CMP_UNORD_Q), ans, in);
+}
+
+CS_TARGET("avx512f")
+static void exp_avx512(const float* a, float* dest, size_t l) {
+	size_t i = 0;
+	for (; i + 16 <= l; i += 16) {
+		_mm512_storeu_ps(dest + i, exp_avx512(_mm512_loadu_ps(a + i)));
+	}
+	_mm256_zeroupper();
+	exp_generic(a + i, dest + i, l - i);
+}
+
+CS_TARGET("avx512f")
+static void sigmoid_fx_avx512(const float* x, float* fx, size_t l) {
+	const __m512 one = _mm512_set1_ps(1.0f);
+	const __m512 zero = _mm512_setzero_ps();
+	
+	size_t i = 0;
+	for (; i + 16 <= l; i += 16) {
+		__m512 e = exp_avx512(_mm512_sub_ps(zero, _mm512_loadu_ps(x + i)));
+		_mm512_storeu_ps(fx + i, _mm512_div_ps(one, _mm512_add_ps(one, e)));
+	}
+	_mm256_zeroupper();
+	sigmoid_fx_generic(x + i, fx + i, l - i);
+}
+
+CS_TARGET("avx512f")
+static inline __m512 activation_avx512(CpuActivation act, __m512 x) {
+	const __m512 one = _mm512_set1_ps(1.0f);
+	const __m512 two = _mm512_set1_ps(2.0f);
+	
+	switch (act) {
+	case CPU_SIGMOID:
+		return _mm512_div_ps(one, _mm512_add_ps(one, exp_avx512(_mm512_sub_ps(_mm512_setzero_ps(), x))));
+	case CPU_RELU:
+		return _mm512_max_ps(x, _mm512_setzero_ps());
+	case CPU_TANH:
+		return _mm512_sub_ps(one, _mm512_div_ps(two, _mm512_add_ps(exp_avx512(_mm512_mul_ps(two, x)), one)));
+	default:
+		return x;
+	}
+}
+
+//the tails are masked vectors, so the rows of the edge tiles are not split in scalar code
+CS_TARGET("avx512f")
+static void epilogue_avx512(CpuActivation act, float* c, size_t ldc, const float* bias, float* pre, size_t ldpre,
+		size_t m, size_t n) {
+	
+	for (size_t i = 0; i < m; i++) {
+		float* ci = c + i * ldc;
+		float* prei = pre ? pre + i * ldpre : nullptr;
+		
+		for (size_t j = 0; j < n; j += 16) {
+			const __mmask16 mask = n - j >= 16 ? (__mmask16) 0xFFFF : (__mmask16) ((1u << (n - j)) - 1);
+			
+			__m512 v = _mm512_maskz_loadu_ps(mask, ci + j);
+			if (bias) {
+				v = _mm512_add_ps(v, _mm512_maskz_loadu_ps(mask, bias + j));
+			}
+			if (prei) {
+				_mm512_mask_storeu_ps(prei + j, mask, v);
+			}
+			_mm512_mask_storeu_ps(ci + j, mask, activation_avx512(act, v));
+		}
+	}
+	_mm256_zeroupper();
+}
+
+#endif
+
+static const VmathKernels& vmath_kernels() {
+	
+	static const VmathKernels generic = { exp_generic, sigmoid_fx_generic, sigmoid_dx_generic, epilogue_generic };
+#ifdef CS_CPU_X86
+	static const VmathKernels avx2 = { exp_avx2, sigmoid_fx_avx2, sigmoid_dx_avx2, epilogue_avx2 };
+	//the backward is bound by memory, AVX2 is enough for it
+	static const VmathKernels avx512 = { exp_avx512, sigmoid_fx_avx512, sigmoid_dx_avx2, epilogue_avx512 };
+	
+	if (cpu_has_avx512()) {
+		return avx512;
+	}
+	
+	if (cpu_has_avx2()) {
+		return avx2;
+	}
+#endif
+	return generic;
+}
+
+enum VmathFn {
+	VMATH_EXP, VMATH_SIGMOID_FX, VMATH_SIGMOID_DX, VMATH_ACTIVATION
+};
+
+//An element wise function of up to two (m x n) inputs a and b into dest.
+struct VmathJob {
+	VmathFn fn;
+	const float* a;
+	size_t lda;
+	const float* b;
+	size_t ldb;
+	float* dest;
+	size_t ldd;
+	size_t m;
+	size_t n;
+	//rows of a task, 0 when there is no padding and the matrices are a single range
+	size_t rows;
+	//of VMATH_ACTIVATION
+	CpuActivation act;
+};
+
+static void vmath_range(const VmathJob& job, size_t offsetA, size_t offsetB, size_t offsetD, size_t l) {
+	
+	const VmathKernels& k = vmath_kernels();
+	
+	if (job.fn == VMATH_EXP) {
+		k.exp(job.a + offsetA, job.dest + offsetD, l);
+	} else if (job.fn == VMATH_SIGMOID_FX) {
+		k.sigmoid_fx(job.a + offsetA, job.dest + offsetD, l);
+	} else if (job.fn == VMATH_ACTIVATION) {
+		k.epilogue(job.act, job.dest + offsetD, l, nullptr, nullptr, 0, 1, l);
+	} else {
+		k.sigmoid_dx(job.a + offsetA, job.b + offsetB, job.dest + offsetD, l);
+	}
+}
+
+static void vmath_chunk(size_t task, void* ctx) {
+	
+	const VmathJob& job = *(const VmathJob*) ctx;
+	
+	if (job.rows == 0) {
+		size_t start = task * VMATH_CHUNK;
+		size_t l = std::min(VMATH_CHUNK, job.m * job.n - start);
+		vmath_range(job, start, start, start, l);
+		return;
+	}
+	
+	size_t start = task * job.rows;
+	size_t end = std::min(job.m, start + job.rows);
+	
+	for (size_t i = start; i < end; i++) {
+		vmath_range(job, i * job.lda, i * job.ldb, i * job.ldd, job.n);
+	}
+}
+
+static void vmath(VmathFn fn, const float* a, size_t lda, const float* b, size_t ldb, float* dest, size_t ldd,
+		size_t m, size_t n, CpuActivation act) {
+	
+	VmathJob job = { fn, a, lda, b, ldb, dest, ldd, m, n, 0, act };
+	
+	size_t tasks;
+	if (lda == n && ldd == n && (b == nullptr || ldb == n)) {
+		tasks = (m * n + VMATH_CHUNK - 1) / VMATH_CHUNK;
+	} else {
+		job.rows = std::max((size_t) 1, VMATH_CHUNK / n);
+		tasks = (m + job.rows - 1) / job.rows;
+	}
+	
+	cpu_parallel(tasks, vmath_chunk, &job);
+}
+
+void cpu_exp(float* a, float* dest, size_t l) {
+	vmath(VMATH_EXP, a, l, nullptr, 0, dest, l, 1, l, CPU_IDENTITY);
+}
+
+void cpu_sigmoid_fx(float* x, size_t ldx, float* fx, size_t ldfx, size_t m, size_t n) {
+	vmath(VMATH_SIGMOID_FX, x, ldx, nullptr, 0, fx, ldfx, m, n, CPU_IDENTITY);
+}
+
+void cpu_sigmoid_dx(float* fx, size_t ldfx, float* dg, size_t lddg, float* dx, size_t lddx, size_t m, size_t n) {
+	vmath(VMATH_SIGMOID_DX, fx, ldfx, dg, lddg, dx, lddx, m, n, CPU_IDENTITY);
+}
+
+void cpu_activation(CpuActivation act, float* x, size_t ldx, float* fx, size_t ldfx, size_t m, size_t n) {
+	
+	//the epilogue works in place
+	if (fx != x) {
+		for (size_t i = 0; i < m; i++) {
+			std::copy(x + i * ldx, x + i * ldx + n, fx + i * ldfx);
+		}
+	}
+	
+	if (act != CPU_IDENTITY) {
+		vmath(VMATH_ACTIVATION, fx, ldfx, nullptr, 0, fx, ldfx, m, n, act);
+	}
+}
+
+void gemm_epilogue(CpuActivation act, float* c, size_t ldc, const float* bias, float* pre, size_t ldpre, size_t m,
+		size_t n) {
+	vmath_kernels().epilogue(act, c, ldc, bias, pre, ldpre, m, n);
+}
+
+} // namespace cpu
+} // namespace cs
@@ -26,6 +26,11 @@ Grid::Grid(string& raw) :
 	
 }
 
+Grid::Grid(const Grid& other) :
+		_cols(other._cols), _info(other._info), data(other.data) {
+	track();
+}
+
 Grid::Grid(string& raw, char delimiter) :
 		_cols(calculateColumns(raw, delimiter)), _info(_cols) {
 	
@@ -70,6 +75,19 @@ Grid::Grid(string& raw, char delimiter) :
 	}
 	
 	_info.fill(data);
+	track();
+}
+
+void Grid::track() {
+	
+	cpu::cpu_untrack_memory(cpu::CPU_MEMORY_DATA, tracked);
+	
+	//the strings and the statistics of the columns, without the allocator overhead
+	size_t bytes = data.capacity() * sizeof(string) + _cols * sizeof(GridColInfo);
+	for (size_t i = 0; i < data.size(); i++) {
+		bytes += data[i].capacity();
+	}
+	tracked = cpu::cpu_track_memory(cpu::CPU_MEMORY_DATA, bytes);
 }
 
 void Grid::shuffle() {
@@ -99,6 +117,7 @@ void Grid::replace(size_t col, string oldVal, string newVal) {
 	
 	if (modified) {
 		_info.fill(data, col);
+		track();
 	}
 }
 
@@ -176,19 +195,140 @@ size_t Grid::rows() const {
 }
 
 
-const CpuMatrix Grid::toMatrix(size_t col) const {
+CpuMatrix Grid::toMatrix(size_t col) const {
 	return toMatrix(col, false);
 }
 
-const CpuMatrix Grid::toMatrix(size_t col, bool stdScale) const {
+CpuMatrix Grid::toMatrix(size_t col, bool stdScale) const {
 	return toMatrix(col, col + 1, stdScale);
 }
 
-const CpuMatrix Grid::toMatrix(size_t start, size_t end) const {
+CpuMatrix Grid::toMatrix(size_t start, size_t end) const {
 	return toMatrix(start, end, false);
 }
 
-const CpuMatrix Grid::toMatrix(size_t start, size_t end, bool stdScale) const {
+CpuMatrix Grid::toMatrix(size_t start, size_t end, bool stdScale) const {
+	return toMatrix(start, end, stdScale, cpu::cpu_memory_policy());
+}
+
+CpuMatrix Grid::toMatrix(size_t start, size_t end, bool stdScale, const cpu::CpuMemoryPolicy& policy) const {
+	size_t total = toWidth(start, end);
+	cpu::CpuMemoryScope scope(cpu::CPU_MEMORY_DATA);
+	
+	//filled in place (cleared for the one hot columns) and moved to the caller
+	CpuMatrix mtr = CpuMatrix(rows(), total, total, true, policy);
+	float* vals = mtr.ptr();
+	
+	for (size_t i = 0; i < rows(); i++) {
+		float* ptr = vals + i * mtr.ld;
+		toVector(ptr, i, start, end);
+	}
+	
+	if (stdScale) {
+		CpuVector mean = CpuVector(total, false);
+		CpuVector stdev = CpuVector(total, false);
+		toScales(start, end, mean, stdev);
+		
+		mtr.subi_rows(mean);
+		mtr.divi_rows(stdev);
+	}
+	
+	return mtr;
+}
+
+CpuSparseMatrix Grid::toSparseMatrix(size_t start, size_t end, bool stdScale) const {
+	size_t total = toWidth(start, end);
+	size_t m = rows();
+	
+	CpuVector mean = CpuVector(total, true);
+	CpuVector stdev = CpuVector(total, false);
+	if (stdScale) {
+		toScales(start, end, mean, stdev);
+	} else {
+		for (size_t j = 0; j < total; j++) {
+			stdev[j] = 1.0f;
+		}
+	}
+	
+	vector<size_t> offsets(m + 1);
+	vector<size_t> cols;
+	vector<float> values;
+	cols.reserve(m * (end - start));
+	values.reserve(m * (end - start));
+	
+	for (size_t r = 0; r < m; r++) {
+		offsets[r] = values.size();
+		
+		size_t colIdx = 0;
+		for (size_t i = start; i < end; i++) {
+			string val = data.at(r * _cols + i);
+			
+			size_t j = colIdx;
+			float f;
+			if (_info.is_numeric(i)) {
+				f = string_to_float(val);
+				colIdx++;
+			} else {
+				long int idx = _info.diff_idx(i, val);
+				
+				if (idx < 0) {
+					throw Exception("Word '" + val + "' not found for column idx " + to_string(i) + ".");
+				}
+				
+				j += idx;
+				f = 1.0f;
+				colIdx += _info.diff_count(i);
+			}
+			
+			//in two steps like subi_rows and divi_rows, so the values match toMatrix
+			f = f - mean[j];
+			f = f / stdev[j];
+			
+			if (f != 0.0f) {
+				cols.push_back(j);
+				values.push_back(f);
+			}
+		}
+	}
+	offsets[m] = values.size();
+	
+	return CpuSparseMatrix(m, total, std::move(offsets), std::move(cols), std::move(values));
+}
+
+CpuHalfMatrix Grid::toHalfMatrix(size_t start, size_t end, bool stdScale, cpu::CpuHalf type) const {
+	size_t total = toWidth(start, end);
+	size_t m = rows();
+	
+	CpuVector mean = CpuVector(total, false);
+	CpuVector stdev = CpuVector(total, false);
+	toScales(start, end, mean, stdev);
+	
+	cpu::CpuMemoryScope scope(cpu::CPU_MEMORY_DATA);
+	CpuHalfMatrix mtr = CpuHalfMatrix(m, total, type, false);
+	
+	//a row at a time in fp32, standardized like toMatrix and then rounded
+	CpuVector row = CpuVector(total, false);
+	float* vals = row.ptr();
+	
+	for (size_t i = 0; i < m; i++) {
+		row.clear();
+		toVector(vals, i, start, end);
+		
+		if (stdScale) {
+			for (size_t j = 0; j < total; j++) {
+				vals[j] = vals[j] - mean[j];
+				vals[j] = vals[j] / stdev[j];
+			}
+		}
+		
+		cpu::cpu_to_half(type, vals, total, mtr.ptr() + i * mtr.ld, mtr.ld, 1, total);
+	}
+	
+	return mtr;
+}
+
+//Columns of the matrix of [start, end), a word column has one per different word.
+size_t Grid::toWidth(size_t start, size_t end) const {
 	size_t total = 0;
 	
 	for (size_t i = start; i < end; i++) {
@@ -202,35 +342,39 @@ const CpuMatrix Grid::toMatrix(size_t start, size_t end, bool stdScale) const {
 		
 	}
 	
-	vector<float> v(total * rows());
-	float* vals = v.data();
+	return total;
+}
+
+//(x - mean) / stdev of every numeric column, the others are shifted by 0 and divided by 1
+void Grid::toScales(size_t start, size_t end, CpuVector& mean, CpuVector& stdev) const {
 	
-	for (size_t i = 0; i < rows(); i++) {
-		float* ptr = vals + i * total;
-		toVector(ptr, i, start, end, stdScale);
+	for (size_t j = 0; j < mean.length; j++) {
+		mean[j] = 0.0f;
+		stdev[j] = 1.0f;
 	}
 	
-	CpuMatrix mtr = CpuMatrix(rows(), total, vals);
-	
-	return mtr;
+	size_t colIdx = 0;
+	for (size_t i = start; i < end; i++) {
+		if (_info.is_numeric(i)) {
+			if (_info.is_boolean(i) == false) {
+				mean[colIdx] = (float) _info.avg(i);
+				stdev[colIdx] = (float) _info.stdev(i);
+			}
+			colIdx++;
+		} else {
+			colIdx += _info.diff_count(i);
+		}
+	}
 }
 
-void Grid::toVector(float* vals, size_t row, size_t start, size_t end, bool stdScale) const {
+void Grid::toVector(float* vals, size_t row, size_t start, size_t end) const {
 	
 	size_t colIdx = 0;
 	for (size_t i = start; i < end; i++) {
 		string val = data.at(row * _cols + i);
 		
 		if (_info.is_numeric(i)) {
-			float f = string_to_float(val);
-			if (stdScale && _info.is_boolean(i) == false) {
-				double stdev = _info.stdev(i);
-				double mean = _info.avg(i);
-				float ans = (float) ((f - mean) / stdev);
-				vals[colIdx] = ans;
-			} else {
-				vals[colIdx] = f;
-			}
+			vals[colIdx] = string_to_float(val);
 			colIdx++;
 		} else if (_info.is_word(i)) {
 			long int idx = _info.diff_idx(i, val);
@@ -270,6 +414,7 @@ void Grid::print() const {
 }
 
 Grid::~Grid() {
+	cpu::cpu_untrack_memory(cpu::CPU_MEMORY_DATA, tracked);
 	data.clear();
 }
 
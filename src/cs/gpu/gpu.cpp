@@ -79,6 +79,11 @@ void copy_cpu_to_gpu(float* src, float* dest, size_t length) {
 	check_cuda(cudaMemcpy(dest, src, sizeof(float) * length, cudaMemcpyHostToDevice));
 }
 
+void copy_cpu_to_gpu(float* src, size_t lds, float* dest, size_t m, size_t n) {
+	size_t width = sizeof(float) * n;
+	check_cuda(cudaMemcpy2D(dest, width, src, sizeof(float) * lds, width, m, cudaMemcpyHostToDevice));
+}
+
 void copy_gpu_to_cpu(float* src, float* dst, size_t length) {
 	check_cuda(cudaMemcpy(dst, src, sizeof(float) * length, cudaMemcpyDeviceToHost));
 }
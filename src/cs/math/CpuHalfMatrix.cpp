@@ -0,0 +1,183 @@
+/*
+ * CpuHalfMatrix.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/core/lang.h>
+#include <cs/cpu/cpu.h>
+#include <cs/math/CpuHalfMatrix.h>
+#include <cs/math/math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace cs {
+using namespace core;
+using namespace cpu;
+namespace math {
+
+//The values live in cpu_malloc memory, two per float.
+static uint16_t* half_malloc(size_t length, bool clear) {
+	return (uint16_t*) cpu_malloc((length + 1) / 2, clear);
+}
+
+CpuHalfMatrix::CpuHalfMatrix(size_t m, size_t n, CpuHalf type, bool clear) :
+		Matrix(m, n), type(type), ld(n) {
+	arr = half_malloc(length, clear);
+}
+
+CpuHalfMatrix::CpuHalfMatrix(const CpuMatrix& src, CpuHalf type) :
+		CpuHalfMatrix(src.m, src.n, type, false) {
+	cpu_to_half(type, src.ptr(), src.ld, arr, ld, m, n);
+}
+
+CpuHalfMatrix::CpuHalfMatrix(const CpuHalfMatrix& other) :
+		CpuHalfMatrix(other.m, other.n, other.type, false) {
+	std::copy(other.arr, other.arr + length, arr);
+}
+
+CpuHalfMatrix::CpuHalfMatrix(CpuHalfMatrix&& other) :
+		Matrix(other.m, other.n), arr(other.arr), type(other.type), ld(other.ld) {
+	other.arr = nullptr;
+}
+
+float CpuHalfMatrix::get(size_t i, size_t j) const {
+	check_index(i, j);
+	return cpu_from_half(type, arr[i * ld + j]);
+}
+
+void CpuHalfMatrix::set(size_t i, size_t j, float val) {
+	check_index(i, j);
+	arr[i * ld + j] = cpu_to_half(type, val);
+}
+
+uint16_t* CpuHalfMatrix::ptr() const {
+	return arr;
+}
+
+size_t CpuHalfMatrix::bytes() const {
+	return m * ld * sizeof(uint16_t);
+}
+
+void CpuHalfMatrix::clear() {
+	//+0.0 is all zeros in both formats
+	std::fill(arr, arr + m * ld, (uint16_t) 0);
+}
+
+void CpuHalfMatrix::randn() {
+	CpuMatrix values = CpuMatrix(m, n, false);
+	values.randn();
+	cpu_to_half(type, values.ptr(), values.ld, arr, ld, m, n);
+}
+
+float CpuHalfMatrix::sum() const {
+	return cpu_half_sum(type, arr, ld, m, n);
+}
+
+void CpuHalfMatrix::affine(const Matrix& w, const Vector& b, Matrix& ans) const {
+	affine(cpu_cast(w), cpu_cast(b), cpu_cast(ans));
+}
+
+void CpuHalfMatrix::affine(const CpuMatrix& w, const CpuVector& b, CpuMatrix& ans) const {
+	
+	size_t p = w.n;
+	assert_rows(b.length, p);
+	dot(w, ans);
+	ans.addi_rows(b);
+}
+
+void CpuHalfMatrix::dot(const CpuMatrix& b, CpuMatrix& ans) const {
+	
+	assert_cols(b.m, n);
+	
+	assert_rows(ans.m, m);
+	assert_cols(ans.n, b.n);
+	
+	cpu_gemm_half(type, arr, ld, false, b.ptr(), b.ld, false, ans.ptr(), ans.ld, m, n, b.n, 0.0f);
+}
+
+void CpuHalfMatrix::dot(bool trans, const CpuMatrix& b, CpuMatrix& ans) const {
+	
+	if (trans == false) {
+		dot(b, ans);
+		return;
+	}
+	
+	assert_rows(b.m, m);
+	
+	assert_rows(ans.m, n);
+	assert_cols(ans.n, b.n);
+	
+	//this is (m x n), so this^T is (n x m)
+	cpu_gemm_half(type, arr, ld, true, b.ptr(), b.ld, false, ans.ptr(), ans.ld, n, m, b.n, 0.0f);
+}
+
+void CpuHalfMatrix::copy(Matrix& dest) const {
+	
+	check_same_dimensions(dest);
+	
+	CpuHalfMatrix* half = dynamic_cast<CpuHalfMatrix*>(&dest);
+	if (half == nullptr) {
+		CpuMatrix& ans = cpu_cast(dest);
+		cpu_from_half(type, arr, ld, ans.ptr(), ans.ld, m, n);
+		return;
+	}
+	
+	if (half->type == type) {
+		for (size_t i = 0; i < m; i++) {
+			std::copy(arr + i * ld, arr + i * ld + n, half->arr + i * half->ld);
+		}
+		return;
+	}
+	
+	//through fp32, a row at a time
+	CpuMatrix row = CpuMatrix(1, n, false);
+	for (size_t i = 0; i < m; i++) {
+		cpu_from_half(type, arr + i * ld, ld, row.ptr(), n, 1, n);
+		cpu_to_half(half->type, row.ptr(), n, half->arr + i * half->ld, half->ld, 1, n);
+	}
+}
+
+CpuMatrix CpuHalfMatrix::to_float() const {
+	
+	CpuMatrix ans = CpuMatrix(m, n, false);
+	copy(ans);
+	
+	return ans;
+}
+
+void CpuHalfMatrix::print() const {
+	
+	size_t rows = std::min((size_t) MATRIX_PRINT_MAX, m);
+	size_t cols = std::min((size_t) MATRIX_PRINT_MAX, n);
+	const char* name = type == CPU_BF16 ? "bf16" : "fp16";
+	
+	if (m > MATRIX_PRINT_MAX || n > MATRIX_PRINT_MAX) {
+		printf("CpuHalfMatrix  %dx%d  %s   (truncated)\n", (int) m, (int) n, name);
+	} else {
+		printf("CpuHalfMatrix  %dx%d  %s\n", (int) m, (int) n, name);
+	}
+	for (size_t i = 0; i < rows; i++) {
+		for (size_t j = 0; j < cols; j++) {
+			printf("%12.4f", cpu_from_half(type, arr[i * ld + j]));
+			if (j + 1 < n) {
+				printf("  ");
+			}
+		}
+		println();
+	}
+	
+	println();
+}
+
+CpuHalfMatrix::~CpuHalfMatrix() {
+	if (arr) {
+		cpu_free((float*) arr);
+	}
+}
+
+} // namespace math
+} // namespace cs
@@ -7,6 +7,7 @@
 
 #include <cs/core/Exception.h>
 #include <cs/core/lang.h>
+#include <cs/cpu/cpu.h>
 #include <cs/math/CpuMatrix.h>
 #include <cs/math/math.h>
 #include <stdlib.h>
@@ -16,40 +17,103 @@
 
 namespace cs {
 using namespace core;
+using namespace cpu;
 namespace math {
 
-CpuMatrix::CpuMatrix(size_t m, size_t n) :
-		CpuMatrix(m, n, true) {
+//Copies the (m x n) src with leading dimension lds to dest with leading dimension ldd.
+template<typename T>
+static void copy_rows(const T* src, size_t lds, T* dest, size_t ldd, size_t m, size_t n) {
+	
+	if (lds == n && ldd == n) {
+		std::copy(src, src + m * n, dest);
+		return;
+	}
+	
+	for (size_t i = 0; i < m; i++) {
+		const T* row = src + i * lds;
+		std::copy(row, row + n, dest + i * ldd);
+	}
+}
+
+//start < end <= size, what is the name of the dimension for the error.
+static void check_range(size_t start, size_t end, size_t size, const string& what) {
+	if (start >= end || end > size) {
+		throw Exception(
+				"Invalid range of " + what + " [" + to_string(start) + ", " + to_string(end) + "), expected start < end <= "
+						+ to_string(size) + ".");
+	}
+}
+
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(size_t m, size_t n) :
+		BasicCpuMatrix(m, n, true) {
+}
+
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(size_t m, size_t n, bool clear) :
+		BasicCpuMatrix(m, n, n, clear) {
+}
+
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(size_t m, size_t n, size_t ld, bool clear) :
+		BasicCpuMatrix(m, n, ld, clear, cpu_memory_policy()) {
 }
 
-CpuMatrix::CpuMatrix(size_t m, size_t n, bool clear) :
-		Matrix(m, n) {
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(size_t m, size_t n, size_t ld, bool clear, const CpuMemoryPolicy& policy) :
+		Base(m, n), ld(ld) {
 	
-	if (clear) {
-		arr = (float*) calloc(length, sizeof(float));
-	} else {
-		arr = (float*) malloc(sizeof(float) * length);
+	if (ld < n) {
+		throw Exception(
+				"The leading dimension must be at least the number of columns. Expected >= " + to_string(n)
+						+ ", but got: " + to_string(ld) + " instead.");
 	}
+	
+	arr = cpu_malloc<T>(m * ld, clear, policy);
+}
+
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(size_t m, size_t n, T* src) :
+		BasicCpuMatrix(m, n, false) {
+	std::copy(src, src + length, arr);
 }
 
-CpuMatrix::CpuMatrix(size_t m, size_t n, float* src) :
-		CpuMatrix(m, n, false) {
-	copy_float(src, arr, length);
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(T* arr, size_t m, size_t n, size_t ld) :
+		Base(m, n), arr(arr), owner(false), ld(ld) {
 }
 
-CpuMatrix::CpuMatrix(const CpuMatrix& other) :
-		CpuMatrix(other.m, other.n, false) {
-	copy_float(other.arr, arr, length);
+//The copy of a padded matrix keeps its padding, the copy of a view is compact.
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(const BasicCpuMatrix& other) :
+		BasicCpuMatrix(other.m, other.n, other.owner ? other.ld : other.n, false) {
+	copy_rows(other.arr, other.ld, arr, ld, m, n);
+}
+
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(BasicCpuMatrix&& other) :
+		Base(other.m, other.n), arr(other.arr), ld(other.ld) {
+	
+	if (other.owner == false) {
+		//the memory of a view belongs to its matrix, so the elements are copied
+		const_cast<size_t&>(ld) = n;
+		arr = cpu_malloc<T>(length, false);
+		copy_rows(other.arr, other.ld, arr, ld, m, n);
+		return;
+	}
+	
+	other.arr = nullptr;
 }
 
-CpuMatrix::CpuMatrix(const initializer_list<const initializer_list<float>> &list) :
-		Matrix(1, 1) {
+template<typename T>
+BasicCpuMatrix<T>::BasicCpuMatrix(const initializer_list<const initializer_list<T>> &list) :
+		Base(1, 1), ld(1) {
 	size_t listSize = list.size();
 	if (listSize < 1) {
 		throw Exception("Invalid list size: " + to_string(listSize) + ".");
 	}
 	
-	const initializer_list<float>* start = list.begin();
+	const initializer_list<T>* start = list.begin();
 	
 	size_t listColumns = start->size();
 	if (listSize < 1) {
@@ -57,7 +121,7 @@ CpuMatrix::CpuMatrix(const initializer_list<const initializer_list<float>> &list
 	}
 	//first let's check that each row has the same number of columns
 	for (size_t i = 0; i < listSize; i++) {
-		const initializer_list<float>& crt = start[i];
+		const initializer_list<T>& crt = start[i];
 		size_t crtColumns = crt.size();
 		
 		if (listColumns != crtColumns) {
@@ -71,11 +135,12 @@ CpuMatrix::CpuMatrix(const initializer_list<const initializer_list<float>> &list
 	const_cast<size_t&>(m) = listSize;
 	const_cast<size_t&>(n) = listColumns;
 	const_cast<size_t&>(length) = m * n;
-	arr = (float*) malloc(sizeof(float) * length);
+	const_cast<size_t&>(ld) = n;
+	arr = cpu_malloc<T>(length, false);
 	
 	for (size_t i = 0; i < listSize; i++) {
-		const initializer_list<float>& crt = start[i];
-		const float* rowStart = crt.begin();
+		const initializer_list<T>& crt = start[i];
+		const T* rowStart = crt.begin();
 		
 		for (size_t j = 0; j < listColumns; j++) {
 			arr[i * n + j] = rowStart[j];
@@ -83,17 +148,30 @@ CpuMatrix::CpuMatrix(const initializer_list<const initializer_list<float>> &list
 	}
 }
 
-void CpuMatrix::randn() {
-	cs::math::randn(arr, length);
+template<typename T>
+void BasicCpuMatrix<T>::randn() {
+	if (contiguous()) {
+		cs::math::randn(arr, length);
+		return;
+	}
+	
+	for (size_t i = 0; i < m; i++) {
+		cs::math::randn(arr + i * ld, n);
+	}
 }
 
-void CpuMatrix::clear() {
-	for (size_t i = 0; i < length; i++) {
-		arr[i] = 0.0;
+template<typename T>
+void BasicCpuMatrix<T>::clear() {
+	for (size_t i = 0; i < m; i++) {
+		T* row = arr + i * ld;
+		for (size_t j = 0; j < n; j++) {
+			row[j] = 0;
+		}
 	}
 }
 
-CpuMatrix& CpuMatrix::operator=(const CpuMatrix& other) {
+template<typename T>
+BasicCpuMatrix<T>& BasicCpuMatrix<T>::operator=(const BasicCpuMatrix& other) {
 	if (&other == this) {
 		return *this;
 	}
@@ -107,348 +185,501 @@ CpuMatrix& CpuMatrix::operator=(const CpuMatrix& other) {
 		const_cast<size_t&>(m) = other.m;
 		const_cast<size_t&>(n) = other.n;
 		const_cast<size_t&>(length) = other.length;
-		arr = (float*) malloc(sizeof(float) * length);
-		copy_float(other.arr, arr, length);
+		const_cast<size_t&>(ld) = other.owner ? other.ld : other.n;
+		arr = cpu_malloc<T>(m * ld, false);
+		copy_rows(other.arr, other.ld, arr, ld, m, n);
 		
 	} else {
 		check_same_dimensions(other);
-		//the vector is already initialized
-		//just copy
-		copy_float(other.arr, arr, length);
+		//the matrix is already initialized
+		//just copy, keeping its leading dimension
+		copy_rows(other.arr, other.ld, arr, ld, m, n);
 		
 	}
 	
 	return *this;
 }
 
-float CpuMatrix::at(size_t idx) const {
+template<typename T>
+BasicCpuMatrix<T>& BasicCpuMatrix<T>::operator=(BasicCpuMatrix&& other) {
+	if (&other == this) {
+		return *this;
+	}
+	//Same rules as the copy, but the memory is taken instead of copied.
+	//A view neither gives nor takes memory, it is copied.
+	if (owner == false || other.owner == false) {
+		return *this = other;
+	}
+	
+	if (arr == nullptr) {
+		const_cast<size_t&>(m) = other.m;
+		const_cast<size_t&>(n) = other.n;
+		const_cast<size_t&>(length) = other.length;
+	} else {
+		check_same_dimensions(other);
+		cpu_free(arr);
+	}
+	
+	const_cast<size_t&>(ld) = other.ld;
+	arr = other.arr;
+	other.arr = nullptr;
+	
+	return *this;
+}
+
+template<typename T>
+T BasicCpuMatrix<T>::at(size_t idx) const {
 	check_index(idx);
-	return arr[idx];
+	if (contiguous()) {
+		return arr[idx];
+	}
+	return arr[idx / n * ld + idx % n];
 }
 
-float CpuMatrix::get(size_t i, size_t j) const {
+template<typename T>
+T BasicCpuMatrix<T>::get(size_t i, size_t j) const {
 	check_index(i, j);
-	return arr[i * n + j];
+	return arr[i * ld + j];
 }
 
-void CpuMatrix::set(size_t i, size_t j, float val) const {
+template<typename T>
+void BasicCpuMatrix<T>::set(size_t i, size_t j, T val) const {
 	check_index(i, j);
-	arr[i * n + j] = val;
+	arr[i * ld + j] = val;
 }
 
-void CpuMatrix::subi(const CpuMatrix& b) {
-	check_same_dimensions(b);
-	
-	size_t l = length;
-	
-	float* A = arr;
-	float* B = b.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		A[i] = A[i] - B[i];
-	}
+template<typename T>
+void BasicCpuMatrix<T>::addi(const BasicCpuMatrix& b) {
+	*this = *this + b;
+}
+template<typename T>
+void BasicCpuMatrix<T>::subi(const BasicCpuMatrix& b) {
+	*this = *this - b;
+}
+template<typename T>
+void BasicCpuMatrix<T>::multi(const BasicCpuMatrix& b) {
+	*this = *this * b;
+}
+template<typename T>
+void BasicCpuMatrix<T>::multi(const T scalar) {
+	*this = *this * scalar;
+}
+template<typename T>
+void BasicCpuMatrix<T>::divi(const BasicCpuMatrix& b) {
+	*this = *this / b;
+}
+template<typename T>
+void BasicCpuMatrix<T>::divi(const T scalar) {
+	*this = *this / scalar;
+}
+template<typename T>
+void BasicCpuMatrix<T>::powi(const T exp) {
+	*this = *this ^ exp;
 }
 
-const CpuMatrix CpuMatrix::operator+(const CpuMatrix& b) const {
-	check_same_dimensions(b);
+template<typename T>
+void BasicCpuMatrix<T>::dot(const BasicCpuMatrix& b, BasicCpuMatrix& ans) const {
 	
-	size_t l = length;
-	CpuMatrix c = CpuMatrix(m, n, false);
+	assert_cols(b.m, n);
 	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
+	assert_rows(ans.m, m);
+	assert_cols(ans.n, b.n);
 	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] + B[i];
-	}
+	const size_t m = this->m;
+	const size_t n = this->n;
+	const size_t p = b.n;
+	
+	T* A = arr;
+	T* B = b.arr;
+	T* C = ans.arr;
 	
-	return c;
+	//blocked and packed engine, C is written directly (no clear needed)
+	cpu_gemm(A, ld, false, B, b.ld, false, C, ans.ld, m, n, p, (T) 0);
 }
 
-const CpuMatrix CpuMatrix::operator+(float val) const {
+template<typename T>
+BasicCpuMatrix<T> BasicCpuMatrix<T>::dot(const BasicCpuMatrix& b) const {
 	
-	size_t l = length;
-	CpuMatrix ans = CpuMatrix(m, n, false);
+	BasicCpuMatrix ans = BasicCpuMatrix(m, b.n, false);
 	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] + val;
-	}
+	dot(b, ans);
 	
 	return ans;
 }
 
-const CpuMatrix CpuMatrix::operator-(const CpuMatrix& b) const {
-	check_same_dimensions(b);
-	
-	size_t l = length;
-	CpuMatrix c = CpuMatrix(m, n, false);
+template<typename T>
+void BasicCpuMatrix<T>::dot(bool trans, const BasicCpuMatrix& b, BasicCpuMatrix& ans) const {
 	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] - B[i];
+	if (trans == false) {
+		dot(b, ans);
+		return;
 	}
 	
-	return c;
-}
-
-const CpuMatrix CpuMatrix::operator-(float val) const {
-	
-	size_t l = length;
-	CpuMatrix ans = CpuMatrix(m, n, false);
+	assert_rows(b.m, m);
 	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] - val;
-	}
+	assert_rows(ans.m, n);
+	assert_cols(ans.n, b.n);
 	
-	return ans;
+	//this is (m x n), so this^T is (n x m)
+	cpu_gemm(arr, ld, true, b.arr, b.ld, false, ans.arr, ans.ld, n, m, b.n, (T) 0);
 }
 
-const CpuMatrix CpuMatrix::operator-() const {
+template<typename T>
+BasicCpuMatrix<T> BasicCpuMatrix<T>::dot(bool trans, const BasicCpuMatrix& b) const {
 	
-	size_t l = length;
-	CpuMatrix ans = CpuMatrix(m, n, false);
+	BasicCpuMatrix ans = BasicCpuMatrix(trans ? n : m, b.n, false);
 	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = -A[i];
-	}
+	dot(trans, b, ans);
 	
 	return ans;
 }
 
-const CpuMatrix CpuMatrix::operator*(const CpuMatrix& b) const {
-	check_same_dimensions(b);
+template<typename T>
+void BasicCpuMatrix<T>::dot(const BasicCpuMatrix& b, bool trans, BasicCpuMatrix& ans) const {
 	
-	size_t l = length;
-	CpuMatrix c = CpuMatrix(m, n, false);
+	if (trans == false) {
+		dot(b, ans);
+		return;
+	}
 	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
+	assert_cols(b.n, n);
 	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] * B[i];
-	}
+	assert_rows(ans.m, m);
+	assert_cols(ans.n, b.m);
 	
-	return c;
+	//b is (o x n), so b^T is (n x o)
+	cpu_gemm(arr, ld, false, b.arr, b.ld, true, ans.arr, ans.ld, m, n, b.m, (T) 0);
 }
 
-const CpuMatrix CpuMatrix::operator*(float scalar) const {
-	
-	size_t l = length;
-	CpuMatrix ans = CpuMatrix(m, n, false);
+template<typename T>
+BasicCpuMatrix<T> BasicCpuMatrix<T>::dot(const BasicCpuMatrix& b, bool trans) const {
 	
-	float* A = arr;
-	float* B = ans.arr;
+	BasicCpuMatrix ans = BasicCpuMatrix(m, trans ? b.m : b.n, false);
 	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] * scalar;
-	}
+	dot(b, trans, ans);
 	
 	return ans;
 }
 
-const CpuMatrix CpuMatrix::operator/(const CpuMatrix& b) const {
-	check_same_dimensions(b);
-	
-	size_t l = length;
-	CpuMatrix c = CpuMatrix(m, n, false);
-	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
+template<typename T>
+void BasicCpuMatrix<T>::dot(const BasicCpuVector<T>& b, BasicCpuVector<T>& ans) const {
+	dot(false, b, ans);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::dot(const BasicCpuVector<T>& b) const {
+	return dot(false, b);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::dot(bool trans, const BasicCpuVector<T>& b, BasicCpuVector<T>& ans) const {
 	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] / B[i];
+	if (trans) {
+		assert_rows(b.length, m);
+		assert_cols(ans.length, n);
+	} else {
+		assert_cols(b.length, n);
+		assert_rows(ans.length, m);
 	}
 	
-	return c;
+	cpu_gemv(arr, ld, trans, b.ptr(), ans.ptr(), m, n);
 }
 
-const CpuMatrix CpuMatrix::operator/(float scalar) const {
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::dot(bool trans, const BasicCpuVector<T>& b) const {
 	
-	size_t l = length;
-	CpuMatrix ans = CpuMatrix(m, n, false);
+	BasicCpuVector<T> ans = BasicCpuVector<T>(trans ? n : m, false);
 	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] / scalar;
-	}
+	dot(trans, b, ans);
 	
 	return ans;
 }
 
-const CpuMatrix CpuMatrix::operator^(float exp) const {
+template<typename T>
+BasicCpuMatrix<T> BasicCpuMatrix<T>::affine(const BasicCpuMatrix& x, const BasicCpuVector<T>& b) const {
 	
-	size_t l = length;
-	CpuMatrix ans = CpuMatrix(m, n, false);
-	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = pow(A[i], exp);
-	}
+	BasicCpuMatrix ans = BasicCpuMatrix(m, x.n, false);
+	affine(x, b, ans);
 	
 	return ans;
 }
 
-void CpuMatrix::dot(const CpuMatrix& b, CpuMatrix& ans) const {
+template<typename T>
+void BasicCpuMatrix<T>::affine(const Matrix&, const Vector&, Matrix&) const {
+	throw Exception("Only the float matrices are a Matrix, use the matrices of the same element type.");
+}
+
+template<>
+void BasicCpuMatrix<float>::affine(const Matrix& x, const Vector& b, Matrix& ans) const {
+	affine(cpu_cast(x), cpu_cast(b), cpu_cast(ans));
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::affine(const BasicCpuMatrix& x, const BasicCpuVector<T>& b, BasicCpuMatrix& ans) const {
 	
-	assert_cols(b.m, n);
+	size_t p = x.n;
+	assert_rows(b.length, p);
+	dot(x, ans);
+	ans.addi_rows(b);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::affine(const BasicCpuMatrix&, const BasicCpuVector<T>&, CpuActivation, BasicCpuMatrix&) const {
+	throw Exception("The fused affine is only for the float matrices.");
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::affine(const BasicCpuMatrix&, const BasicCpuVector<T>&, CpuActivation, BasicCpuMatrix&,
+		BasicCpuMatrix&) const {
+	throw Exception("The fused affine is only for the float matrices.");
+}
+
+//ans = act(a x x + b), pre (or nullptr) gets a x x + b
+static void fused_affine(const CpuMatrix& a, const CpuMatrix& x, const CpuVector& b, CpuActivation act,
+		CpuMatrix& ans, CpuMatrix* pre) {
+	CpuEpilogue ep = { b.ptr(), act, pre ? pre->ptr() : nullptr, pre ? pre->ld : 0 };
+	cpu_gemm_fused(a.ptr(), a.ld, false, x.ptr(), x.ld, false, ans.ptr(), ans.ld, a.m, a.n, x.n, ep);
+}
+
+template<>
+void BasicCpuMatrix<float>::affine(const CpuMatrix& x, const CpuVector& b, CpuActivation act, CpuMatrix& ans) const {
 	
+	assert_cols(x.m, n);
 	assert_rows(ans.m, m);
-	assert_cols(ans.n, b.n);
+	assert_cols(ans.n, x.n);
+	assert_rows(b.length, x.n);
 	
-	const size_t m = this->m;
-	const size_t n = this->n;
-	const size_t p = b.n;
-	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = ans.arr;
-	
-	ans.clear();
-	//algorithm based on the GNU Scientific Library (GSL)
-	//linear algebra method: gsl_blas_sgemm
-	for (size_t i = 0; i < m; i++) {
-		for (size_t j = 0; j < n; j++) {
-			const float pivot = A[i * n + j];
-			for (size_t k = 0; k < p; k++) {
-				C[i * p + k] += pivot * B[j * p + k];
-			}
-		}
-	}
+	fused_affine(*this, x, b, act, ans, nullptr);
 }
 
-const CpuMatrix CpuMatrix::dot(const CpuMatrix& b) const {
-	
-	CpuMatrix ans = CpuMatrix(m, b.n);
+template<>
+void BasicCpuMatrix<float>::affine(const CpuMatrix& x, const CpuVector& b, CpuActivation act, CpuMatrix& ans,
+		CpuMatrix& pre) const {
 	
-	dot(b, ans);
+	assert_cols(x.m, n);
+	assert_rows(ans.m, m);
+	assert_cols(ans.n, x.n);
+	assert_rows(b.length, x.n);
+	ans.check_same_dimensions(pre);
 	
+	fused_affine(*this, x, b, act, ans, &pre);
+}
+
+template<typename T>
+T BasicCpuMatrix<T>::sum() const {
+	return cpu_sum(arr, ld, m, n);
+}
+
+template<typename T>
+T BasicCpuMatrix<T>::max() const {
+	return cpu_max(arr, ld, m, n);
+}
+
+template<typename T>
+T BasicCpuMatrix<T>::min() const {
+	return cpu_min(arr, ld, m, n);
+}
+
+template<typename T>
+T BasicCpuMatrix<T>::avg() const {
+	return sum() / length;
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::sum_rows(BasicCpuVector<T>& ans) const {
+	assert_cols(ans.length, n);
+	cpu_sum_rows(arr, ld, ans.ptr(), m, n);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::sum_rows() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(n, false);
+	sum_rows(ans);
 	return ans;
 }
 
-const CpuVector CpuMatrix::dot(const CpuVector& b) const {
-	
-	assert_cols(b.length, n);
-	
-	CpuVector ans = CpuVector(m, false);
-	
-	const size_t m = this->m;
-	const size_t n = this->n;
-	
-	float* A = arr;
-	float* B = b.ptr();
-	float* C = ans.ptr();
-	
-	for (size_t i = 0; i < m; i++) {
-		float val = 0.0;
-		for (size_t j = 0; j < n; j++) {
-			val += A[i * n + j] * B[j];
-		}
-		C[i] = val;
-	}
-	
+template<typename T>
+void BasicCpuMatrix<T>::max_rows(BasicCpuVector<T>& ans) const {
+	assert_cols(ans.length, n);
+	cpu_max_rows(arr, ld, ans.ptr(), m, n);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::max_rows() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(n, false);
+	max_rows(ans);
 	return ans;
 }
 
-const CpuMatrix CpuMatrix::affine(const CpuMatrix& x, const CpuVector& b) const {
-	
-	CpuMatrix ans = CpuMatrix(m, x.n, false);
-	affine(x, b, ans);
-	
+template<typename T>
+void BasicCpuMatrix<T>::min_rows(BasicCpuVector<T>& ans) const {
+	assert_cols(ans.length, n);
+	cpu_min_rows(arr, ld, ans.ptr(), m, n);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::min_rows() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(n, false);
+	min_rows(ans);
 	return ans;
 }
 
-void CpuMatrix::affine(const Matrix& x, const Vector& b, Matrix& ans) const {
-	affine(cpu_cast(x), cpu_cast(b), cpu_cast(ans));
+template<typename T>
+void BasicCpuMatrix<T>::sum_cols(BasicCpuVector<T>& ans) const {
+	assert_rows(ans.length, m);
+	cpu_sum_cols(arr, ld, ans.ptr(), m, n);
 }
 
-void CpuMatrix::affine(const CpuMatrix& x, const CpuVector& b, CpuMatrix& ans) const {
-	
-	size_t p = x.n;
-	assert_rows(b.length, p);
-	dot(x, ans);
-	
-	float* B = b.ptr();
-	float* Y = ans.ptr();
-	
-	for (size_t i = 0; i < m; i++) {
-		for (size_t k = 0; k < p; k++) {
-			Y[i * p + k] += B[k];
-		}
-	}
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::sum_cols() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(m, false);
+	sum_cols(ans);
+	return ans;
 }
 
-float CpuMatrix::sum() const {
-	
-	size_t l = length;
-	float* A = arr;
-	
-	float ans = A[0];
-	for (size_t i = 1; i < l; i++) {
-		ans += A[i];
-	}
-	
+template<typename T>
+void BasicCpuMatrix<T>::max_cols(BasicCpuVector<T>& ans) const {
+	assert_rows(ans.length, m);
+	cpu_max_cols(arr, ld, ans.ptr(), m, n);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::max_cols() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(m, false);
+	max_cols(ans);
 	return ans;
 }
 
-float CpuMatrix::max() const {
-	
-	size_t l = length;
-	float* A = arr;
-	
-	float ans = A[0];
-	for (size_t i = 1; i < l; i++) {
-		ans = std::max(ans, A[i]);
-	}
-	
+template<typename T>
+void BasicCpuMatrix<T>::min_cols(BasicCpuVector<T>& ans) const {
+	assert_rows(ans.length, m);
+	cpu_min_cols(arr, ld, ans.ptr(), m, n);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::min_cols() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(m, false);
+	min_cols(ans);
 	return ans;
 }
 
-float CpuMatrix::min() const {
-	
-	size_t l = length;
-	float* A = arr;
+template<typename T>
+void BasicCpuMatrix<T>::avg_rows(BasicCpuVector<T>& ans) const {
+	sum_rows(ans);
+	ans.divi((T) m);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::avg_rows() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(n, false);
+	avg_rows(ans);
+	return ans;
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::avg_cols(BasicCpuVector<T>& ans) const {
+	sum_cols(ans);
+	ans.divi((T) n);
+}
+
+template<typename T>
+BasicCpuVector<T> BasicCpuMatrix<T>::avg_cols() const {
+	BasicCpuVector<T> ans = BasicCpuVector<T>(m, false);
+	avg_cols(ans);
+	return ans;
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::addi_rows(const BasicCpuVector<T>& b) {
+	assert_cols(b.length, n);
+	cpu_broadcast_rows(CPU_ADD, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::subi_rows(const BasicCpuVector<T>& b) {
+	assert_cols(b.length, n);
+	cpu_broadcast_rows(CPU_SUB, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::multi_rows(const BasicCpuVector<T>& b) {
+	assert_cols(b.length, n);
+	cpu_broadcast_rows(CPU_MUL, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::divi_rows(const BasicCpuVector<T>& b) {
+	assert_cols(b.length, n);
+	cpu_broadcast_rows(CPU_DIV, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::addi_cols(const BasicCpuVector<T>& b) {
+	assert_rows(b.length, m);
+	cpu_broadcast_cols(CPU_ADD, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::subi_cols(const BasicCpuVector<T>& b) {
+	assert_rows(b.length, m);
+	cpu_broadcast_cols(CPU_SUB, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::multi_cols(const BasicCpuVector<T>& b) {
+	assert_rows(b.length, m);
+	cpu_broadcast_cols(CPU_MUL, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::divi_cols(const BasicCpuVector<T>& b) {
+	assert_rows(b.length, m);
+	cpu_broadcast_cols(CPU_DIV, arr, ld, b.ptr(), arr, ld, m, n);
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::transpose(BasicCpuMatrix& ans) const {
+	assert_rows(ans.m, n);
+	assert_cols(ans.n, m);
+	cpu_transpose(arr, ld, ans.arr, ans.ld, m, n);
+}
+
+template<typename T>
+BasicCpuMatrix<T> BasicCpuMatrix<T>::transpose() const {
+	BasicCpuMatrix ans = BasicCpuMatrix(n, m, false);
+	transpose(ans);
+	return ans;
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::transposei() {
 	
-	float ans = A[0];
-	for (size_t i = 1; i < l; i++) {
-		ans = std::min(ans, A[i]);
+	if (m != n) {
+		throw Exception("Only a square matrix can be transposed in place, this one is " + to_string(m) + "x"
+				+ to_string(n) + ".");
 	}
 	
-	return ans;
+	cpu_transpose_square(arr, ld, n);
 }
 
-float CpuMatrix::avg() const {
-	return sum() / length;
+template<typename T>
+void BasicCpuMatrix<T>::copy(Matrix&) const {
+	throw Exception("Only the float matrices are a Matrix, copy to a matrix of the same element type.");
 }
 
-void CpuMatrix::copy(Matrix& dest) const {
+template<>
+void BasicCpuMatrix<float>::copy(Matrix& dest) const {
 	copy(cpu_cast(dest));
 }
 
-void CpuMatrix::copy(CpuMatrix& dest) const {
+template<typename T>
+void BasicCpuMatrix<T>::copy(BasicCpuMatrix& dest) const {
 	check_same_dimensions(dest);
-	copy_float(arr, dest.arr, length);
+	copy_rows(arr, ld, dest.arr, dest.ld, m, n);
 }
 
-const CpuMatrix CpuMatrix::sltcols(size_t start, size_t end) const {
+template<typename T>
+BasicCpuMatrix<T> BasicCpuMatrix<T>::sltcols(size_t start, size_t end) const {
 	
 	if (start >= end) {
 		throw Exception(
@@ -468,29 +699,49 @@ const CpuMatrix CpuMatrix::sltcols(size_t start, size_t end) const {
 						+ to_string(end) + " instead.");
 	}
 	
-	size_t cols = end - start;
-	CpuMatrix ans = CpuMatrix(m, cols);
-	
-	float* A = this->arr;
-	float* B = ans.ptr();
-	
-	for (size_t i = 0; i < m; i++) {
-		for (size_t j = 0; j < cols; j++) {
-			size_t src = i * n + j + start;
-			size_t dst = i * cols + j;
-			
-			B[dst] = A[src];
-		}
-	}
+	//a compact copy of the view
+	BasicCpuMatrix ans = cols(start, end);
 	
 	return ans;
 }
 
-float* CpuMatrix::ptr() const {
+template<typename T>
+BasicMatrixView<T> BasicCpuMatrix<T>::rows(size_t start, size_t end) const {
+	check_range(start, end, m, "rows");
+	return BasicMatrixView<T>(arr + start * ld, end - start, n, ld);
+}
+
+template<typename T>
+BasicMatrixView<T> BasicCpuMatrix<T>::cols(size_t start, size_t end) const {
+	check_range(start, end, n, "columns");
+	return BasicMatrixView<T>(arr + start, m, end - start, ld);
+}
+
+template<typename T>
+BasicMatrixView<T> BasicCpuMatrix<T>::block(size_t i, size_t j, size_t rows, size_t cols) const {
+	check_range(i, i + rows, m, "rows");
+	check_range(j, j + cols, n, "columns");
+	return BasicMatrixView<T>(arr + i * ld + j, rows, cols, ld);
+}
+
+template<typename T>
+RowView<T> BasicCpuMatrix<T>::row(size_t i) const {
+	check_index(i, 0);
+	return RowView<T>(arr + i * ld, n);
+}
+
+template<typename T>
+T* BasicCpuMatrix<T>::ptr() const {
 	return arr;
 }
 
-void CpuMatrix::print() const {
+template<typename T>
+bool BasicCpuMatrix<T>::contiguous() const {
+	return ld == n;
+}
+
+template<typename T>
+void BasicCpuMatrix<T>::print() const {
 	
 	size_t rows = std::min((size_t) MATRIX_PRINT_MAX, m);
 	size_t cols = std::min((size_t) MATRIX_PRINT_MAX, n);
@@ -502,7 +753,7 @@ void CpuMatrix::print() const {
 	}
 	for (size_t i = 0; i < rows; i++) {
 		for (size_t j = 0; j < cols; j++) {
-			printf("%12.4f", arr[i * n + j]);
+			printf("%12.4f", arr[i * ld + j]);
 			if (j + 1 < n) {
 				printf("  ");
 			}
@@ -513,11 +764,45 @@ void CpuMatrix::print() const {
 	println();
 }
 
-CpuMatrix::~CpuMatrix() {
-	if (arr) {
-		free(arr);
+template<typename T>
+BasicCpuMatrix<T>::~BasicCpuMatrix() {
+	if (arr && owner) {
+		cpu_free(arr);
 	}
 }
 
+template<typename T>
+BasicMatrixView<T>::BasicMatrixView(T* arr, size_t m, size_t n, size_t ld) :
+		BasicCpuMatrix<T>(arr, m, n, ld) {
+}
+
+template<typename T>
+BasicMatrixView<T>::BasicMatrixView(const BasicMatrixView& other) :
+		BasicCpuMatrix<T>(other.ptr(), other.m, other.n, other.ld) {
+}
+
+template<typename T>
+BasicMatrixView<T>::BasicMatrixView(BasicMatrixView&& other) :
+		BasicCpuMatrix<T>(other.ptr(), other.m, other.n, other.ld) {
+}
+
+//writes the elements of other into the viewed memory
+template<typename T>
+BasicMatrixView<T>& BasicMatrixView<T>::operator=(const BasicMatrixView& other) {
+	BasicCpuMatrix<T>::operator=(other);
+	return *this;
+}
+
+template<typename T>
+BasicMatrixView<T>::~BasicMatrixView() {
+//nothing to free, the memory belongs to the matrix
+}
+
+//the element types of the matrices
+template class BasicCpuMatrix<float>;
+template class BasicCpuMatrix<double>;
+template class BasicMatrixView<float>;
+template class BasicMatrixView<double>;
+
 } // namespace math 
 } // namespace cs 
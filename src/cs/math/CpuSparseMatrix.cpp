@@ -0,0 +1,262 @@
+/*
+ * CpuSparseMatrix.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/core/lang.h>
+#include <cs/cpu/cpu.h>
+#include <cs/math/CpuSparseMatrix.h>
+#include <cs/math/math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace cs {
+using namespace core;
+using namespace cpu;
+namespace math {
+
+CpuSparseMatrix::CpuSparseMatrix(size_t m, size_t n, std::vector<size_t>&& rows, std::vector<size_t>&& cols,
+		std::vector<float>&& values) :
+		Matrix(m, n), rows(std::move(rows)), cols(std::move(cols)), values(std::move(values)) {
+	check_format();
+	track();
+}
+
+CpuSparseMatrix::CpuSparseMatrix(const CpuMatrix& dense) :
+		Matrix(dense.m, dense.n), rows(dense.m + 1) {
+	
+	const float* arr = dense.ptr();
+	
+	for (size_t i = 0; i < m; i++) {
+		rows[i] = values.size();
+		const float* row = arr + i * dense.ld;
+		for (size_t j = 0; j < n; j++) {
+			if (row[j] != 0.0f) {
+				cols.push_back(j);
+				values.push_back(row[j]);
+			}
+		}
+	}
+	rows[m] = values.size();
+	track();
+}
+
+CpuSparseMatrix::CpuSparseMatrix(const CpuSparseMatrix& other) :
+		Matrix(other.m, other.n), rows(other.rows), cols(other.cols), values(other.values) {
+	track();
+}
+
+void CpuSparseMatrix::track() const {
+	
+	cpu_untrack_memory(CPU_MEMORY_DATA, tracked);
+	
+	//the capacities, a cleared vector keeps its memory
+	size_t bytes = (rows.capacity() + cols.capacity() + tRows.capacity() + tCols.capacity()) * sizeof(size_t)
+			+ (values.capacity() + tValues.capacity()) * sizeof(float);
+	tracked = cpu_track_memory(CPU_MEMORY_DATA, bytes);
+}
+
+void CpuSparseMatrix::check_format() const {
+	
+	if (rows.size() != m + 1) {
+		throw Exception(
+				"The row offsets must have m + 1 values. Expected " + to_string(m + 1) + ", but got: "
+						+ to_string(rows.size()) + " instead.");
+	}
+	
+	if (cols.size() != values.size() || rows[0] != 0 || rows[m] != values.size()) {
+		throw Exception(
+				"The row offsets must go from 0 to the number of values " + to_string(values.size()) + ", but got: "
+						+ to_string(rows[0]) + " to " + to_string(rows[m]) + " with " + to_string(cols.size())
+						+ " columns instead.");
+	}
+	
+	for (size_t i = 0; i < m; i++) {
+		if (rows[i] > rows[i + 1]) {
+			throw Exception("The row offsets must be sorted, row " + to_string(i) + " ends before it starts.");
+		}
+	}
+	
+	for (size_t k = 0; k < cols.size(); k++) {
+		if (cols[k] >= n) {
+			throw Exception(
+					"The column index is out of bounds. Expected < " + to_string(n) + ", but got: "
+							+ to_string(cols[k]) + " instead.");
+		}
+	}
+}
+
+void CpuSparseMatrix::build_transpose() const {
+	
+	if (tRows.size() == n + 1) {
+		return;
+	}
+	
+	tRows.resize(n + 1);
+	tCols.resize(values.size());
+	tValues.resize(values.size());
+	cpu_csr_transpose(val_ptr(), col_ptr(), row_ptr(), m, n, tValues.data(), tCols.data(), tRows.data());
+	track();
+}
+
+//the memory of the transpose is released, not only its values
+void CpuSparseMatrix::drop_transpose() {
+	std::vector<size_t>().swap(tRows);
+	std::vector<size_t>().swap(tCols);
+	std::vector<float>().swap(tValues);
+	track();
+}
+
+size_t CpuSparseMatrix::nnz() const {
+	return values.size();
+}
+
+size_t CpuSparseMatrix::bytes() const {
+	return values.size() * (sizeof(float) + sizeof(size_t)) + rows.size() * sizeof(size_t);
+}
+
+size_t* CpuSparseMatrix::row_ptr() const {
+	return const_cast<size_t*>(rows.data());
+}
+
+size_t* CpuSparseMatrix::col_ptr() const {
+	return const_cast<size_t*>(cols.data());
+}
+
+float* CpuSparseMatrix::val_ptr() const {
+	return const_cast<float*>(values.data());
+}
+
+void CpuSparseMatrix::clear() {
+	std::fill(rows.begin(), rows.end(), 0);
+	cols.clear();
+	values.clear();
+	drop_transpose();
+}
+
+void CpuSparseMatrix::affine(const Matrix& w, const Vector& b, Matrix& ans) const {
+	affine(cpu_cast(w), cpu_cast(b), cpu_cast(ans));
+}
+
+void CpuSparseMatrix::affine(const CpuMatrix& w, const CpuVector& b, CpuMatrix& ans) const {
+	
+	size_t p = w.n;
+	assert_rows(b.length, p);
+	dot(w, ans);
+	ans.addi_rows(b);
+}
+
+void CpuSparseMatrix::dot(const CpuMatrix& b, CpuMatrix& ans) const {
+	
+	assert_cols(b.m, n);
+	
+	assert_rows(ans.m, m);
+	assert_cols(ans.n, b.n);
+	
+	cpu_spmm(val_ptr(), col_ptr(), row_ptr(), b.ptr(), b.ld, ans.ptr(), ans.ld, m, b.n);
+}
+
+void CpuSparseMatrix::dot(bool trans, const CpuMatrix& b, CpuMatrix& ans) const {
+	
+	if (trans == false) {
+		dot(b, ans);
+		return;
+	}
+	
+	assert_rows(b.m, m);
+	
+	assert_rows(ans.m, n);
+	assert_cols(ans.n, b.n);
+	
+	//each row of ans gathers the rows of b of the nonzeros of a column of this
+	build_transpose();
+	cpu_spmm(tValues.data(), tCols.data(), tRows.data(), b.ptr(), b.ld, ans.ptr(), ans.ld, n, b.n);
+}
+
+void CpuSparseMatrix::randn() {
+	if (values.size() > 0) {
+		cs::math::randn(values.data(), values.size());
+	}
+	drop_transpose();
+}
+
+float CpuSparseMatrix::sum() const {
+	return values.size() > 0 ? cpu_sum(val_ptr(), values.size(), 1, values.size()) : 0.0f;
+}
+
+void CpuSparseMatrix::copy(Matrix& dest) const {
+	
+	check_same_dimensions(dest);
+	
+	CpuSparseMatrix* sparse = dynamic_cast<CpuSparseMatrix*>(&dest);
+	if (sparse) {
+		sparse->rows = rows;
+		sparse->cols = cols;
+		sparse->values = values;
+		sparse->drop_transpose();
+		return;
+	}
+	
+	CpuMatrix& dense = cpu_cast(dest);
+	float* arr = dense.ptr();
+	
+	dense.clear();
+	for (size_t i = 0; i < m; i++) {
+		float* row = arr + i * dense.ld;
+		for (size_t k = rows[i]; k < rows[i + 1]; k++) {
+			row[cols[k]] = values[k];
+		}
+	}
+}
+
+CpuMatrix CpuSparseMatrix::to_dense() const {
+	
+	CpuMatrix ans = CpuMatrix(m, n, true);
+	copy(ans);
+	
+	return ans;
+}
+
+void CpuSparseMatrix::print() const {
+	
+	size_t rows = std::min((size_t) MATRIX_PRINT_MAX, m);
+	size_t cols = std::min((size_t) MATRIX_PRINT_MAX, n);
+	
+	if (m > MATRIX_PRINT_MAX || n > MATRIX_PRINT_MAX) {
+		printf("CpuSparseMatrix  %dx%d  nnz %d   (truncated)\n", (int) m, (int) n, (int) nnz());
+	} else {
+		printf("CpuSparseMatrix  %dx%d  nnz %d\n", (int) m, (int) n, (int) nnz());
+	}
+	for (size_t i = 0; i < rows; i++) {
+		size_t k = this->rows[i];
+		size_t end = this->rows[i + 1];
+		for (size_t j = 0; j < cols; j++) {
+			float val = 0.0f;
+			//the columns of a row are sorted when built from a dense matrix or a Grid
+			while (k < end && this->cols[k] < j) {
+				k++;
+			}
+			if (k < end && this->cols[k] == j) {
+				val = values[k];
+			}
+			printf("%12.4f", val);
+			if (j + 1 < n) {
+				printf("  ");
+			}
+		}
+		println();
+	}
+	
+	println();
+}
+
+CpuSparseMatrix::~CpuSparseMatrix() {
+	cpu_untrack_memory(CPU_MEMORY_DATA, tracked);
+}
+
+} // namespace math
+} // namespace cs
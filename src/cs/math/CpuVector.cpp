@@ -7,6 +7,7 @@
 
 #include <cs/core/Exception.h>
 #include <cs/core/lang.h>
+#include <cs/cpu/cpu.h>
 #include <cs/math/CpuVector.h>
 #include <cs/math/math.h>
 #include <stddef.h>
@@ -16,53 +17,63 @@
 
 namespace cs {
 using namespace core;
+using namespace cpu;
 namespace math {
 
-CpuVector::CpuVector(size_t length) :
-		CpuVector(length, true) {
+template<typename T>
+BasicCpuVector<T>::BasicCpuVector(size_t length) :
+		BasicCpuVector(length, true) {
 	
 }
 
-CpuVector::CpuVector(size_t length, bool clear) :
-		Vector(length) {
+template<typename T>
+BasicCpuVector<T>::BasicCpuVector(size_t length, bool clear) :
+		Base(length) {
 	
 	if (length < 1) {
 		throw Exception("Invalid length " + to_string(length) + ".");
 	}
 	
-	if (clear) {
-		arr = (float*) calloc(length, sizeof(float));
-	} else {
-		arr = (float*) malloc(sizeof(float) * length);
-	}
+	arr = cpu_malloc<T>(length, clear);
+}
+
+template<typename T>
+BasicCpuVector<T>::BasicCpuVector(const BasicCpuVector& other) :
+		BasicCpuVector(other.length, false) {
+	T* src = other.ptr();
+	std::copy(src, src + length, arr);
 }
 
-CpuVector::CpuVector(const CpuVector& other) :
-		CpuVector(other.length, false) {
-	float* src = other.ptr();
-	copy_float(src, arr, length);
+template<typename T>
+BasicCpuVector<T>::BasicCpuVector(BasicCpuVector&& other) :
+		Base(other.length), arr(other.arr) {
+	other.arr = nullptr;
 }
 
-CpuVector::CpuVector(const initializer_list<float> &list) :
-		CpuVector(list.size(), false) {
-	const float* start = list.begin();
+template<typename T>
+BasicCpuVector<T>::BasicCpuVector(const initializer_list<T> &list) :
+		BasicCpuVector(list.size(), false) {
+	const T* start = list.begin();
 	
 	for (size_t i = 0; i < length; i++) {
 		arr[i] = *(start + i);
 	}
 }
 
-void CpuVector::randn() {
+template<typename T>
+void BasicCpuVector<T>::randn() {
 	cs::math::randn(arr, length);
 }
 
-void CpuVector::clear() {
+template<typename T>
+void BasicCpuVector<T>::clear() {
 	for (size_t i = 0; i < length; i++) {
-		arr[i] = 0.0;
+		arr[i] = 0;
 	}
 }
 
-CpuVector& CpuVector::operator=(const CpuVector& other) {
+template<typename T>
+BasicCpuVector<T>& BasicCpuVector<T>::operator=(const BasicCpuVector& other) {
 	if (&other == this) {
 		return *this;
 	}
@@ -74,286 +85,146 @@ CpuVector& CpuVector::operator=(const CpuVector& other) {
 		
 		//allocate and copy
 		const_cast<size_t&>(length) = other.length;
-		arr = (float*) malloc(sizeof(float) * length);
-		copy_float(other.arr, arr, length);
+		arr = cpu_malloc<T>(length, false);
+		std::copy(other.arr, other.arr + length, arr);
 		
 	} else {
 		check_same_length(other);
 		//the vector is already initialized
 		//just copy
-		copy_float(other.arr, arr, length);
+		std::copy(other.arr, other.arr + length, arr);
 		
 	}
 	
 	return *this;
 }
 
-float CpuVector::operator[](size_t idx) const {
-	check_index(idx);
-	return arr[idx];
-}
-
-float& CpuVector::operator[](size_t idx) {
-	check_index(idx);
-	return arr[idx];
-}
-
-const CpuVector CpuVector::operator+(const CpuVector& b) const {
-	check_same_length(b);
-	
-	size_t l = length;
-	CpuVector c = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] + B[i];
+template<typename T>
+BasicCpuVector<T>& BasicCpuVector<T>::operator=(BasicCpuVector&& other) {
+	if (&other == this) {
+		return *this;
 	}
+	//Same rules as the copy, but the memory is taken instead of copied.
 	
-	return c;
-}
-
-const CpuVector CpuVector::operator+(float val) const {
-	
-	size_t l = length;
-	CpuVector ans = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] + val;
+	if (arr == nullptr) {
+		const_cast<size_t&>(length) = other.length;
+	} else {
+		check_same_length(other);
+		cpu_free(arr);
 	}
 	
-	return ans;
-}
-
-const CpuVector CpuVector::operator-(const CpuVector& b) const {
-	check_same_length(b);
-	
-	size_t l = length;
-	CpuVector c = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] - B[i];
-	}
+	arr = other.arr;
+	other.arr = nullptr;
 	
-	return c;
+	return *this;
 }
 
-const CpuVector CpuVector::operator-(float val) const {
-	
-	size_t l = length;
-	CpuVector ans = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] - val;
-	}
-	
-	return ans;
+template<typename T>
+T BasicCpuVector<T>::operator[](size_t idx) const {
+	check_index(idx);
+	return arr[idx];
 }
 
-const CpuVector CpuVector::operator-() const {
-	
-	size_t l = length;
-	CpuVector ans = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = -A[i];
-	}
-	
-	return ans;
+template<typename T>
+T& BasicCpuVector<T>::operator[](size_t idx) {
+	check_index(idx);
+	return arr[idx];
 }
 
-const CpuVector CpuVector::operator*(const CpuVector& b) const {
-	check_same_length(b);
-	
-	size_t l = length;
-	CpuVector c = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] * B[i];
-	}
-	
-	return c;
+template<typename T>
+void BasicCpuVector<T>::addi(const BasicCpuVector& b) {
+	*this = *this + b;
 }
-
-const CpuVector CpuVector::operator*(float scalar) const {
-	
-	size_t l = length;
-	CpuVector ans = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] * scalar;
-	}
-	
-	return ans;
+template<typename T>
+void BasicCpuVector<T>::subi(const BasicCpuVector& b) {
+	*this = *this - b;
 }
-
-const CpuVector CpuVector::operator^(float exp) const {
-	
-	size_t l = length;
-	CpuVector ans = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = pow(A[i], exp);
-	}
-	
-	return ans;
+template<typename T>
+void BasicCpuVector<T>::multi(const BasicCpuVector& b) {
+	*this = *this * b;
 }
-
-const CpuVector CpuVector::operator/(const CpuVector& b) const {
-	check_same_length(b);
-	
-	size_t l = length;
-	CpuVector c = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = b.arr;
-	float* C = c.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		C[i] = A[i] / B[i];
-	}
-	
-	return c;
+template<typename T>
+void BasicCpuVector<T>::multi(const T scalar) {
+	*this = *this * scalar;
 }
-
-const CpuVector CpuVector::operator/(float scalar) const {
-	
-	size_t l = length;
-	CpuVector ans = CpuVector(l, false);
-	
-	float* A = arr;
-	float* B = ans.arr;
-	
-	for (size_t i = 0; i < l; i++) {
-		B[i] = A[i] / scalar;
-	}
-	
-	return ans;
+template<typename T>
+void BasicCpuVector<T>::divi(const BasicCpuVector& b) {
+	*this = *this / b;
+}
+template<typename T>
+void BasicCpuVector<T>::divi(const T scalar) {
+	*this = *this / scalar;
+}
+template<typename T>
+void BasicCpuVector<T>::powi(const T exp) {
+	*this = *this ^ exp;
 }
 
-float CpuVector::sum() const {
-	
-	size_t l = length;
-	float* A = arr;
-	
-	float ans = A[0];
-	for (size_t i = 1; i < l; i++) {
-		ans += A[i];
-	}
-	
-	return ans;
+template<typename T>
+T BasicCpuVector<T>::sum() const {
+	return cpu_sum(arr, length, 1, length);
 }
 
-float CpuVector::max() const {
-	
-	size_t l = length;
-	float* A = arr;
-	
-	float ans = A[0];
-	for (size_t i = 1; i < l; i++) {
-		ans = std::max(ans, A[i]);
-	}
-	
-	return ans;
+template<typename T>
+T BasicCpuVector<T>::max() const {
+	return cpu_max(arr, length, 1, length);
 }
 
-float CpuVector::min() const {
-	
-	size_t l = length;
-	float* A = arr;
-	
-	float ans = A[0];
-	for (size_t i = 1; i < l; i++) {
-		ans = std::min(ans, A[i]);
-	}
-	
-	return ans;
+template<typename T>
+T BasicCpuVector<T>::min() const {
+	return cpu_min(arr, length, 1, length);
 }
 
-float CpuVector::avg() const {
+template<typename T>
+T BasicCpuVector<T>::avg() const {
 	return sum() / length;
 }
 
-float CpuVector::var() const {
-	
-	//from:
-	//https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Online_algorithm
-	size_t n = 0;
-	float _mean = 0.0;
-	float m2 = 0.0;
+template<typename T>
+T BasicCpuVector<T>::var() const {
 	
-	float* A = arr;
-	size_t l = length;
-	for (size_t i = 0; i < l; i++) {
-		n++;
-		float x = A[i];
-		float delta = x - _mean;
-		_mean += delta / n;
-		m2 += delta * (x - _mean);
-		
-	}
+	//two vectorized passes, the mean and then the squared deviations from it, which is
+	//as stable as the online algorithm that was used before and does not divide per element
+	T mean = avg();
+	T m2 = cpu_sum_sq_dev(arr, length, 1, length, mean);
 	
-	float ans = (m2 / (n - 1));
+	T ans = (m2 / (length - 1));
 	return ans;
 }
 
-float CpuVector::stdev() const {
+template<typename T>
+T BasicCpuVector<T>::stdev() const {
 	return sqrt(var());
 }
 
-float CpuVector::dot(const CpuVector b) const {
-	
-	size_t l = length;
-	
-	float* A = arr;
-	float* B = b.arr;
-	
-	float ans = 0.0;
-	for (size_t i = 0; i < l; i++) {
-		ans += A[i] * B[i];
-	}
-	
-	return ans;
+template<typename T>
+T BasicCpuVector<T>::dot(const BasicCpuVector& b) const {
+	check_same_length(b);
+	return cpu_vdot(arr, b.arr, length);
+}
+
+template<typename T>
+void BasicCpuVector<T>::copy(Vector&) const {
+	throw Exception("Only the float vectors are a Vector, copy to a vector of the same element type.");
 }
 
-void CpuVector::copy(Vector& dest) const {
+template<>
+void BasicCpuVector<float>::copy(Vector& dest) const {
 	copy(cpu_cast(dest));
 }
-void CpuVector::copy(CpuVector& dest) const {
+template<typename T>
+void BasicCpuVector<T>::copy(BasicCpuVector& dest) const {
 	check_same_length(dest);
-	copy_float(arr, dest.arr, length);
+	std::copy(arr, arr + length, dest.arr);
 }
 
-float* CpuVector::ptr() const {
+template<typename T>
+T* BasicCpuVector<T>::ptr() const {
 	return arr;
 }
 
-void CpuVector::print()const {
+template<typename T>
+void BasicCpuVector<T>::print()const {
 	size_t l = std::min(VECTOR_PRINT_MAX, length);
 	
 	if (l > VECTOR_PRINT_MAX) {
@@ -371,12 +242,17 @@ void CpuVector::print()const {
 	fflush(stdout);
 }
 
-CpuVector::~CpuVector() {
+template<typename T>
+BasicCpuVector<T>::~BasicCpuVector() {
 	if (arr) {
-		free(arr);
+		cpu_free(arr);
 	}
 }
 
+//the element types of the vectors
+template class BasicCpuVector<float>;
+template class BasicCpuVector<double>;
+
 } // namespace math
 } // namespace cs
 
@@ -28,7 +28,17 @@ GpuMatrix::GpuMatrix(size_t m, size_t n, bool clear) :
 GpuMatrix::GpuMatrix(const CpuMatrix& other) :
 		GpuMatrix(other.m, other.n, false) {
 	float* src = other.ptr();
-	copy_cpu_to_gpu(src, devPtr, length);
+	copy_cpu_to_gpu(src, other.ld, devPtr, m, n);
+}
+
+GpuMatrix::GpuMatrix(const GpuMatrix& other) :
+		GpuMatrix(other.m, other.n, false) {
+	copy_gpu_to_gpu(other.devPtr, devPtr, length);
+}
+
+GpuMatrix::GpuMatrix(GpuMatrix&& other) :
+		Matrix(other.m, other.n), devPtr(other.devPtr) {
+	other.devPtr = nullptr;
 }
 
 GpuMatrix::GpuMatrix(const initializer_list<const initializer_list<float>> &list) :
@@ -114,7 +124,29 @@ GpuMatrix& GpuMatrix::operator=(const GpuMatrix& other) {
 	return *this;
 }
 
-const GpuMatrix GpuMatrix::operator+(const GpuMatrix& b) const {
+GpuMatrix& GpuMatrix::operator=(GpuMatrix&& other) {
+	
+	if (&other == this) {
+		return *this;
+	}
+	
+	//Same rules as the copy, but the memory is taken instead of copied.
+	if (devPtr == nullptr) {
+		const_cast<size_t&>(m) = other.m;
+		const_cast<size_t&>(n) = other.n;
+		const_cast<size_t&>(length) = other.length;
+	} else {
+		check_same_dimensions(other);
+		gpu_free(devPtr);
+	}
+	
+	devPtr = other.devPtr;
+	other.devPtr = nullptr;
+	
+	return *this;
+}
+
+GpuMatrix GpuMatrix::operator+(const GpuMatrix& b) const {
 	check_same_dimensions(b);
 	
 	GpuMatrix ans = GpuMatrix(m, n, false);
@@ -124,11 +156,11 @@ const GpuMatrix GpuMatrix::operator+(const GpuMatrix& b) const {
 	return ans;
 }
 
-const GpuMatrix GpuMatrix::operator-() const {
+GpuMatrix GpuMatrix::operator-() const {
 	return (*this) * -1;
 }
 
-const GpuMatrix GpuMatrix::operator-(const GpuMatrix& b) const {
+GpuMatrix GpuMatrix::operator-(const GpuMatrix& b) const {
 	check_same_dimensions(b);
 	
 	GpuMatrix ans = GpuMatrix(m, n, false);
@@ -139,7 +171,7 @@ const GpuMatrix GpuMatrix::operator-(const GpuMatrix& b) const {
 }
 
 
-const GpuMatrix GpuMatrix::operator*(const GpuMatrix& b) const {
+GpuMatrix GpuMatrix::operator*(const GpuMatrix& b) const {
 	check_same_dimensions(b);
 	GpuMatrix ans = GpuMatrix(m, n, false);
 	
@@ -148,7 +180,7 @@ const GpuMatrix GpuMatrix::operator*(const GpuMatrix& b) const {
 	return ans;
 }
 
-const GpuMatrix GpuMatrix::operator*(const float scalar) const {
+GpuMatrix GpuMatrix::operator*(const float scalar) const {
 	
 	GpuMatrix ans = GpuMatrix(m, n, false);
 	
@@ -157,7 +189,7 @@ const GpuMatrix GpuMatrix::operator*(const float scalar) const {
 	return ans;
 }
 
-const GpuMatrix GpuMatrix::operator/(const GpuMatrix& b) const {
+GpuMatrix GpuMatrix::operator/(const GpuMatrix& b) const {
 	check_same_dimensions(b);
 	GpuMatrix ans = GpuMatrix(m, n, false);
 	
@@ -166,7 +198,7 @@ const GpuMatrix GpuMatrix::operator/(const GpuMatrix& b) const {
 	return ans;
 }
 
-const GpuMatrix GpuMatrix::operator/(const float scalar) const {
+GpuMatrix GpuMatrix::operator/(const float scalar) const {
 	
 	GpuMatrix ans = GpuMatrix(m, n, false);
 	float div = 1.0 / scalar;
@@ -175,7 +207,7 @@ const GpuMatrix GpuMatrix::operator/(const float scalar) const {
 	return ans;
 }
 
-const GpuMatrix GpuMatrix::operator^(const float exp) const {
+GpuMatrix GpuMatrix::operator^(const float exp) const {
 	
 	GpuMatrix ans = GpuMatrix(m, n, false);
 	
@@ -213,7 +245,7 @@ void GpuMatrix::powi(const float exp) {
 }
 
 	
-const GpuMatrix GpuMatrix::dot(const GpuMatrix& b) const {
+GpuMatrix GpuMatrix::dot(const GpuMatrix& b) const {
 	assert_rows(b.m, n);
 	
 	const size_t p = b.n;
@@ -234,7 +266,7 @@ void GpuMatrix::dot(const GpuMatrix& b, GpuMatrix& ans)const {
 	gpu_dot(devPtr, b.devPtr, ans.devPtr, m, n, b.n);
 }
 
-const GpuVector GpuMatrix::dot(const GpuVector& b) const {
+GpuVector GpuMatrix::dot(const GpuVector& b) const {
 	
 	assert_rows(b.length, n);
 	
@@ -246,7 +278,7 @@ const GpuVector GpuMatrix::dot(const GpuVector& b) const {
 	return ans;
 }
 
-const GpuMatrix GpuMatrix::affine(const GpuMatrix& x, const GpuVector& b) const {
+GpuMatrix GpuMatrix::affine(const GpuMatrix& x, const GpuVector& b) const {
 	
 	size_t p = x.n;
 	assert_rows(b.length, p);
@@ -286,7 +318,7 @@ void GpuMatrix::copy(Matrix& dest)const{
 	copy_gpu_to_gpu(devPtr, dst, length);
 }
 
-const CpuMatrix GpuMatrix::cpu() const {
+CpuMatrix GpuMatrix::cpu() const {
 	
 	CpuMatrix ans = CpuMatrix(m, n, false);
 	
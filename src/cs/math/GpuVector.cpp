@@ -38,6 +38,11 @@ GpuVector::GpuVector(const GpuVector& other) :
 	gpu::copy_gpu_to_gpu(src, devPtr, length);
 }
 
+GpuVector::GpuVector(GpuVector&& other) :
+		Vector(other.length), devPtr(other.devPtr) {
+	other.devPtr = nullptr;
+}
+
 GpuVector::GpuVector(const initializer_list<float> &list) :
 		GpuVector(list.size(), false) {
 	
@@ -83,6 +88,26 @@ GpuVector& GpuVector::operator=(const GpuVector& other) {
 	return *this;
 }
 
+GpuVector& GpuVector::operator=(GpuVector&& other) {
+	
+	if (&other == this) {
+		return *this;
+	}
+	
+	//Same rules as the copy, but the memory is taken instead of copied.
+	if (devPtr == nullptr) {
+		const_cast<size_t&>(length) = other.length;
+	} else {
+		check_same_length(other);
+		gpu_free(devPtr);
+	}
+	
+	devPtr = other.devPtr;
+	other.devPtr = nullptr;
+	
+	return *this;
+}
+
 void GpuVector::check_same_length(const GpuVector& b) const {
 	if (b.length != length) {
 		throw Exception(
@@ -91,7 +116,7 @@ void GpuVector::check_same_length(const GpuVector& b) const {
 	}
 }
 
-const GpuVector GpuVector::operator+(const GpuVector& b) const {
+GpuVector GpuVector::operator+(const GpuVector& b) const {
 	check_same_length(b);
 	
 	GpuVector ans = GpuVector(length, false);
@@ -101,7 +126,7 @@ const GpuVector GpuVector::operator+(const GpuVector& b) const {
 	return ans;
 }
 
-const GpuVector GpuVector::operator-(const GpuVector& b) const {
+GpuVector GpuVector::operator-(const GpuVector& b) const {
 	check_same_length(b);
 	
 	GpuVector ans = GpuVector(length, false);
@@ -111,11 +136,11 @@ const GpuVector GpuVector::operator-(const GpuVector& b) const {
 	return ans;
 }
 
-const GpuVector GpuVector::operator-() const {
+GpuVector GpuVector::operator-() const {
 	return (*this) * -1;
 }
 
-const GpuVector GpuVector::operator*(const GpuVector& b) const {
+GpuVector GpuVector::operator*(const GpuVector& b) const {
 	check_same_length(b);
 	GpuVector ans = GpuVector(length, false);
 	
@@ -124,7 +149,7 @@ const GpuVector GpuVector::operator*(const GpuVector& b) const {
 	return ans;
 }
 
-const GpuVector GpuVector::operator*(const float scalar) const {
+GpuVector GpuVector::operator*(const float scalar) const {
 	
 	GpuVector ans = GpuVector(length, false);
 	
@@ -133,7 +158,7 @@ const GpuVector GpuVector::operator*(const float scalar) const {
 	return ans;
 }
 
-const GpuVector GpuVector::operator/(const GpuVector& b) const {
+GpuVector GpuVector::operator/(const GpuVector& b) const {
 	check_same_length(b);
 	GpuVector ans = GpuVector(length, false);
 	
@@ -142,7 +167,7 @@ const GpuVector GpuVector::operator/(const GpuVector& b) const {
 	return ans;
 }
 
-const GpuVector GpuVector::operator/(const float scalar) const {
+GpuVector GpuVector::operator/(const float scalar) const {
 	
 	GpuVector ans = GpuVector(length, false);
 	float div = 1.0 / scalar;
@@ -151,7 +176,7 @@ const GpuVector GpuVector::operator/(const float scalar) const {
 	return ans;
 }
 
-const GpuVector GpuVector::operator^(const float exp) const {
+GpuVector GpuVector::operator^(const float exp) const {
 	
 	GpuVector ans = GpuVector(length, false);
 	
@@ -210,7 +235,7 @@ void GpuVector::copy(GpuVector& dest) const {
 	copy_gpu_to_gpu(devPtr, dest.devPtr, length);
 }
 
-const CpuVector GpuVector::cpu() const {
+CpuVector GpuVector::cpu() const {
 	
 	CpuVector ans = CpuVector(length, false);
 	
@@ -12,12 +12,12 @@ namespace cs {
 using namespace core;
 namespace math {
 
-Matrix::Matrix(size_t m, size_t n) :
+MatrixShape::MatrixShape(size_t m, size_t n) :
 		m(m), n(n), length(m * n) {
 	check_dimensions();
 }
 
-void Matrix::check_dimensions() const {
+void MatrixShape::check_dimensions() const {
 	if (m < 1 || n < 1) {
 		throw Exception("Invalid dimensions " + to_string(m) + "x" + to_string(n) + ".");
 	}
@@ -27,7 +27,7 @@ void Matrix::check_dimensions() const {
 	}
 }
 
-void Matrix::check_index(size_t idx) const {
+void MatrixShape::check_index(size_t idx) const {
 	if (idx < 0 || idx >= length) {
 		throw Exception(
 				"The absolute index is out of bounds. Allowed ranges [0, " + to_string(length - 1) + "], but got: "
@@ -35,7 +35,7 @@ void Matrix::check_index(size_t idx) const {
 	}
 }
 
-void Matrix::check_index(size_t row, size_t col) const {
+void MatrixShape::check_index(size_t row, size_t col) const {
 	if (row < 0 || row >= m) {
 		throw Exception(
 				"The row index is out of bounds. Allowed ranges [0, " + to_string(m - 1) + "], but got: "
@@ -49,7 +49,7 @@ void Matrix::check_index(size_t row, size_t col) const {
 	}
 }
 
-void Matrix::assert_rows(size_t val, size_t expected) const {
+void MatrixShape::assert_rows(size_t val, size_t expected) const {
 	if (val != expected) {
 		throw Exception(
 				"The rows must be the same. Expected " + to_string(expected) + ", but got: " + to_string(val)
@@ -57,7 +57,7 @@ void Matrix::assert_rows(size_t val, size_t expected) const {
 	}
 }
 
-void Matrix::assert_cols(size_t val, size_t expected) const {
+void MatrixShape::assert_cols(size_t val, size_t expected) const {
 	if (val != expected) {
 		throw Exception(
 				"The columns must be the same. Expected " + to_string(expected) + ", but got: " + to_string(val)
@@ -65,11 +65,15 @@ void Matrix::assert_cols(size_t val, size_t expected) const {
 	}
 }
 
-void Matrix::check_same_dimensions(const Matrix& other) const {
+void MatrixShape::check_same_dimensions(const MatrixShape& other) const {
 	assert_rows(other.m, m);
 	assert_cols(other.n, n);
 }
 
+Matrix::Matrix(size_t m, size_t n) :
+		MatrixShape(m, n) {
+}
+
 Matrix::~Matrix() {
 	
 }
@@ -5,15 +5,42 @@
  *      Author: Yaison Alcantara
  */
 
+#include <cs/core/Exception.h>
 #include "cs/math/RowView.h"
+#include <string>
 
 namespace cs {
+using namespace core;
 namespace math {
 
 template<typename T>
-RowView<T>::RowView() {
-	// TODO Auto-generated constructor stub
-	
+RowView<T>::RowView(T* arr, size_t length) :
+		arr(arr), length(length) {
+}
+
+template<typename T>
+const T& RowView<T>::operator[](size_t idx) const {
+	if (idx >= length) {
+		throw Exception(
+				"The index is out of bounds. Allowed ranges [0, " + to_string(length - 1) + "], but got: "
+						+ to_string(idx) + " instead.");
+	}
+	return arr[idx];
+}
+
+template<typename T>
+T& RowView<T>::operator[](size_t idx) {
+	if (idx >= length) {
+		throw Exception(
+				"The index is out of bounds. Allowed ranges [0, " + to_string(length - 1) + "], but got: "
+						+ to_string(idx) + " instead.");
+	}
+	return arr[idx];
+}
+
+template<typename T>
+T* RowView<T>::ptr() const {
+	return arr;
 }
 
 template<typename T>
@@ -21,5 +48,9 @@ RowView<T>::~RowView() {
 
 }
 
+//the element types of the matrices
+template class RowView<float>;
+template class RowView<double>;
+
 } // namespace math
 } // namespace cs
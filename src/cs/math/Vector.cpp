@@ -13,14 +13,14 @@ using namespace core;
 namespace math {
 
 
-void Vector::check_index(size_t idx) const {
+void VectorShape::check_index(size_t idx) const {
 	if (idx >= length) {
 		throw Exception(
 				"Index out of bounds. Expected < " + to_string(length) + ", but got: " + to_string(idx) + " instead.");
 	}
 }
 
-void Vector::check_same_length(const Vector& other) const {
+void VectorShape::check_same_length(const VectorShape& other) const {
 	if (other.length != length) {
 		throw Exception(
 				"The length must be the same. Expected " + to_string(length) + ", but got: " + to_string(other.length)
@@ -29,7 +29,11 @@ void Vector::check_same_length(const Vector& other) const {
 }
 
 
-Vector::Vector(size_t length):length(length) {
+VectorShape::VectorShape(size_t length):length(length) {
+	
+}
+
+Vector::Vector(size_t length):VectorShape(length) {
 	
 }
 
@@ -0,0 +1,113 @@
+/*
+ * Workspace.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/cpu/cpu.h>
+#include <cs/cpu/cpu_utils.h>
+#include <cs/math/Workspace.h>
+#include <algorithm>
+#include <new>
+
+namespace cs {
+using namespace core;
+using namespace cpu;
+namespace math {
+
+//floats of a CPU_ALIGNMENT boundary
+static const size_t ALIGN_FLOATS = CPU_ALIGNMENT / sizeof(float);
+
+//the first block when none is given, 1 MB
+static const size_t FIRST_BLOCK = (1 << 20) / sizeof(float);
+
+static size_t aligned(size_t length) {
+	return (length + ALIGN_FLOATS - 1) / ALIGN_FLOATS * ALIGN_FLOATS;
+}
+
+Workspace::Workspace() {
+}
+
+Workspace::Workspace(size_t capacity) {
+	add_block(aligned(capacity));
+}
+
+void Workspace::add_block(size_t capacity) {
+	//the category of the caller, like the grads of Layer::init_dx, the activations otherwise
+	CpuMemoryScope scope(memory_scoped() ? memory_category() : CPU_MEMORY_ACTIVATIONS);
+	Block block = { cpu_malloc(capacity, false), capacity };
+	blocks.push_back(block);
+	used = 0;
+}
+
+float* Workspace::take(size_t length) {
+	
+	if (length < 1) {
+		throw Exception("Invalid length " + to_string(length) + ".");
+	}
+	
+	length = aligned(length);
+	
+	if (blocks.empty() || used + length > blocks.back().capacity) {
+		//at least twice the current one, so a growing step adds few blocks
+		size_t capacity = blocks.empty() ? FIRST_BLOCK : 2 * blocks.back().capacity;
+		add_block(std::max(capacity, length));
+	}
+	
+	float* ans = blocks.back().arr + used;
+	used += length;
+	taken += length;
+	peak = std::max(peak, taken);
+	return ans;
+}
+
+MatrixView& Workspace::matrix(size_t m, size_t n) {
+	
+	if (m < 1 || n < 1) {
+		throw Exception("Invalid workspace matrix " + to_string(m) + "x" + to_string(n) + ".");
+	}
+	
+	float* arr = take(m * n);
+	
+	//the view does not own its memory, its destructor does nothing and is never called
+	void* view = take((sizeof(MatrixView) + sizeof(float) - 1) / sizeof(float));
+	return *new (view) MatrixView(arr, m, n, n);
+}
+
+void Workspace::reset() {
+	
+	//the blocks of a step that did not fit become one with room for the largest step
+	if (blocks.size() > 1) {
+		for (size_t i = 0; i < blocks.size(); i++) {
+			cpu_free(blocks[i].arr);
+		}
+		blocks.clear();
+		add_block(peak);
+	}
+	
+	used = 0;
+	taken = 0;
+}
+
+size_t Workspace::capacity() const {
+	size_t ans = 0;
+	for (size_t i = 0; i < blocks.size(); i++) {
+		ans += blocks[i].capacity;
+	}
+	return ans;
+}
+
+size_t Workspace::high_water() const {
+	return peak;
+}
+
+Workspace::~Workspace() {
+	for (size_t i = 0; i < blocks.size(); i++) {
+		cpu_free(blocks[i].arr);
+	}
+}
+
+} // namespace math
+} // namespace cs
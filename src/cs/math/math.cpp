@@ -156,13 +156,13 @@ float sum(const Matrix& m) {
 	return m.sum();
 }
 
-const CpuMatrix randn(size_t m, size_t n) {
+CpuMatrix randn(size_t m, size_t n) {
 	CpuMatrix ans = CpuMatrix(m, n, false);
 	ans.randn();
 	return ans;
 }
 
-const CpuVector randn(size_t length) {
+CpuVector randn(size_t length) {
 	CpuVector ans = CpuVector(length, false);
 	
 	float* arr = ans.ptr();
@@ -178,6 +178,13 @@ void randn(float* arr, size_t length) {
 	}
 }
 
+void randn(double* arr, size_t length) {
+	
+	for (size_t i = 0; i < length; i++) {
+		arr[i] = grandn(0, 1.0);
+	}
+}
+
 double grandn(double mu, double sigma) {
 	
 	double ans;
@@ -211,19 +218,11 @@ double grandn(double mu, double sigma) {
 	return ans;
 }
 
-const CpuVector operator*(float scalar, const CpuVector& a) {
-	return a * scalar;
-}
-
-const CpuMatrix operator*(float scalar, const CpuMatrix& a) {
-	return a * scalar;
-}
-
-const GpuVector operator*(float scalar, const GpuVector& a) {
+GpuVector operator*(float scalar, const GpuVector& a) {
 	return a * scalar;
 }
 
-const GpuMatrix operator*(float scalar, const GpuMatrix& a) {
+GpuMatrix operator*(float scalar, const GpuMatrix& a) {
 	return a * scalar;
 }
 
@@ -12,10 +12,12 @@
 #include <cs/nn/Affine.h>
 #include <stddef.h>
 
+#include <cs/nn/cpu_layers.h>
 #include <cs/nn/gpu_layers.cuh>
 
 namespace cs {
 using namespace core;
+using namespace cpu;
 using namespace math;
 namespace nn {
 
@@ -55,9 +57,11 @@ void Affine::init() {
 		dw = new GpuMatrix(in, out);
 		db = new GpuVector(out);
 	} else {
+		CpuMemoryScope params(CPU_MEMORY_PARAMS);
 		w = new CpuMatrix(in, out);
 		b = new CpuVector(out);
 		
+		CpuMemoryScope grads(CPU_MEMORY_GRADS);
 		dw = new CpuMatrix(in, out);
 		db = new CpuVector(out);
 	}
@@ -76,6 +80,16 @@ void Affine::set_bias(const Vector& bias) {
 	bias.copy(*b);
 }
 
+const Matrix& Affine::get_weights() const {
+	check_null(w);
+	return *w;
+}
+
+const Vector& Affine::get_bias() const {
+	check_null(b);
+	return *b;
+}
+
 Matrix& Affine::foward(const Matrix& x) {
 	init_fx(x.m);
 	this->x = const_cast<Matrix*>(&x);
@@ -85,6 +99,28 @@ Matrix& Affine::foward(const Matrix& x) {
 	return *fx;
 }
 
+Matrix& Affine::foward(const Matrix& x, Sigmoid& activation) {
+	
+	const CpuMatrix* cx = dynamic_cast<const CpuMatrix*>(&x);
+	if (gpu || cx == nullptr) {
+		return activation.foward(foward(x));
+	}
+	
+	this->x = const_cast<Matrix*>(&x);
+	
+	//the product goes straight to the fx of the activation, this layer keeps no fx of its
+	//own (one taken from the workspace would be m x out floats never written)
+	if (workspace == nullptr) {
+		delete this->fx;
+	}
+	this->fx = nullptr;
+	
+	CpuMatrix& fx = cpu_cast(activation.fused_foward(x.m));
+	cx->affine(cpu_cast(w), cpu_cast(b), CPU_SIGMOID, fx);
+	
+	return fx;
+}
+
 Matrix& Affine::backward(const Matrix& dg) {
 	init_dx(x->m, x->n);
 	
@@ -112,45 +148,28 @@ void Affine::gpu_backward(const GpuMatrix& dg) {
 
 void Affine::cpu_backward(const CpuMatrix& dg) {
 	
-	CpuMatrix& x = cpu_cast(this->x);
 	CpuMatrix& w = cpu_cast(this->w);
 	
 	CpuMatrix& dx = cpu_cast(this->dx);
 	CpuMatrix& dw = cpu_cast(this->dw);
 	CpuVector& db = cpu_cast(this->db);
 	
-	dx.clear();
-	dw.clear();
-	db.clear();
-	
-	size_t m = x.m;
-	size_t n = x.n;
-	size_t p = w.n;
-	
-	float* X = x.ptr();
-	float* W = w.ptr();
-	
-	float* DG = dg.ptr();
-	float* DX = dx.ptr();
-	float* DW = dw.ptr();
-	float* DB = db.ptr();
-	
-	
-	for (int i = 0; i < m; i++) {
-		for (int k = 0; k < p; k++) {
-			
-			float fdg = DG[i * p + k];
-			for (int j = 0; j < n; j++) {
-				float dfw = fdg * W[j * p + k];
-				float dfx = fdg * X[i * n + j];
-				
-				DX[i * n + j] += dfw;
-				DW[j * p + k] += dfx;
-			}
-			
-			DB[k] += fdg;
-		}
+	//a sparse input, usually the first layer over one hot columns
+	const CpuSparseMatrix* sparse = dynamic_cast<const CpuSparseMatrix*>(this->x);
+	if (sparse) {
+		affine_dx(*sparse, w, dg, dx, dw, db);
+		return;
+	}
+	
+	//a 16 bit input
+	const CpuHalfMatrix* half = dynamic_cast<const CpuHalfMatrix*>(this->x);
+	if (half) {
+		affine_dx(*half, w, dg, dx, dw, db);
+		return;
 	}
+	
+	CpuMatrix& x = cpu_cast(this->x);
+	affine_dx(x, w, dg, dx, dw, db);
 }
 
 void Affine::update(float alpha) {
@@ -186,26 +205,14 @@ void Affine::cpu_update(float alpha) {
 	CpuMatrix& dw = cpu_cast(this->dw);
 	CpuVector& db = cpu_cast(this->db);
 	
-	float* W = w.ptr();
-	float* B = b.ptr();
-	
-	float* DW = dw.ptr();
-	float* DB = db.ptr();
-	
 	size_t m = x->n;
-	size_t length = in * out;
 	
 	//for efficiency, instead of using Wj := Wj - (alpha/m)*DWj
 	//we pre-compute (alpha/m) which is just a constant.
-	
 	float scalar = -alpha / m;
-	for (int j = 0; j < length; j++) {
-		W[j] += scalar * DW[j];
-	}
 	
-	for (int j = 0; j < out; j++) {
-		B[j] += scalar * DB[j];
-	}
+	update_params(w, dw, scalar);
+	update_params(b, db, scalar);
 }
 
 void Affine::print() const {
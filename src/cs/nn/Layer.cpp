@@ -9,6 +9,7 @@
 #include <cs/core/lang.h>
 #include <cs/math/CpuMatrix.h>
 #include <cs/math/GpuMatrix.h>
+#include <cs/math/Workspace.h>
 #include <cs/nn/Layer.h>
 #include <stddef.h>
 
@@ -24,6 +25,18 @@ void Layer::use_gpu(bool val) {
 	gpu = val;
 }
 
+void Layer::use_workspace(Workspace* ws) {
+	
+	if (workspace == nullptr) {
+		delete fx;
+		delete dx;
+	}
+	
+	fx = nullptr;
+	dx = nullptr;
+	workspace = ws;
+}
+
 void Layer::set_dim(size_t input, size_t output) {
 	if (input <= 0) {
 		throw Exception("Invalid input: " + to_string(input));
@@ -72,6 +85,14 @@ void Layer::init_fx(size_t m) {
 		throw Exception("Invalid param m: " + to_string(m));
 	}
 	
+	cpu::CpuMemoryScope activations(cpu::CPU_MEMORY_ACTIVATIONS);
+	
+	//the previous step memory was reset, always a new one
+	if (workspace) {
+		fx = &workspace->matrix(m, out);
+		return;
+	}
+	
 	//If we already have created a fx then, we have to check if the dimensions 
 	//are right for the incoming x. If it passes that test, then no need to create 
 	//another one. If the dimensions does not match, we have to delete the 
@@ -106,6 +127,13 @@ void Layer::init_dx(size_t m, size_t n) {
 		throw Exception("Invalid param n: " + to_string(n));
 	}
 	
+	cpu::CpuMemoryScope grads(cpu::CPU_MEMORY_GRADS);
+	
+	if (workspace) {
+		dx = &workspace->matrix(m, n);
+		return;
+	}
+	
 	//If we already have created a dx then, we have to check if the dimensions 
 	//are right for the incoming x. If it passes that test, then no need to create 
 	//another one. If the dimensions does not match, we have to delete the 
@@ -127,6 +155,11 @@ void Layer::init_dx(size_t m, size_t n) {
 }
 
 Layer::~Layer() {
+	if (workspace) {
+		//the matrices belong to the workspace
+		return;
+	}
+	
 	if (fx) {
 		delete fx;
 	}
@@ -10,6 +10,7 @@
 #include <cs/core/Exception.h>
 #include <cs/math/math.h>
 #include <cs/nn/errors.h>
+#include <cs/nn/QAffine.h>
 
 namespace cs {
 using namespace core;
@@ -17,8 +18,7 @@ using namespace math;
 namespace nn {
 
 Network::Network() {
-	// TODO Auto-generated constructor stub
-	
+	workspace = new Workspace();
 }
 
 void Network::operator<<(Affine layer) {
@@ -41,6 +41,10 @@ float Network::get_alpha() const {
 	return this->alpha;
 }
 
+void Network::set_fused(bool fused) {
+	this->fused = fused;
+}
+
 void Network::init(Matrix& x, Matrix& y, bool gpu) {
 	
 	size_t L = layers.size();
@@ -61,6 +65,21 @@ void Network::init(Matrix& x, Matrix& y, bool gpu) {
 	this->x = &x;
 	this->y = &y;
 	this->gpu = gpu;
+	stale = true;
+	
+	if (dg) {
+		delete dg;
+		dg = nullptr;
+	}
+	
+	if (gpu) {
+		dg = new GpuMatrix(y.m, y.n, false);
+	}
+	
+	workspace->reset();
+	for (size_t l = 0; l < L; l++) {
+		layers[l]->use_workspace(gpu ? nullptr : workspace);
+	}
 	
 	if (L == 1) {
 		Layer& single = *layers[0];
@@ -87,6 +106,40 @@ void Network::init(Matrix& x, Matrix& y, bool gpu) {
 	last.init();
 }
 
+void Network::set_batch(Matrix& x, Matrix& y) {
+	
+	if (this->x == nullptr) {
+		throw Exception("Call init() before changing the batch of the network.");
+	}
+	
+	if (x.n != this->x->n || y.n != this->y->n) {
+		throw Exception(
+				"The batch has " + to_string(x.n) + " and " + to_string(y.n) + " columns, expected "
+						+ to_string(this->x->n) + " and " + to_string(this->y->n) + ".");
+	}
+	
+	if (x.m != y.m) {
+		throw Exception("The batch has " + to_string(x.m) + " inputs and " + to_string(y.m) + " outputs.");
+	}
+	
+	if (is_gpu(x) != gpu || is_gpu(y) != gpu) {
+		throw Exception("The batch must be on the " + string(gpu ? "GPU" : "CPU") + ", like the network.");
+	}
+	
+	this->x = &x;
+	this->y = &y;
+	stale = true;
+	
+	if (gpu && dg->m != y.m) {
+		delete dg;
+		dg = new GpuMatrix(y.m, y.n, false);
+	}
+}
+
+const Workspace& Network::get_workspace() const {
+	return *workspace;
+}
+
 Matrix& Network::forward() {
 	
 	size_t L = layers.size();
@@ -95,18 +148,32 @@ Matrix& Network::forward() {
 		throw Exception("No layers in this network.");
 	}
 	
+	//the matrices of the previous step are not used anymore
+	if (gpu == false) {
+		workspace->reset();
+	}
+	
 	Matrix* out = x;
 	
 	for (size_t l = 0; l < L; l++) {
 		Layer& crt = *layers[l];
 		
+		Affine* affine = dynamic_cast<Affine*>(&crt);
+		Sigmoid* sigmoid = l + 1 < L ? dynamic_cast<Sigmoid*>(layers[l + 1]) : nullptr;
+		if (fused && affine && sigmoid) {
+			out = &affine->foward(*out, *sigmoid);
+			l++;
+			continue;
+		}
+		
 		out = &crt.foward(*out);
 	}
 	
+	stale = false;
 	return *out;
 }
 
-const CpuMatrix Network::cpu_last_grad() const {
+CpuMatrix& Network::cpu_last_grad() {
 	
 	size_t L = layers.size();
 	
@@ -116,12 +183,13 @@ const CpuMatrix Network::cpu_last_grad() const {
 	
 	CpuMatrix& y = cpu_cast(this->y);
 	
-	CpuMatrix dg = h - y;
+	CpuMatrix& dg = workspace->matrix(y.m, y.n);
+	sub(h, y, dg);
 	
 	return dg;
 }
 
-const GpuMatrix Network::gpu_last_grad() const {
+GpuMatrix& Network::gpu_last_grad() {
 	
 	size_t L = layers.size();
 	
@@ -131,7 +199,9 @@ const GpuMatrix Network::gpu_last_grad() const {
 	
 	GpuMatrix& y = gpu_cast(this->y);
 	
-	GpuMatrix dg = h - y;
+	GpuMatrix& dg = gpu_cast(this->dg);
+	dg = h;
+	dg.subi(y);
 	
 	return dg;
 }
@@ -145,11 +215,11 @@ void Network::backward() {
 	
 	if (gpu) {
 		
-		GpuMatrix dg = gpu_last_grad();
+		GpuMatrix& dg = gpu_last_grad();
 		
 		o = &last->backward(dg);
 	} else {
-		CpuMatrix dg = cpu_last_grad();
+		CpuMatrix& dg = cpu_last_grad();
 		
 		o = &last->backward(dg);
 	}
@@ -186,7 +256,8 @@ float Network::min_square_error() {
 	
 	size_t L = layers.size();
 	Layer& last = *layers[L - 1];
-	if (last.has_fx() == false) {
+	//a new batch (see set_batch) has not been through the network yet
+	if (stale || last.has_fx() == false) {
 		forward();
 	}
 	
@@ -194,7 +265,33 @@ float Network::min_square_error() {
 	return cs::nn::min_square_error(h, *y);
 }
 
+void Network::quantize() {
+	
+	if (gpu) {
+		throw Exception("The quantized layers run on the CPU, this network uses the GPU.");
+	}
+	
+	size_t L = layers.size();
+	for (size_t l = 0; l < L; l++) {
+		Affine* affine = dynamic_cast<Affine*>(layers[l]);
+		if (affine) {
+			layers[l] = new QAffine(*affine);
+			layers[l]->use_workspace(workspace);
+			delete affine;
+		}
+	}
+	
+	//the fx of the layers come from the fp32 weights
+	stale = true;
+}
+
 Network::~Network() {
+	if (dg) {
+		delete dg;
+	}
+	
+	delete workspace;
+	
 	layers.clear();
 }
 
@@ -0,0 +1,99 @@
+/*
+ * QAffine.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/core/Exception.h>
+#include <cs/core/lang.h>
+#include <cs/math/math.h>
+#include <cs/nn/QAffine.h>
+#include <stddef.h>
+#include <cstdio>
+
+namespace cs {
+using namespace core;
+using namespace cpu;
+using namespace math;
+namespace nn {
+
+QAffine::QAffine(const CpuMatrix& weights, const CpuVector& bias) :
+		Layer() {
+	
+	set_dim(weights.m, weights.n);
+	if (bias.length != out) {
+		throw Exception("The bias has " + to_string(bias.length) + " values, expected " + to_string(out) + ".");
+	}
+	
+	w.resize(cpu_qpack_size(in, out));
+	scales.resize(out);
+	sums.resize(out);
+	cpu_qpack(weights.ptr(), weights.ld, in, out, w.data(), scales.data(), sums.data());
+	
+	b.assign(bias.ptr(), bias.ptr() + out);
+}
+
+QAffine::QAffine(const Affine& layer) :
+		QAffine(cpu_cast(layer.get_weights()), cpu_cast(layer.get_bias())) {
+}
+
+void QAffine::init() {
+	//the weights come from the constructor
+}
+
+Matrix& QAffine::foward(const Matrix& x) {
+	
+	const CpuMatrix& cx = cpu_cast(x);
+	if (cx.n != in) {
+		throw Exception("The input has " + to_string(cx.n) + " columns, expected " + to_string(in) + ".");
+	}
+	
+	init_fx(cx.m);
+	CpuMatrix& fx = cpu_cast(this->fx);
+	
+	//the kernels read the rows in groups of 4 bytes, the last one up to 3 bytes past its end
+	qx.resize(cx.m * in + 3);
+	
+	CpuQuant q = cpu_quantize(cx.ptr(), cx.ld, qx.data(), in, cx.m, in);
+	cpu_qaffine(qx.data(), in, q, w.data(), scales.data(), sums.data(), b.data(), fx.ptr(), fx.ld, cx.m, in, out);
+	
+	return fx;
+}
+
+Matrix& QAffine::backward(const Matrix&) {
+	throw Exception("QAffine is only for inference, train the Affine layer before quantizing it.");
+}
+
+void QAffine::update(float) {
+	throw Exception("QAffine is only for inference, train the Affine layer before quantizing it.");
+}
+
+void QAffine::print() const {
+	
+	println();
+	println("QAffine");
+	println("------------------------------------------------------------------");
+	println("In : " + to_string(in));
+	println("Out: " + to_string(out));
+	println();
+	println("Scales:");
+	for (size_t j = 0; j < out; j++) {
+		printf("%12.6f", scales[j]);
+	}
+	println();
+	println("Bias:");
+	for (size_t j = 0; j < out; j++) {
+		printf("%12.4f", b[j]);
+	}
+	println();
+	println("------------------------------------------------------------------");
+	println();
+}
+
+QAffine::~QAffine() {
+	//the vectors release themselves
+}
+
+} // namespace nn
+} // namespace cs
@@ -9,6 +9,7 @@
 #include <cs/nn/Layer.h>
 #include <cs/nn/Sigmoid.h>
 #include <cs/math/math.h>
+#include <cs/nn/cpu_layers.h>
 #include <cs/nn/gpu_layers.cuh>
 #include <stdlib.h>
 #include <math.h>
@@ -50,6 +51,14 @@ Matrix& Sigmoid::foward(const Matrix& x) {
 	return *fx;
 }
 
+Matrix& Sigmoid::fused_foward(size_t m) {
+	init_fx(m);
+	
+	//the backward only reads the dimensions of x, which are the ones of fx
+	this->x = fx;
+	return *fx;
+}
+
 Matrix& Sigmoid::backward(const Matrix& dg) {
 	init_dx(x->m, x->n);
 	
@@ -81,48 +90,16 @@ void Sigmoid::gpu_backward(const GpuMatrix& dg){
 }
 
 void Sigmoid::cpu_foward(const CpuMatrix& x, const CpuMatrix& fx) {
-	
-	size_t m = x.m;
-	size_t n = x.n;
-	
-	float* X = x.ptr();
-	float* FX = fx.ptr();
-	
-	for (size_t i = 0; i < m; i++) {
-		for (size_t j = 0; j < n; j++) {
-			float z = X[i * n + j];
-			FX[i * n + j] = cpu_sigmoid_fx(z);
-		}
-	}
+	sigmoid_fx(x, fx);
 }
 
-
 void Sigmoid::cpu_backward(const CpuMatrix& dg) {
 	
-	const CpuMatrix& x = cpu_cast(this->x);
+	//the derivative is fx * (1 - fx), so the output of the foward is reused
+	const CpuMatrix& fx = cpu_cast(this->fx);
 	const CpuMatrix& dx = cpu_cast(this->dx);
 	
-	size_t m = x.m;
-	size_t n = x.n;
-	
-	float* X = x.ptr();
-	float* DX = dx.ptr();
-	float* DG = dg.ptr();
-	
-	for (size_t i = 0; i < m; i++) {
-		for (size_t j = 0; j < n; j++) {
-			float z = X[i * n + j];
-			DX[i * n + j] = cpu_sigmoid_dx(z) * DG[i * n + j];
-		}
-	}
-}
-
-float Sigmoid::cpu_sigmoid_fx(float z) {
-	return 1.0f / (1.0f + expf(-z));
-}
-
-float Sigmoid::cpu_sigmoid_dx(float z) {
-	return cpu_sigmoid_fx(z) * (1 - cpu_sigmoid_fx(z));
+	sigmoid_dx(fx, dg, dx);
 }
 
 void Sigmoid::print() const {
@@ -0,0 +1,126 @@
+/*
+ * cpu_layers.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Yaison Alcantara
+ */
+
+#include <cs/cpu/cpu.h>
+#include <cs/nn/cpu_layers.h>
+
+namespace cs {
+using namespace cpu;
+namespace nn {
+
+void affine_dx(const CpuMatrix& x, const CpuMatrix& w, const CpuMatrix& dg, CpuMatrix& dx, CpuMatrix& dw,
+		CpuVector& db) {
+	
+	size_t m = x.m;
+	size_t n = x.n;
+	size_t o = w.m;
+	size_t p = w.n;
+	
+	float* X = x.ptr();
+	float* W = w.ptr();
+	float* DG = dg.ptr();
+	float* DX = dx.ptr();
+	float* DW = dw.ptr();
+	float* DB = db.ptr();
+	
+	//the products overwrite their outputs, nothing needs to be cleared.
+	//DW = X^T x DG, X^T is (n x m)
+	cpu_gemm(X, x.ld, true, DG, dg.ld, false, DW, dw.ld, n, m, p, 0.0f);
+	
+	//DX = DG x W^T, W^T is (p x o)
+	cpu_gemm(DG, dg.ld, false, W, w.ld, true, DX, dx.ld, m, p, o, 0.0f);
+	
+	cpu_sum_rows(DG, dg.ld, DB, m, p);
+}
+
+void affine_dx(const CpuSparseMatrix& x, const CpuMatrix& w, const CpuMatrix& dg, CpuMatrix& dx, CpuMatrix& dw,
+		CpuVector& db) {
+	
+	size_t m = x.m;
+	size_t o = w.m;
+	size_t p = w.n;
+	
+	float* W = w.ptr();
+	float* DG = dg.ptr();
+	float* DX = dx.ptr();
+	float* DB = db.ptr();
+	
+	//DW = X^T x DG over the transpose of X, built once and kept by x
+	x.dot(true, dg, dw);
+	
+	//DX = DG x W^T, W^T is (p x o)
+	cpu_gemm(DG, dg.ld, false, W, w.ld, true, DX, dx.ld, m, p, o, 0.0f);
+	
+	cpu_sum_rows(DG, dg.ld, DB, m, p);
+}
+
+void affine_dx(const CpuHalfMatrix& x, const CpuMatrix& w, const CpuMatrix& dg, CpuMatrix& dx, CpuMatrix& dw,
+		CpuVector& db) {
+	
+	size_t m = x.m;
+	size_t n = x.n;
+	size_t o = w.m;
+	size_t p = w.n;
+	
+	float* W = w.ptr();
+	float* DG = dg.ptr();
+	float* DX = dx.ptr();
+	float* DW = dw.ptr();
+	float* DB = db.ptr();
+	
+	//DW = X^T x DG, X^T is (n x m)
+	cpu_gemm_half(x.type, x.ptr(), x.ld, true, DG, dg.ld, false, DW, dw.ld, n, m, p, 0.0f);
+	
+	//DX = DG x W^T, W^T is (p x o)
+	cpu_gemm(DG, dg.ld, false, W, w.ld, true, DX, dx.ld, m, p, o, 0.0f);
+	
+	cpu_sum_rows(DG, dg.ld, DB, m, p);
+}
+
+void update_params(const CpuMatrix& w, const CpuMatrix& dw, float scalar) {
+	
+	float* W = w.ptr();
+	float* DW = dw.ptr();
+	
+	if (w.contiguous() && dw.contiguous()) {
+		cpu_add_inplace(W, DW, scalar, w.length);
+		return;
+	}
+	
+	for (size_t i = 0; i < w.m; i++) {
+		cpu_add_inplace(W + i * w.ld, DW + i * dw.ld, scalar, w.n);
+	}
+}
+
+void update_params(const CpuVector& b, const CpuVector& db, float scalar) {
+	
+	size_t length = b.length;
+	float* B = b.ptr();
+	float* DB = db.ptr();
+	
+	cpu_add_inplace(B, DB, scalar, length);
+}
+
+void sigmoid_fx(const CpuMatrix& x, const CpuMatrix& fx) {
+	
+	float* X = x.ptr();
+	float* FX = fx.ptr();
+	
+	cpu_sigmoid_fx(X, x.ld, FX, fx.ld, x.m, x.n);
+}
+
+void sigmoid_dx(const CpuMatrix& fx, const CpuMatrix& dg, const CpuMatrix& dx) {
+	
+	float* FX = fx.ptr();
+	float* DG = dg.ptr();
+	float* DX = dx.ptr();
+	
+	cpu_sigmoid_dx(FX, fx.ld, DG, dg.ld, DX, dx.ld, fx.m, fx.n);
+}
+
+} // namespace nn
+} // namespace cs
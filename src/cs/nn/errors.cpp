@@ -26,18 +26,9 @@ float min_square_error(const Matrix& h, const Matrix& y) {
 
 float min_square_error(const CpuMatrix& h, const CpuMatrix& y) {
 	
-	float ans = 0.0f;
-	
 	size_t m = y.m;
-	size_t n = y.n;
-	
-	for(size_t i =0; i < m; i++){
-		for(size_t j =0; j < n; j++){
-			ans += pow(h.get(i, j) - y.get(i, j), 2);
-		}
-	}
 	
-	ans = ans / (2 * m);
+	float ans = 1.0 / (2 * m) * sum((h - y) ^ 2);
 	
 	return ans;
 }